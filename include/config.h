@@ -18,9 +18,16 @@
 #define CONFIG_H
 
 // Include necessary headers
+#include <stddef.h>
 #include <stdint.h>
 #include <ini.h>
 
+// Maximum number of LCD devices driven by one daemon
+#define CONFIG_MAX_DEVICES 4
+
+// Maximum number of overridden keys per [device.*] section
+#define CONFIG_MAX_OVERRIDES 24
+
 /**
  * @brief Color struct for RGB values (0-255).
  * @details Used for all color configuration values in CoolerDash.
@@ -35,9 +42,36 @@ typedef struct {
     int b; // Blue value (0-255)
 } Color;
 
+/**
+ * @brief One key/value pair of a [device.*] section.
+ * @details Stored as text and applied with the normal [display]/[layout]/[font] parser by config_for_device().
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    char name[32];  // Key name, e.g. "brightness"
+    char value[64]; // Raw value text
+} ConfigOverride;
+
+/**
+ * @brief Per-device settings from a [device.<label>] section.
+ * @details uid selects the LCD device; all other keys override the global [display], [layout] and [font] values for that device only.
+ * @example
+ *     // [device.top]
+ *     // uid=abc123
+ *     // brightness=60
+ */
+typedef struct {
+    char label[32];                               // Section suffix after "device."
+    char uid[128];                                // Device UID the section applies to
+    int enabled;                                  // 0 to leave this device alone (default 1)
+    int override_count;                           // Used entries in overrides
+    ConfigOverride overrides[CONFIG_MAX_OVERRIDES]; // Overridden keys in file order
+} DeviceConfig;
+
 /**
  * @brief Structure for runtime configuration loaded from INI file.
- * @details All fields are loaded from the INI file.
+ * @details All fields are loaded from the INI file. Fields missing from the file are zero.
  * @example
  *     Config cfg;
  *     if (load_config_ini(&cfg, "/etc/coolerdash/config.ini") == 0) {
@@ -69,10 +103,13 @@ typedef struct Config {
     char hwmon_path[128];        // Path to hwmon
     char image_dir[128];         // Directory for images
     char image_path[128];        // Path for display image
+    int write_image;             // Also write each frame to image_path (debug, default 0)
     char shutdown_image[128];    // Path for shutdown image
     char pid_file[128];          // Path for PID file
+    char control_socket[108];    // Control socket path (empty = disabled)
     char daemon_address[128];    // Daemon address
     char daemon_password[64];    // Daemon password
+    char daemon_socket[108];     // Unix domain socket of the daemon (empty = TCP)
     Color color_txt_temp;     // RGB for temperature text
     Color color_txt_label;    // RGB for label text
     Color color_temp1_bar;    // RGB for green bar
@@ -81,6 +118,8 @@ typedef struct Config {
     Color color_temp4_bar;    // RGB for red bar
     Color color_bg_bar;       // RGB for bar background
     Color color_border_bar;   // RGB for bar border
+    int device_count;         // Number of [device.*] sections
+    DeviceConfig devices[CONFIG_MAX_DEVICES]; // Per-device overrides
 } Config;
 
 /**
@@ -94,4 +133,24 @@ typedef struct Config {
  */
 int load_config_ini(Config *config, const char *path);
 
+/**
+ * @brief Build the effective configuration of one device.
+ * @details Copies base and applies the overrides of device on top, so every LCD can have its own resolution, layout, brightness and orientation. Returns 0 on success, -1 on error.
+ * @example
+ *     Config effective;
+ *     config_for_device(&config, &config.devices[0], &effective);
+ */
+int config_for_device(const Config *base, const DeviceConfig *device, Config *out);
+
+/**
+ * @brief Check a configuration before it replaces the running one.
+ * @details Validates the global settings and the effective settings of every [device.*] section. Returns 0 if valid, -1 otherwise with a message naming the offending key in error.
+ * @example
+ *     char error[128];
+ *     if (config_validate(&config, error, sizeof(error)) != 0) {
+ *         // keep the previous configuration
+ *     }
+ */
+int config_validate(const Config *config, char *error, size_t error_size);
+
 #endif // CONFIG_H
\ No newline at end of file
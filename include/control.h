@@ -0,0 +1,50 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Local control socket interface.
+ * @details Optional Unix stream socket (mode 0600) served by the main event loop. A client sends one command line and receives the reply, then the connection is closed, e.g. `echo stats | socat - UNIX-CONNECT:/run/coolerdash/control.sock`.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef CONTROL_H
+#define CONTROL_H
+
+// Include necessary headers
+#include <stddef.h>
+
+// Maximum reply length (including terminator)
+#define CONTROL_REPLY_SIZE 4096
+
+/**
+ * @brief Command handler.
+ * @details Receives the command without trailing whitespace and writes a NUL-terminated reply (at most reply_size bytes). Runs on the main thread.
+ * @example
+ *     static void on_command(const char *command, char *reply, size_t reply_size) { ... }
+ */
+typedef void (*control_command_fn)(const char *command, char *reply, size_t reply_size);
+
+/**
+ * @brief Create the control socket and register it with the event loop.
+ * @details Replaces a stale socket file at path. Requires event_loop_init(). Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!control_open(config.control_socket, on_command)) { ... }
+ */
+int control_open(const char *path, control_command_fn on_command);
+
+/**
+ * @brief Close the control socket and all client connections.
+ * @details Removes the socket file. No-op if the socket is not open.
+ * @example
+ *     control_close();
+ */
+void control_close(void);
+
+#endif // CONTROL_H
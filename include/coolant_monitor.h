@@ -8,7 +8,7 @@
 
 /**
  * @brief Coolant temperature monitoring interface for CoolerDash.
- * @details Provides functions and global variables for reading coolant temperature from system sensors.
+ * @details Provides functions for reading coolant temperature from system sensors.
  * @example
  *     See function documentation for usage examples.
  */
@@ -21,8 +21,8 @@
 #include "config.h"
 
 /**
- * @brief Initialize the coolant temperature sensor path using configuration.
- * @details Detects and sets the path to the coolant temperature sensor file using the hwmon_path from Config.
+ * @brief Initialize the coolant temperature sensor lookup using configuration.
+ * @details Populates the shared hwmon registry from the hwmon_path in Config and looks up the coolant temperature input.
  * @example
  *     init_coolant_sensor_path(&config);
  */
@@ -30,18 +30,10 @@ void init_coolant_sensor_path(const Config *config);
 
 /**
  * @brief Read the current coolant temperature.
- * @details Reads the temperature from the coolant sensor file set by init_coolant_sensor_path().
+ * @details Reads the temperature from the coolant sensor file found by init_coolant_sensor_path().
  * @example
  *     float temp = read_coolant_temp();
  */
 float read_coolant_temp(void);
 
-/**
- * @brief Path to the coolant temperature sensor file.
- * @details Set by init_coolant_sensor_path() and used by read_coolant_temp().
- * @example
- *     // Not intended for direct use; managed by module functions.
- */
-extern char coolant_temp_path[512];
-
-#endif // COOLANT_MONITOR_H
+#endif // COOLANT_MONITOR_H
\ No newline at end of file
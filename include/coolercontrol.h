@@ -19,10 +19,134 @@
 
 // Include project headers
 #include "config.h"
+#include "histogram.h"
 
 // Include necessary headers
 #include <stddef.h>
 
+// Buffer sizes of the device index fields
+#define CC_UID_SIZE      128
+#define CC_NAME_SIZE     128
+#define CC_TYPE_SIZE     32
+#define CC_CHANNEL_SIZE  32
+
+/**
+ * @brief LCD image delivery counters.
+ * @details delivered counts acknowledged images (HTTP 200), retries counts repeated attempts, failures counts images given up on after all attempts. reauths counts re-logins after the daemon rejected the session cookie (401/403), e.g. because it was restarted. missed counts images abandoned because they could not be delivered within their deadline (one refresh interval by default).
+ * @example
+ *     lcd_delivery_stats_t stats;
+ *     get_lcd_delivery_stats(&stats);
+ */
+typedef struct {
+    unsigned long long delivered; // Images acknowledged by the daemon
+    unsigned long long retries;   // Extra attempts after a failed send
+    unsigned long long failures;  // Images dropped after all attempts
+    unsigned long long reauths;   // Re-logins after a 401/403 response
+    unsigned long long reauth_failures; // Re-logins the daemon did not accept
+    unsigned long long missed;    // Images abandoned at their deadline (included in failures)
+    long last_response_code;      // HTTP code of the last attempt (0 = transport error)
+    long long first_delivered_ms; // CLOCK_MONOTONIC time of the first acknowledged image (0 = none yet)
+} lcd_delivery_stats_t;
+
+/**
+ * @brief Availability of the daemon as seen by the circuit breaker.
+ * @details UP: frames are uploaded. DOWN: repeated delivery failures opened the breaker; frames are skipped and /health is polled with backoff. RECOVERING: the daemon answered a probe; login and device discovery run before going UP again.
+ * @example
+ *     if (stats.state != CC_LINK_UP) { ... }
+ */
+typedef enum {
+    CC_LINK_UP,
+    CC_LINK_DOWN,
+    CC_LINK_RECOVERING
+} cc_link_state_t;
+
+/**
+ * @brief Circuit breaker state and counters.
+ * @details Filled by get_lcd_link_stats().
+ * @example
+ *     cc_link_stats_t stats;
+ *     get_lcd_link_stats(&stats);
+ */
+typedef struct {
+    cc_link_state_t state;                // Current state
+    unsigned long long outages;           // Times the breaker opened (UP -> DOWN)
+    unsigned long long probes;            // Health probes sent while not UP
+    unsigned long long probe_failures;    // Probes without a 2xx answer
+    unsigned long long recoveries;        // Times the link came back UP
+    unsigned long long recovery_failures; // Login or discovery failed after a healthy probe
+    unsigned long long frames_skipped;    // Frames not rendered while not UP
+    long long last_outage_ms;             // Duration of the last finished outage
+} cc_link_stats_t;
+
+/**
+ * @brief CoolerControl endpoints with separate HTTP timing telemetry.
+ * @details LOGIN covers initial logins and re-logins, DEVICES the /devices discovery, IMAGES every LCD upload attempt (retries included) and HEALTH the /health probes sent while the daemon is unavailable.
+ * @example
+ *     get_endpoint_timing(CC_ENDPOINT_IMAGES, &timing);
+ */
+typedef enum {
+    CC_ENDPOINT_LOGIN,
+    CC_ENDPOINT_DEVICES,
+    CC_ENDPOINT_IMAGES,
+    CC_ENDPOINT_HEALTH,
+    CC_ENDPOINT_COUNT
+} cc_endpoint_t;
+
+/**
+ * @brief Request phases recorded per endpoint.
+ * @details The first five are cURL's cumulative times from the start of the request (DNS done, TCP connected, ready to send, first response byte, finished). WAIT is derived as TOTAL minus the time the request was completely sent (cURL >= 8.10; older versions use PRETRANSFER, so the body transmission is included): daemon-side processing plus the response, as opposed to the connection setup before it.
+ * @example
+ *     histogram_percentile(&timing.phases[CC_PHASE_WAIT], 99.0);
+ */
+typedef enum {
+    CC_PHASE_NAMELOOKUP,
+    CC_PHASE_CONNECT,
+    CC_PHASE_PRETRANSFER,
+    CC_PHASE_STARTTRANSFER,
+    CC_PHASE_TOTAL,
+    CC_PHASE_WAIT,
+    CC_PHASE_COUNT
+} cc_phase_t;
+
+/**
+ * @brief HTTP timing telemetry of one endpoint.
+ * @details Phase histograms are in microseconds and only include requests that completed at the transport level; status counts every request. Fixed size, no allocation while recording.
+ * @example
+ *     cc_endpoint_timing_t timing;
+ *     get_endpoint_timing(CC_ENDPOINT_IMAGES, &timing);
+ */
+typedef struct {
+    histogram_t phases[CC_PHASE_COUNT]; // Phase times in microseconds
+    histogram_t bytes_sent;             // Request bytes uploaded (body included)
+    unsigned long long status[6];       // Responses by class: [0] transport error, [n] nxx
+} cc_endpoint_timing_t;
+
+/**
+ * @brief One device reported by the daemon's /devices endpoint.
+ * @details Built by refresh_device_index(). has_lcd is set when the device has a channel with lcd_info; lcd_channel names that channel. Strings longer than their buffer are truncated.
+ * @example
+ *     cc_device_t dev;
+ *     if (copy_device_info(0, &dev) && dev.has_lcd) printf("%s: %dx%d\n", dev.name, dev.lcd_width, dev.lcd_height);
+ */
+typedef struct {
+    char uid[CC_UID_SIZE];           // Device UID used in API paths
+    char name[CC_NAME_SIZE];         // Display name
+    char type[CC_TYPE_SIZE];         // Driver type, e.g. "Liquidctl"
+    int has_lcd;                     // 1 if the device has an LCD channel
+    char lcd_channel[CC_CHANNEL_SIZE]; // Name of the LCD channel (e.g. "lcd")
+    int lcd_width;                   // LCD width in pixels (0 = unknown)
+    int lcd_height;                  // LCD height in pixels (0 = unknown)
+    long lcd_max_image_size;         // Largest accepted image in bytes (0 = unknown)
+} cc_device_t;
+
+/**
+ * @brief Completion callback for asynchronous image deliveries.
+ * @details success is 1 if the daemon acknowledged the image (after retries), 0 otherwise.
+ * @example
+ *     static void on_done(int success, void *user) { ... }
+ */
+typedef void (*lcd_delivery_done_fn)(int success, void *user);
+
 /**
  * @brief Initializes a CoolerControl session and authenticates with the daemon using configuration.
  * @details Must be called before any other CoolerControl API function.
@@ -51,9 +175,44 @@ void cleanup_coolercontrol_session(void);
  */
 int is_session_initialized(void);
 
+/**
+ * @brief Re-apply the request deadlines after the refresh interval changed.
+ * @details Request and connect timeouts are derived from the refresh interval when the handles are set up; call this after a reload changed it. No request may be in flight on another thread, so call it while the upload worker is paused.
+ * @example
+ *     uploader_pause();
+ *     update_coolercontrol_timeouts(&config);
+ *     uploader_resume();
+ */
+void update_coolercontrol_timeouts(const Config *config);
+
+/**
+ * @brief Fetch /devices once and rebuild the device index.
+ * @details The response is parsed while it streams in, so device objects and responses of any size are handled without buffering. On failure the previous index is kept. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (refresh_device_index(&config)) { ... }
+ */
+int refresh_device_index(const Config *config);
+
+/**
+ * @brief Return the number of devices in the index.
+ * @details Zero before the first successful refresh_device_index(). Safe to call from any thread.
+ * @example
+ *     for (size_t i = 0; i < get_device_count(); ++i) { ... }
+ */
+size_t get_device_count(void);
+
+/**
+ * @brief Copy one device of the index.
+ * @details Safe to call from any thread, also while the index is being replaced. Returns 1 if index is in range, 0 otherwise.
+ * @example
+ *     cc_device_t dev;
+ *     for (size_t i = 0; copy_device_info(i, &dev); ++i) { ... }
+ */
+int copy_device_info(size_t index, cc_device_t *device);
+
 /**
  * @brief Retrieves the full name of the LCD device.
- * @details Gets the device name into the provided buffer. The buffer must be at least CC_NAME_SIZE bytes. The function returns 1 on success, 0 on failure. Always check the return value and ensure the buffer is large enough.
+ * @details Gets the device name from the device index (fetched on first use) into the provided buffer. The device is selected on a copy taken under the index lock, so a concurrent refresh cannot free it while it is read. The buffer must be at least CC_NAME_SIZE bytes. The function returns 1 on success, 0 on failure. Always check the return value and ensure the buffer is large enough.
  * @example
  *     char name[CC_NAME_SIZE];
  *     if (get_device_name(&config, name, sizeof(name))) {
@@ -64,7 +223,7 @@ int get_device_name(const Config *config, char* name_buffer, size_t buffer_size)
 
 /**
  * @brief Retrieves the UID of the first LCD device found.
- * @details Gets the device UID into the provided buffer. The buffer must be at least CC_UID_SIZE bytes. The function returns 1 on success, 0 on failure. Always check the return value and ensure the buffer is large enough.
+ * @details Gets the device UID from the device index (fetched on first use) into the provided buffer. Selected like get_device_name(), so it is equally safe against a concurrent refresh. The buffer must be at least CC_UID_SIZE bytes. The function returns 1 on success, 0 on failure. Always check the return value and ensure the buffer is large enough.
  * @example
  *     char uid[CC_UID_SIZE];
  *     if (get_device_uid(&config, uid, sizeof(uid))) {
@@ -93,12 +252,52 @@ const char* get_cached_device_uid(void);
 
 /**
  * @brief Sends an image directly to the LCD of the CoolerControl device using configuration.
- * @details Uploads an image to the LCD display. The image_path must point to a valid PNG file. Returns 1 on success, 0 on failure. Always check the return value.
+ * @details Uploads an image to the LCD display once and checks the HTTP response; failed sends are retried with bounded exponential backoff. The whole delivery is bounded by one refresh interval (see lcd_delivery_stats_t.missed). The image_path must point to a valid PNG file. Returns 1 on success, 0 on failure. Always check the return value.
  * @example
  *     send_image_to_lcd(&config, "/opt/coolerdash/images/coolerdash.png", uuid);
  */
 int send_image_to_lcd(const Config *config, const char* image_path, const char* device_uid);
 
+/**
+ * @brief Sends an in-memory PNG image to the LCD of the CoolerControl device.
+ * @details Uploads image_size bytes of PNG data from image_data without touching the filesystem. Returns 1 on success, 0 on failure. Always check the return value.
+ * @example
+ *     send_image_data_to_lcd(&config, png, png_size, uuid);
+ */
+int send_image_data_to_lcd(const Config *config, const unsigned char* image_data, size_t image_size, const char* device_uid);
+
+/**
+ * @brief Starts sending an in-memory PNG image to the LCD without waiting.
+ * @details Same delivery as send_image_data_to_lcd() (acknowledgement, retries), but driven by the HTTP engine: the call returns immediately and on_done is invoked from http_engine_run() when the delivery has finished. image_data is not copied and must stay valid until then. Only one delivery per device can be in progress; it is abandoned as missed after one refresh interval. Returns 1 if started, 0 otherwise.
+ * @example
+ *     submit_image_data_to_lcd(&config, png, png_size, uuid, on_done, NULL);
+ */
+int submit_image_data_to_lcd(const Config *config, const unsigned char* image_data, size_t image_size, const char* device_uid, lcd_delivery_done_fn on_done, void *user);
+
+/**
+ * @brief Starts sending an image file to the LCD with its own time budget.
+ * @details Asynchronous like submit_image_data_to_lcd(), but the delivery (retries and re-login included) is abandoned after budget_ms instead of one refresh interval. Used for the shutdown image, which must finish within the service stop timeout. Returns 1 if started, 0 otherwise.
+ * @example
+ *     submit_image_to_lcd(&config, config.shutdown_image, uuid, 2000, on_done, NULL);
+ */
+int submit_image_to_lcd(const Config *config, const char* image_path, const char* device_uid, long budget_ms, lcd_delivery_done_fn on_done, void *user);
+
+/**
+ * @brief Runs the HTTP engine until all deliveries have finished, for at most budget_ms.
+ * @details Deliveries still in progress after budget_ms are abandoned and counted as missed. Returns 1 if all deliveries finished in time, 0 otherwise.
+ * @example
+ *     wait_lcd_deliveries(2000);
+ */
+int wait_lcd_deliveries(long budget_ms);
+
+/**
+ * @brief Abandons all deliveries in progress.
+ * @details Cancels their transfers; each delivery's on_done is called with 0 and counted as missed. Must be called on the thread that owns the HTTP engine.
+ * @example
+ *     abort_lcd_deliveries();
+ */
+void abort_lcd_deliveries(void);
+
 /**
  * @brief Alias for send_image_to_lcd for API compatibility.
  * @details This function is provided for compatibility with other APIs and simply calls send_image_to_lcd(). Returns 1 on success, 0 on failure.
@@ -107,4 +306,63 @@ int send_image_to_lcd(const Config *config, const char* image_path, const char*
  */
 int upload_image_to_device(const Config *config, const char* image_path, const char* device_uid);
 
+/**
+ * @brief Copy the LCD image delivery counters.
+ * @details Reports acknowledged, retried and failed image uploads since start. Safe to call from any thread.
+ * @example
+ *     lcd_delivery_stats_t stats;
+ *     get_lcd_delivery_stats(&stats);
+ */
+void get_lcd_delivery_stats(lcd_delivery_stats_t *stats);
+
+/**
+ * @brief Copy the HTTP timing telemetry of one endpoint.
+ * @details Safe to call from any thread while requests are running. Returns 1 on success, 0 for an invalid endpoint.
+ * @example
+ *     cc_endpoint_timing_t timing;
+ *     if (get_endpoint_timing(CC_ENDPOINT_IMAGES, &timing)) { ... }
+ */
+int get_endpoint_timing(cc_endpoint_t endpoint, cc_endpoint_timing_t *timing);
+
+/**
+ * @brief Return a short name for an endpoint.
+ * @details Used for log and statistics output, e.g. "images".
+ * @example
+ *     printf("%s\n", get_endpoint_name(CC_ENDPOINT_LOGIN));
+ */
+const char *get_endpoint_name(cc_endpoint_t endpoint);
+
+/**
+ * @brief Return a short name for a request phase.
+ * @details Used for log and statistics output, e.g. "connect".
+ * @example
+ *     printf("%s\n", get_phase_name(CC_PHASE_TOTAL));
+ */
+const char *get_phase_name(cc_phase_t phase);
+
+/**
+ * @brief Return whether a frame should be rendered and uploaded.
+ * @details Returns 0 while the daemon is considered unavailable (see cc_link_state_t) and counts the frame as skipped. Safe to call from any thread.
+ * @example
+ *     if (!lcd_link_allows_frame()) return;
+ */
+int lcd_link_allows_frame(void);
+
+/**
+ * @brief Drive the health probes without blocking.
+ * @details Only needed when no upload worker runs the HTTP engine; must be called from the thread owning the engine. No-op while the link is UP.
+ * @example
+ *     if (!lcd_link_allows_frame()) service_lcd_link();
+ */
+void service_lcd_link(void);
+
+/**
+ * @brief Copy the circuit breaker state and counters.
+ * @details Safe to call from any thread.
+ * @example
+ *     cc_link_stats_t stats;
+ *     get_lcd_link_stats(&stats);
+ */
+void get_lcd_link_stats(cc_link_stats_t *stats);
+
 #endif // COOLERCONTROL_H
@@ -8,7 +8,7 @@
 
 /**
  * @brief CPU temperature monitoring interface for CoolerDash.
- * @details Provides functions and global variables for reading CPU temperature from system sensors.
+ * @details Provides functions for reading CPU temperature from system sensors.
  * @example
  *     See function documentation for usage examples.
  */
@@ -19,10 +19,11 @@
 
 // Include project headers
 #include "config.h"
+#include "sensors.h"
 
 /**
- * @brief Initialize the CPU temperature sensor path using configuration.
- * @details Detects and sets the path to the CPU temperature sensor file using the hwmon_path from Config. This function must be called before any temperature readings are performed. Internally uses opendir(), readdir(), fopen(), fclose(), closedir(). Always checks and frees resources. The path is cached in cpu_temp_path.
+ * @brief Initialize the CPU temperature sensor lookup using configuration.
+ * @details Populates the shared hwmon registry (see sensors_init()) from the hwmon_path in Config and looks up the CPU package sensor. This function must be called before any temperature readings are performed.
  * @example
  *     init_cpu_sensor_path(&config);
  */
@@ -30,18 +31,19 @@ void init_cpu_sensor_path(const Config *config);
 
 /**
  * @brief Read the current CPU temperature.
- * @details Reads the temperature from the CPU sensor file set by init_cpu_sensor_path(). Uses fopen(), fscanf(), fclose(). Always checks and frees resources. Returns the temperature in degrees Celsius, or 0.0f on error or if not initialized.
+ * @details Reads the temperature of the CPU sensor found by init_cpu_sensor_path(). Uses a persistent descriptor and a single pread() per call. Returns the temperature in degrees Celsius, or 0.0f on error or if not initialized.
  * @example
  *     float temp = read_cpu_temp();
  */
 float read_cpu_temp(void);
 
 /**
- * @brief Path to the CPU temperature sensor file (set by init_cpu_sensor_path).
- * @details This global variable holds the path to the CPU temperature sensor file, which is detected and set during initialization. It is used by read_cpu_temp() to access the correct sensor file for temperature readings. Must be initialized before calling read_cpu_temp().
+ * @brief Extract the CPU temperature from a registry snapshot.
+ * @details Use together with sensors_sample_all(), which reads the watched sensors in one batch. Returns the temperature in degrees Celsius, or 0.0f if unavailable.
  * @example
- *     // Must be initialized before calling read_cpu_temp().
+ *     sensors_sample_all(&snap);
+ *     float temp = cpu_temp_from_snapshot(&snap);
  */
-extern char cpu_temp_path[512];
+float cpu_temp_from_snapshot(const sensors_snapshot_t *snapshot);
 
 #endif // CPU_MONITOR_H
@@ -34,20 +34,84 @@ typedef struct {
 
 /**
  * @brief Render display based on sensor data and configuration (only default mode).
- * @details Renders the LCD display image using the provided sensor data and configuration. Handles drawing, saving, and uploading the image. Returns 1 on success, 0 on error. Always check the return value.
+ * @details Renders the LCD display image using the provided sensor data and configuration and writes the debug copy if enabled; the image is not uploaded (LCDs are driven through display_add_output() and draw_combined_image()). The Cairo surface, context and pixel buffer are allocated once and reused across frames. Returns 1 on success, 0 on error. Always check the return value.
  * @example
  *     int result = render_display(&config, &sensor_data);
  */
 int render_display(const Config *config, const sensor_data_t *data);
 
+/**
+ * @brief Draw a frame like render_display() without encoding it.
+ * @details Draws into the same render target as render_display() but skips change detection and the PNG encoder, so tests and benchmarks can measure the draw section on its own. Once the caches are built a frame allocates nothing. Returns 1 on success, 0 on error.
+ * @example
+ *     draw_display_frame(&config, &sensor_data);
+ */
+int draw_display_frame(const Config *config, const sensor_data_t *data);
+
 /**
  * @brief Collects sensor data and renders display (default mode only).
- * @details Reads all relevant sensor data (temperatures) and renders the display image. Also uploads the image to the device if available. Handles errors silently and frees all resources. No return value.
+ * @details Reads all relevant sensor data (temperatures), then renders and uploads one image per output added with display_add_output(). Does nothing without outputs. Handles errors silently. No return value.
  * @example
  *     draw_combined_image(&config);
  */
 void draw_combined_image(const Config *config);
 
+/**
+ * @brief Add an LCD output driven by draw_combined_image().
+ * @details Each output has its own copy of the configuration (e.g. from config_for_device()) and its own render target. Without any output, draw_combined_image() renders nothing. Returns 1 on success, 0 on failure.
+ * @example
+ *     display_add_output(&device_config, uid);
+ */
+int display_add_output(const Config *config, const char *device_uid);
+
+/**
+ * @brief Replace the configuration of an output.
+ * @details Caches are rebuilt on the next frame only if the values they depend on changed (e.g. the glyph atlas on a font change). Returns 1 on success, 0 for an invalid index.
+ * @example
+ *     display_set_output_config(i, &device_config);
+ */
+int display_set_output_config(int index, const Config *config);
+
+/**
+ * @brief Draw the next frame of every output regardless of change detection.
+ * @details Used after a configuration change. Also lets a glyph atlas that failed to build try again.
+ * @example
+ *     display_redraw();
+ */
+void display_redraw(void);
+
+/**
+ * @brief Return the number of outputs added with display_add_output().
+ * @details Zero while no output was added, e.g. when no [device.*] section matches a connected LCD.
+ * @example
+ *     int n = display_output_count();
+ */
+int display_output_count(void);
+
+/**
+ * @brief Return the configuration of an output.
+ * @details Valid until cleanup_display(). Returns NULL for an invalid index.
+ * @example
+ *     const Config *device_config = display_output_config(0);
+ */
+const Config *display_output_config(int index);
+
+/**
+ * @brief Return the device UID of an output.
+ * @details Valid until cleanup_display(). Returns NULL for an invalid index.
+ * @example
+ *     const char *uid = display_output_uid(0);
+ */
+const char *display_output_uid(int index);
+
+/**
+ * @brief Release display rendering resources.
+ * @details Frees the persistent Cairo surfaces, contexts and pixel buffers of all outputs and removes the outputs. Safe to call if nothing was rendered yet.
+ * @example
+ *     cleanup_display();
+ */
+void cleanup_display(void);
+
 /**
  * @brief Calculates the color gradient for temperature bars (green → orange → red).
  * @details Utility function for temperature color mapping. Determines the RGB color for a given temperature value according to the defined thresholds. The result is written to the output parameters r, g, b. No return value.
@@ -0,0 +1,74 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Main thread event loop interface (epoll).
+ * @details Multiplexes the descriptors of the main thread (render timer, signals, HTTP engine, control socket) on one epoll instance and dispatches readiness to per-descriptor handlers. The thread only wakes when one of them has work. Not thread-safe: used by the main thread only.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+// Include necessary headers
+#include <stdint.h>
+
+// Maximum number of registered descriptors
+#define EVENT_LOOP_MAX_SOURCES 16
+
+/**
+ * @brief Readiness handler.
+ * @details Called from event_loop_run() with the ready descriptor and its epoll events. May add or remove sources, including its own.
+ * @example
+ *     static void on_timer(int fd, uint32_t events, void *user) { ... }
+ */
+typedef void (*event_handler_fn)(int fd, uint32_t events, void *user);
+
+/**
+ * @brief Create the epoll instance.
+ * @details Idempotent. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!event_loop_init()) { ... }
+ */
+int event_loop_init(void);
+
+/**
+ * @brief Register a descriptor for input readiness.
+ * @details The descriptor stays owned by the caller; remove it before closing. Returns 1 on success, 0 if the table is full or epoll rejects the descriptor.
+ * @example
+ *     event_loop_add(timer_fd, on_timer, &state);
+ */
+int event_loop_add(int fd, event_handler_fn handler, void *user);
+
+/**
+ * @brief Unregister a descriptor.
+ * @details Pending events of the descriptor in the current dispatch round are dropped. No-op for unknown descriptors.
+ * @example
+ *     event_loop_remove(timer_fd);
+ */
+void event_loop_remove(int fd);
+
+/**
+ * @brief Wait for and dispatch events once.
+ * @details Waits up to timeout_ms (-1 = forever) and calls the handlers of all ready descriptors. Returns the number of handlers called, 0 on timeout or EINTR, -1 on error.
+ * @example
+ *     while (running) event_loop_run(-1);
+ */
+int event_loop_run(int timeout_ms);
+
+/**
+ * @brief Close the epoll instance and forget all sources.
+ * @details Registered descriptors are not closed.
+ * @example
+ *     event_loop_cleanup();
+ */
+void event_loop_cleanup(void);
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,101 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Pre-rasterized glyph atlas interface for temperature text.
+ * @details Provides a small cache of glyph masks for the characters used in temperature values, so per-frame text rendering is a few mask blits instead of font selection, shaping and rasterization.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+// Include project headers
+#include "config.h"
+
+// Include necessary headers
+#include <cairo/cairo.h>
+
+// Cached characters: digits, minus, percent and degree sign
+#define GLYPH_ATLAS_COUNT 13
+
+/**
+ * @brief One cached glyph.
+ * @details mask is an A8 surface containing the rasterized glyph; origin_x/origin_y give the pen origin inside the mask. Extents are the cairo text extents of the single glyph.
+ * @example
+ *     // Not intended for direct use; see glyph_atlas_draw().
+ */
+typedef struct {
+    cairo_surface_t *mask;     // A8 glyph coverage mask, NULL if the glyph is empty
+    double origin_x;           // Pen origin inside the mask (x)
+    double origin_y;           // Pen origin inside the mask (y, baseline)
+    cairo_text_extents_t ext;  // Extents and advance of the glyph
+} glyph_t;
+
+/**
+ * @brief Glyph atlas for one font face and size.
+ * @details Built by glyph_atlas_prepare() and rebuilt automatically when the font face or size in the configuration changes. A failed build is latched for its face and size until glyph_atlas_retry(), so a font that cannot be rasterized is not retried on every frame.
+ * @example
+ *     static glyph_atlas_t atlas = { .valid = 0 };
+ *     glyph_atlas_prepare(&atlas, &config);
+ */
+typedef struct {
+    glyph_t glyphs[GLYPH_ATLAS_COUNT];
+    char font_face[64]; // Font face the atlas was built for
+    float font_size;    // Font size the atlas was built for
+    int valid;          // 1 once built successfully
+    int failed;         // 1 if the build for font_face/font_size failed
+} glyph_atlas_t;
+
+/**
+ * @brief Ensure the atlas matches the configured temperature font.
+ * @details Builds the atlas for config->font_face (bold) at config->font_size_temp, or rebuilds it if either changed. A failure is logged once and returned without another attempt until the face or size changes or glyph_atlas_retry() is called. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!glyph_atlas_prepare(&atlas, &config)) {
+ *         // fall back to cairo_show_text()
+ *     }
+ */
+int glyph_atlas_prepare(glyph_atlas_t *atlas, const Config *config);
+
+/**
+ * @brief Allow a failed atlas build to be attempted again.
+ * @details Clears the failure latch, e.g. after a configuration reload (the font may have been installed meanwhile). No effect on a valid atlas.
+ * @example
+ *     glyph_atlas_retry(&atlas);
+ */
+void glyph_atlas_retry(glyph_atlas_t *atlas);
+
+/**
+ * @brief Measure a string composed from cached glyphs.
+ * @details Computes the same ink extents cairo_text_extents() would report for the string (no kerning). Characters that are not in the atlas are skipped.
+ * @example
+ *     cairo_text_extents_t ext;
+ *     glyph_atlas_measure(&atlas, "42\xC2\xB0", &ext);
+ */
+void glyph_atlas_measure(const glyph_atlas_t *atlas, const char *text, cairo_text_extents_t *ext);
+
+/**
+ * @brief Draw a string by blitting cached glyph masks.
+ * @details Uses the current source of cr; (x, y) is the pen position of the first glyph on the baseline, like cairo_move_to() + cairo_show_text().
+ * @example
+ *     cairo_set_source_rgb(cr, 1, 1, 1);
+ *     glyph_atlas_draw(cr, &atlas, "42\xC2\xB0", x, y);
+ */
+void glyph_atlas_draw(cairo_t *cr, const glyph_atlas_t *atlas, const char *text, double x, double y);
+
+/**
+ * @brief Free all glyph masks of an atlas.
+ * @details Leaves the atlas invalid so the next glyph_atlas_prepare() rebuilds it.
+ * @example
+ *     glyph_atlas_release(&atlas);
+ */
+void glyph_atlas_release(glyph_atlas_t *atlas);
+
+#endif // GLYPH_ATLAS_H
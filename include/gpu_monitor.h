@@ -33,7 +33,7 @@ typedef struct {
 
 /**
  * @brief Initialize the GPU monitoring subsystem using configuration.
- * @details Initializes the GPU monitoring backend and checks for GPU availability using config values.
+ * @details Initializes the GPU monitoring backend and checks for GPU availability using config values. NVML (libnvidia-ml.so.1) is loaded at runtime if present; otherwise a single long-lived nvidia-smi stream is used.
  * @example
  *     if (init_gpu_monitor(&config)) {
  *         // GPU available
@@ -60,4 +60,20 @@ float read_gpu_temp(const Config *config);
  */
 int get_gpu_data_full(const Config *config, gpu_data_t *data);
 
+/**
+ * @brief Release GPU monitoring resources.
+ * @details Shuts down the active GPU backend (e.g. unloads NVML). Safe to call if init_gpu_monitor() was never called.
+ * @example
+ *     cleanup_gpu_monitor();
+ */
+void cleanup_gpu_monitor(void);
+
+/**
+ * @brief Terminate the nvidia-smi stream child process, if running.
+ * @details Only used by the nvidia-smi fallback backend. The child is not tied to the thread that started it, so it must be stopped explicitly before exit; it is restarted by the next read. Blocks for at most a short grace period before escalating to SIGKILL.
+ * @example
+ *     stop_gpu_stream();
+ */
+void stop_gpu_stream(void);
+
 #endif // GPU_MONITOR_H
@@ -0,0 +1,72 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Fixed-memory log-linear histogram interface.
+ * @details Values are counted in buckets that are exact below 2 * HISTOGRAM_SUB_BUCKETS and split every power of two into HISTOGRAM_SUB_BUCKETS linear steps above, so the relative error stays below 1 / HISTOGRAM_SUB_BUCKETS over the whole range. Recording never allocates.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+// Include necessary headers
+#include <stdint.h>
+
+// Linear sub-buckets per power of two (log2)
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+
+// Largest tracked magnitude (log2); bigger values are counted in the last bucket
+#define HISTOGRAM_MAX_BITS 40
+
+// Number of buckets covering [0, 2^HISTOGRAM_MAX_BITS)
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * @brief Histogram of non-negative integer values.
+ * @details Zero-initialized storage is an empty histogram. min/max/sum are exact; percentiles are bucket estimates.
+ * @example
+ *     static histogram_t latency_us;
+ *     histogram_record(&latency_us, 1250);
+ */
+typedef struct {
+    uint64_t counts[HISTOGRAM_BUCKETS]; // Values per bucket
+    uint64_t count;                     // Number of recorded values
+    uint64_t sum;                       // Sum of recorded values
+    uint64_t min;                       // Smallest value (valid if count > 0)
+    uint64_t max;                       // Largest value (valid if count > 0)
+} histogram_t;
+
+/**
+ * @brief Add one value.
+ * @details O(1): one count-leading-zeros and one increment.
+ * @example
+ *     histogram_record(&h, elapsed_us);
+ */
+void histogram_record(histogram_t *h, uint64_t value);
+
+/**
+ * @brief Estimate a percentile.
+ * @details Returns the midpoint of the bucket holding the p-th percentile (0-100), clamped to the exact min/max. Returns 0 for an empty histogram.
+ * @example
+ *     uint64_t p99 = histogram_percentile(&h, 99.0);
+ */
+uint64_t histogram_percentile(const histogram_t *h, double p);
+
+/**
+ * @brief Return the mean of all recorded values.
+ * @details Returns 0 for an empty histogram.
+ * @example
+ *     double avg = histogram_mean(&h);
+ */
+double histogram_mean(const histogram_t *h);
+
+#endif // HISTOGRAM_H
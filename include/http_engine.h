@@ -0,0 +1,140 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Non-blocking HTTP engine interface (curl multi + epoll).
+ * @details Drives all CoolerControl transfers through one curl multi handle whose sockets and timeout are registered in a private epoll instance. Several requests can be in flight at once on a single thread. The engine is not thread-safe: it is owned by one thread at a time (main thread during init and shutdown, upload worker in between).
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef HTTP_ENGINE_H
+#define HTTP_ENGINE_H
+
+// Include necessary headers
+#include <curl/curl.h>
+
+/**
+ * @brief One asynchronous HTTP request.
+ * @details Owned by the caller and must stay valid until done() has been called. The caller configures easy (URL, body, ...) before submitting; done() runs on the thread calling http_engine_run() and may resubmit the same request.
+ * @example
+ *     static http_request_t req = { .easy = NULL, .done = on_done, .user = NULL };
+ *     req.easy = http_engine_easy();
+ */
+typedef struct http_request {
+    CURL *easy;                                                              // Configured easy handle
+    void (*done)(struct http_request *req, CURLcode result, long response_code); // Completion callback
+    void *user;                                                              // Caller context for done()
+    long long due_ns;                                                        // Internal: start time for deferred requests
+    struct http_request *next;                                               // Internal: engine list link
+} http_request_t;
+
+/**
+ * @brief Transport counters of the HTTP engine.
+ * @details new_connections counts connections opened by finished transfers (CURLINFO_NUM_CONNECTS). With working keep-alive it stays at the number of handles that ever connected instead of growing with requests.
+ * @example
+ *     http_engine_stats_t stats;
+ *     http_engine_get_stats(&stats);
+ */
+typedef struct {
+    unsigned long long requests;        // Finished transfers
+    unsigned long long new_connections; // Connections opened by those transfers
+    unsigned long long reused;          // Transfers that reused an existing connection
+} http_engine_stats_t;
+
+/**
+ * @brief Create the multi handle, the cookie/DNS share and the epoll/timer descriptors.
+ * @details Requires curl_global_init(). Idempotent. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!http_engine_init()) { ... }
+ */
+int http_engine_init(void);
+
+/**
+ * @brief Create an easy handle attached to the engine's cookie/DNS share.
+ * @details All handles created this way see the same session cookie. Free with curl_easy_cleanup() after the request is finished. Returns NULL on failure.
+ * @example
+ *     CURL *easy = http_engine_easy();
+ */
+CURL *http_engine_easy(void);
+
+/**
+ * @brief Start an asynchronous request.
+ * @details Adds req->easy to the multi handle; the transfer progresses inside http_engine_run(). Returns 1 on success, 0 on failure (done() is not called then).
+ * @example
+ *     http_engine_submit(&req);
+ */
+int http_engine_submit(http_request_t *req);
+
+/**
+ * @brief Start an asynchronous request after a delay.
+ * @details The request is held by the engine and started by http_engine_run() once delay_ms have passed; used for retry backoff without sleeping. Returns 1 on success, 0 on failure.
+ * @example
+ *     http_engine_submit_after(&req, 200);
+ */
+int http_engine_submit_after(http_request_t *req, long delay_ms);
+
+/**
+ * @brief Wait for and process engine events.
+ * @details Waits up to timeout_ms (-1 = forever, 0 = poll) for socket or timer activity, drives curl and calls done() for finished requests. Returns the number of completed requests, or -1 on error.
+ * @example
+ *     while (http_engine_pending()) http_engine_run(-1);
+ */
+int http_engine_run(int timeout_ms);
+
+/**
+ * @brief Perform one request and wait for it (blocking wrapper).
+ * @details Submits easy and runs the engine until it finishes; other in-flight requests progress meanwhile. Stores the HTTP response code in *response_code (may be NULL). Returns the curl result code.
+ * @example
+ *     long code = 0;
+ *     CURLcode res = http_engine_perform(easy, &code);
+ */
+CURLcode http_engine_perform(CURL *easy, long *response_code);
+
+/**
+ * @brief Cancel a pending request.
+ * @details Stops the transfer (or its delayed start) without calling done(). The easy handle stays owned by the caller.
+ * @example
+ *     http_engine_cancel(&req);
+ */
+void http_engine_cancel(http_request_t *req);
+
+/**
+ * @brief Return the number of requests in flight or waiting for their start time.
+ * @details Zero when the engine is idle.
+ * @example
+ *     if (http_engine_pending()) { ... }
+ */
+int http_engine_pending(void);
+
+/**
+ * @brief Return the engine's epoll descriptor.
+ * @details Becomes readable whenever http_engine_run() has work to do, so the engine can be nested in an outer event loop. Returns -1 before http_engine_init().
+ * @example
+ *     int fd = http_engine_fd();
+ */
+int http_engine_fd(void);
+
+/**
+ * @brief Copy the engine transport counters.
+ * @details Safe to call from any thread while the engine runs; each counter is read atomically.
+ * @example
+ *     http_engine_get_stats(&stats);
+ */
+void http_engine_get_stats(http_engine_stats_t *stats);
+
+/**
+ * @brief Abort all requests and free engine resources.
+ * @details Pending requests are removed without calling done(); their easy handles stay owned by the caller.
+ * @example
+ *     http_engine_cleanup();
+ */
+void http_engine_cleanup(void);
+
+#endif // HTTP_ENGINE_H
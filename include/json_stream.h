@@ -0,0 +1,103 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Incremental (SAX-style) JSON parser interface.
+ * @details Parses JSON text fed in arbitrary chunks, e.g. straight from a cURL write callback, and reports each token through a callback. The whole document is never buffered, so memory use does not depend on the response size. Strings longer than JSON_STREAM_MAX_TOKEN - 1 bytes are truncated.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+// Include necessary headers
+#include <stddef.h>
+
+// Maximum nesting depth of objects and arrays
+#define JSON_STREAM_MAX_DEPTH 64
+
+// Maximum length of a reported string, key or number (including terminator)
+#define JSON_STREAM_MAX_TOKEN 256
+
+/**
+ * @brief Token types reported by the parser.
+ * @details Scalars and keys carry their text; container events carry none.
+ * @example
+ *     if (event == JSON_EVENT_KEY) { ... }
+ */
+typedef enum {
+    JSON_EVENT_OBJECT_START,
+    JSON_EVENT_OBJECT_END,
+    JSON_EVENT_ARRAY_START,
+    JSON_EVENT_ARRAY_END,
+    JSON_EVENT_KEY,
+    JSON_EVENT_STRING,
+    JSON_EVENT_NUMBER,
+    JSON_EVENT_TRUE,
+    JSON_EVENT_FALSE,
+    JSON_EVENT_NULL
+} json_event_t;
+
+/**
+ * @brief Token callback.
+ * @details text is NUL-terminated (unescaped for strings and keys) and only valid during the call; NULL for container events. depth is the nesting level the token belongs to: 1 for the root container and its members, 2 for a container nested in it, and so on.
+ * @example
+ *     static void on_token(json_event_t event, const char *text, int depth, void *user) { ... }
+ */
+typedef void (*json_event_fn)(json_event_t event, const char *text, int depth, void *user);
+
+/**
+ * @brief Parser state.
+ * @details Initialize with json_stream_init(); the struct holds all state between chunks and needs no cleanup.
+ * @example
+ *     json_stream_t parser;
+ *     json_stream_init(&parser, on_token, &ctx);
+ */
+typedef struct {
+    json_event_fn on_event;                // Token callback
+    void *user;                            // Caller context for on_event
+    int state;                             // Internal lexer state
+    int depth;                             // Number of open containers
+    int first;                             // 1 right after '[' or '{' (empty container allowed)
+    int is_key;                            // 1 while the current string is an object key
+    int error;                             // 1 after a syntax error
+    char stack[JSON_STREAM_MAX_DEPTH];     // Container type per level ('{' or '[')
+    char token[JSON_STREAM_MAX_TOKEN];     // Current string/number/literal
+    size_t token_len;                      // Bytes in token
+    unsigned int codepoint;                // \uXXXX being decoded
+    unsigned int high_surrogate;           // Pending UTF-16 high surrogate
+    int hex_digits;                        // Hex digits read for codepoint
+} json_stream_t;
+
+/**
+ * @brief Initialize a parser.
+ * @details Resets all state; the parser expects exactly one JSON value.
+ * @example
+ *     json_stream_init(&parser, on_token, &ctx);
+ */
+void json_stream_init(json_stream_t *parser, json_event_fn on_event, void *user);
+
+/**
+ * @brief Feed the next chunk of JSON text.
+ * @details Chunks may split tokens anywhere, including inside escapes. Returns 1 if the input so far is valid, 0 on a syntax error (the parser then ignores further input).
+ * @example
+ *     if (!json_stream_feed(&parser, chunk, len)) { ... }
+ */
+int json_stream_feed(json_stream_t *parser, const char *data, size_t len);
+
+/**
+ * @brief Signal the end of input.
+ * @details Flushes a trailing top-level number or literal. Returns 1 if exactly one complete JSON value was parsed, 0 otherwise.
+ * @example
+ *     if (!json_stream_finish(&parser)) { ... }
+ */
+int json_stream_finish(json_stream_t *parser);
+
+#endif // JSON_STREAM_H
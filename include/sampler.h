@@ -0,0 +1,98 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Background sensor sampling interface for CoolerDash.
+ * @details Provides a dedicated sampler thread that polls all sensors on its own schedule and publishes sensor_data_t snapshots through a lock-free seqlock, so rendering never waits on a slow sensor.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+// Include project headers
+#include "config.h"
+#include "display.h"
+
+/**
+ * @brief Sampler instrumentation counters.
+ * @details Latency is the duration of one sampling pass (all sensors). Staleness is the age of the snapshot at the moment the renderer read it. All times in nanoseconds.
+ * @example
+ *     sampler_stats_t stats;
+ *     sampler_get_stats(&stats);
+ */
+typedef struct {
+    unsigned long long samples;      // Snapshots published by the sampler
+    long long last_latency_ns;       // Duration of the most recent pass
+    long long max_latency_ns;        // Longest pass so far
+    long long total_latency_ns;      // Sum of all passes (for averages)
+    unsigned long long reads;        // Snapshots consumed by the renderer
+    long long last_staleness_ns;     // Age of the most recently consumed snapshot
+    long long max_staleness_ns;      // Oldest snapshot consumed so far
+    long long total_staleness_ns;    // Sum of all staleness values (for averages)
+    unsigned long long read_retries; // Seqlock retries caused by concurrent publishes
+} sampler_stats_t;
+
+/**
+ * @brief Collect one set of sensor values synchronously.
+ * @details Samples the watched hwmon sensors in one batch and reads the GPU temperature. Used by the sampler thread and as inline fallback when the thread is not running.
+ * @example
+ *     sensor_data_t data;
+ *     sampler_sample_once(&config, &data);
+ */
+void sampler_sample_once(const Config *config, sensor_data_t *data);
+
+/**
+ * @brief Start the background sampler thread.
+ * @details The first snapshot is taken synchronously; the thread then samples once per display refresh interval, and publishes each result. Signals are blocked in the thread so they are always delivered to the main thread. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!sampler_start(&config)) {
+ *         // fall back to inline sampling
+ *     }
+ */
+int sampler_start(const Config *config);
+
+/**
+ * @brief Stop and join the background sampler thread.
+ * @details Wakes the thread immediately (no waiting for the current interval) and joins it. Safe to call if the thread is not running.
+ * @example
+ *     sampler_stop();
+ */
+void sampler_stop(void);
+
+/**
+ * @brief Return whether the background sampler is running.
+ * @details Returns 1 if sampler_start() succeeded and sampler_stop() was not called yet.
+ * @example
+ *     if (sampler_is_running()) { ... }
+ */
+int sampler_is_running(void);
+
+/**
+ * @brief Read the latest published snapshot.
+ * @details Lock-free seqlock read; completes in nanoseconds and never blocks on the sampler. Records the snapshot staleness. Returns 1 if a snapshot was available, 0 if nothing has been published yet.
+ * @example
+ *     sensor_data_t data;
+ *     if (sampler_read(&data)) {
+ *         render_display(&config, &data);
+ *     }
+ */
+int sampler_read(sensor_data_t *data);
+
+/**
+ * @brief Copy the sampler instrumentation counters.
+ * @details Safe to call from any thread; values are a best-effort consistent copy.
+ * @example
+ *     sampler_stats_t stats;
+ *     sampler_get_stats(&stats);
+ */
+void sampler_get_stats(sampler_stats_t *stats);
+
+#endif // SAMPLER_H
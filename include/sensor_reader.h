@@ -0,0 +1,53 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Persistent-descriptor sysfs reader interface for CoolerDash.
+ * @details Provides the low-level primitives used to read hwmon value files through descriptors that stay open, avoiding fopen()/fscanf()/fclose() on every tick.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef SENSOR_READER_H
+#define SENSOR_READER_H
+
+// Include necessary headers
+#include <stddef.h>
+
+/**
+ * @brief Read the current integer value from an open sysfs descriptor.
+ * @details Uses a single pread() at offset 0 into a stack buffer and parses it with sensor_parse_long(). No heap traffic. Returns 1 on success, 0 on failure. On failure errno is as set by pread() if the syscall failed, so callers can detect ENODEV/ESTALE and reopen, and EIO if it returned an empty or unparsable value.
+ * @example
+ *     long millideg;
+ *     if (sensor_pread_long(fd, &millideg)) {
+ *         // use millideg
+ *     }
+ */
+int sensor_pread_long(int fd, long *value);
+
+/**
+ * @brief Check whether a failed read means the descriptor must be reopened.
+ * @details Returns 1 if errno indicates that the underlying device was removed or rebound (ENODEV, ESTALE), 0 otherwise.
+ * @example
+ *     if (!sensor_pread_long(fd, &v) && sensor_read_needs_reopen()) {
+ *         // reopen and retry once
+ *     }
+ */
+int sensor_read_needs_reopen(void);
+
+/**
+ * @brief Parse a decimal integer from a sysfs buffer.
+ * @details Skips leading whitespace, accepts an optional minus sign and stops at the first non-digit. Does not require null termination. Returns 1 if at least one digit was parsed, 0 otherwise.
+ * @example
+ *     long v;
+ *     sensor_parse_long("45000\n", 6, &v);
+ */
+int sensor_parse_long(const char *buf, size_t len, long *value);
+
+#endif // SENSOR_READER_H
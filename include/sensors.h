@@ -0,0 +1,131 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Unified hwmon sensor registry interface for CoolerDash.
+ * @details Enumerates every hwmon chip once, keeps one descriptor per sensor input in a compact table and samples all of them in a single call. CPU, coolant and future sensors are lookups into this table.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef SENSORS_H
+#define SENSORS_H
+
+// Include project headers
+#include "config.h"
+
+// Registry size constants
+#define SENSORS_MAX        256
+#define SENSORS_MAX_CHIPS  32
+#define SENSOR_LABEL_SIZE  32
+#define SENSOR_NAME_SIZE   24
+
+/**
+ * @brief Kind of hwmon input.
+ * @details Raw units follow the hwmon sysfs ABI: temp in millidegree Celsius, fan in RPM, pwm in 0-255, power in microwatt, in in millivolt.
+ * @example
+ *     int idx = sensors_find(SENSOR_KIND_TEMP, "Package id 0");
+ */
+typedef enum {
+    SENSOR_KIND_TEMP,
+    SENSOR_KIND_FAN,
+    SENSOR_KIND_PWM,
+    SENSOR_KIND_POWER,
+    SENSOR_KIND_IN,
+    SENSOR_KIND_COUNT
+} sensor_kind_t;
+
+/**
+ * @brief Timestamped snapshot of the watched sensors.
+ * @details Filled by sensors_sample_all(). Entries are indexed like the registry; valid[i] is 0 if sensor i is not watched or its read failed.
+ * @example
+ *     static sensors_snapshot_t snap;
+ *     sensors_sample_all(&snap);
+ */
+typedef struct {
+    long long timestamp_ns;           // CLOCK_MONOTONIC time of the sample
+    int count;                        // Number of entries filled
+    long value[SENSORS_MAX];          // Raw sysfs values
+    unsigned char valid[SENSORS_MAX]; // 1 if value[i] was read successfully
+} sensors_snapshot_t;
+
+/**
+ * @brief Enumerate all hwmon chips and open their inputs (once).
+ * @details Walks config->hwmon_path a single time with openat()/dirfd, registering temp, fan, pwm, power and in* inputs together with their labels. Subsequent calls return the existing registry. Returns the number of registered sensors.
+ * @example
+ *     sensors_init(&config);
+ */
+int sensors_init(const Config *config);
+
+/**
+ * @brief Find a registered sensor by kind and label.
+ * @details Returns the index of the first sensor of the given kind whose label (or chip name, if the input has no label) contains the given text, case-insensitive. Returns -1 if nothing matches.
+ * @example
+ *     int idx = sensors_find(SENSOR_KIND_TEMP, "coolant");
+ */
+int sensors_find(sensor_kind_t kind, const char *label);
+
+/**
+ * @brief Mark a registered sensor as consumed, so sensors_sample_all() reads it.
+ * @details Only watched inputs are read on every pass; reading the others (fans, power, voltages, other GPUs) could wake a runtime-suspended device for nothing. Watching an index twice is harmless. sensors_cleanup() clears the list. Returns 1 on success, 0 for an unknown index.
+ * @example
+ *     sensors_watch(sensors_find(SENSOR_KIND_TEMP, "Package id 0"));
+ */
+int sensors_watch(int index);
+
+/**
+ * @brief Read a single registered sensor.
+ * @details One pread() on the cached descriptor; reopens transparently on ENODEV/ESTALE. Returns 1 on success, 0 on failure.
+ * @example
+ *     long raw;
+ *     if (sensors_read(idx, &raw)) { ... }
+ */
+int sensors_read(int index, long *value);
+
+/**
+ * @brief Sample every watched sensor into a snapshot.
+ * @details Reads the sensors marked with sensors_watch() and stamps the snapshot with CLOCK_MONOTONIC. Unwatched entries are marked invalid without being read. Returns the number of successfully read sensors.
+ * @example
+ *     sensors_sample_all(&snap);
+ */
+int sensors_sample_all(sensors_snapshot_t *snapshot);
+
+/**
+ * @brief Return the number of registered sensors.
+ * @details Zero before sensors_init() or if no hwmon inputs were found.
+ * @example
+ *     int n = sensors_count();
+ */
+int sensors_count(void);
+
+/**
+ * @brief Return the label of a registered sensor.
+ * @details Returns the contents of the matching *_label file, or an empty string. Never returns NULL.
+ * @example
+ *     printf("%s\n", sensors_label(idx));
+ */
+const char *sensors_label(int index);
+
+/**
+ * @brief Convert a raw temperature value to degrees Celsius.
+ * @details hwmon reports millidegrees; values that already look like degrees are passed through.
+ * @example
+ *     float c = sensors_temp_celsius(raw);
+ */
+float sensors_temp_celsius(long raw);
+
+/**
+ * @brief Close all descriptors held by the registry.
+ * @details After this call the registry and the watch list are empty and sensors_init() may be called again; consumers must look up and watch their sensors again.
+ * @example
+ *     sensors_cleanup();
+ */
+void sensors_cleanup(void);
+
+#endif // SENSORS_H
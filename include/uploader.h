@@ -0,0 +1,106 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Asynchronous LCD upload interface for CoolerDash.
+ * @details Provides a dedicated upload worker fed by a single-slot mailbox per LCD device. The renderer hands over each encoded frame and returns immediately; if the daemon is slow, a newer frame replaces the pending one of the same device so frames never queue up. Uploads to different devices run concurrently.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Function prototypes
+#ifndef UPLOADER_H
+#define UPLOADER_H
+
+// Include project headers
+#include "config.h"
+
+// Include necessary headers
+#include <stddef.h>
+
+/**
+ * @brief Upload worker instrumentation counters.
+ * @details Every taken frame ends up in exactly one of uploaded, failed and not_sent (or is still in flight). Queue wait is the time a frame spent in the mailbox before the worker picked it up. All times in nanoseconds.
+ * @example
+ *     uploader_stats_t stats;
+ *     uploader_get_stats(&stats);
+ */
+typedef struct {
+    unsigned long long submitted;  // Frames handed to the mailbox
+    unsigned long long superseded; // Frames replaced by a newer one before upload
+    unsigned long long taken;      // Frames taken by the worker from the mailbox
+    unsigned long long uploaded;   // Frames the LCD accepted
+    unsigned long long failed;     // Frames whose delivery failed or was abandoned
+    unsigned long long not_sent;   // Frames dropped because no delivery could be started (no session, link down)
+    long long last_wait_ns;        // Queue wait of the most recent frame
+    long long max_wait_ns;         // Longest queue wait so far
+    long long total_wait_ns;       // Sum of all queue waits (for averages)
+} uploader_stats_t;
+
+/**
+ * @brief Start the upload worker thread.
+ * @details The worker sends frames with submit_image_data_to_lcd() to the device they were submitted for. Signals are blocked in the worker so they are always delivered to the main thread. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!uploader_start()) {
+ *         // fall back to inline uploads
+ *     }
+ */
+int uploader_start(void);
+
+/**
+ * @brief Stop and join the upload worker thread.
+ * @details Gives uploads in progress a short grace period to finish and abandons them afterwards; frames still waiting in the mailbox are dropped. Safe to call if the worker is not running.
+ * @example
+ *     uploader_stop();
+ */
+void uploader_stop(void);
+
+/**
+ * @brief Return whether the upload worker is running.
+ * @details Returns 1 if uploader_start() succeeded and uploader_stop() was not called yet.
+ * @example
+ *     if (uploader_is_running()) { ... }
+ */
+int uploader_is_running(void);
+
+/**
+ * @brief Hold the upload worker between two event rounds.
+ * @details Returns once the worker is idle and keeps it idle until uploader_resume(). While held, the caller may modify the configurations passed to uploader_submit() and the session configuration; transfers in flight stay open. Do not call uploader_submit() while holding it. No-op if the worker is not running.
+ * @example
+ *     uploader_pause();
+ *     config = fresh;
+ *     uploader_resume();
+ */
+void uploader_pause(void);
+
+/**
+ * @brief Let the upload worker continue after uploader_pause().
+ * @details Must be paired with uploader_pause() on the same thread.
+ * @example
+ *     uploader_resume();
+ */
+void uploader_resume(void);
+
+/**
+ * @brief Hand an encoded frame to the upload worker.
+ * @details Copies the PNG into the device's mailbox slot and wakes the worker; never waits for the network. A frame of the same device that is still pending is replaced and counted as superseded. config must stay valid while the worker runs. Returns 1 on success, 0 on failure (worker not running, more than CONFIG_MAX_DEVICES devices or out of memory).
+ * @example
+ *     uploader_submit(&config, uid, png, png_size);
+ */
+int uploader_submit(const Config *config, const char *device_uid, const unsigned char *data, size_t size);
+
+/**
+ * @brief Copy the upload worker counters.
+ * @details Safe to call from any thread.
+ * @example
+ *     uploader_stats_t stats;
+ *     uploader_get_stats(&stats);
+ */
+void uploader_get_stats(uploader_stats_t *stats);
+
+#endif // UPLOADER_H
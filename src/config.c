@@ -22,6 +22,58 @@
 #include <string.h>
 #include <stdlib.h>
 
+// Section prefix for per-device settings
+#define DEVICE_SECTION_PREFIX "device."
+
+/**
+ * @brief Find or create the DeviceConfig of a [device.<label>] section.
+ * @details Returns NULL if CONFIG_MAX_DEVICES sections are already in use.
+ * @example
+ *     DeviceConfig *device = device_section(config, "top");
+ */
+static DeviceConfig *device_section(Config *config, const char *label)
+{
+    for (int i = 0; i < config->device_count; ++i) {
+        if (strcmp(config->devices[i].label, label) == 0) return &config->devices[i];
+    }
+    if (config->device_count >= CONFIG_MAX_DEVICES) return NULL;
+    DeviceConfig *device = &config->devices[config->device_count++];
+    strncpy(device->label, label, sizeof(device->label) - 1);
+    device->label[sizeof(device->label) - 1] = '\0';
+    device->enabled = 1;
+    return device;
+}
+
+/**
+ * @brief Handle one key of a [device.<label>] section.
+ * @details uid and enabled are stored directly; every other key is kept as an override for config_for_device(). Extra sections or keys beyond the limits are reported and ignored.
+ * @example
+ *     device_config_handler(config, "top", "brightness", "60");
+ */
+static void device_config_handler(Config *config, const char *label, const char *name, const char *value)
+{
+    DeviceConfig *device = device_section(config, label);
+    if (!device) {
+        fprintf(stderr, "[CoolerDash] Warning: Ignoring [device.%s], at most %d devices are supported\n", label, CONFIG_MAX_DEVICES);
+        return;
+    }
+    if (strcmp(name, "uid") == 0) {
+        strncpy(device->uid, value, sizeof(device->uid) - 1);
+        device->uid[sizeof(device->uid) - 1] = '\0';
+    }
+    else if (strcmp(name, "enabled") == 0) device->enabled = atoi(value);
+    else if (device->override_count < CONFIG_MAX_OVERRIDES) {
+        ConfigOverride *override = &device->overrides[device->override_count++];
+        strncpy(override->name, name, sizeof(override->name) - 1);
+        override->name[sizeof(override->name) - 1] = '\0';
+        strncpy(override->value, value, sizeof(override->value) - 1);
+        override->value[sizeof(override->value) - 1] = '\0';
+    }
+    else {
+        fprintf(stderr, "[CoolerDash] Warning: Too many keys in [device.%s], ignoring %s\n", label, name);
+    }
+}
+
 /**
  * @brief INI parser handler, sets values in Config struct.
  * @details Called for each key-value pair in the INI file. Matches section and key names and sets the corresponding field in the Config struct. Unrecognized keys are ignored. For string fields, strncpy is used and buffers are always null-terminated for safety.
@@ -32,7 +84,10 @@ static int inih_config_handler(void *user, const char *section, const char *name
 {
     Config *config = (Config *)user;
 
-    if (strcmp(section, "display") == 0) {
+    if (strncmp(section, DEVICE_SECTION_PREFIX, strlen(DEVICE_SECTION_PREFIX)) == 0) {
+        device_config_handler(config, section + strlen(DEVICE_SECTION_PREFIX), name, value);
+    }
+    else if (strcmp(section, "display") == 0) {
         if (strcmp(name, "width") == 0) config->display_width = atoi(value);
         else if (strcmp(name, "height") == 0) config->display_height = atoi(value);
         else if (strcmp(name, "refresh_interval_sec") == 0) config->display_refresh_interval_sec = atoi(value);
@@ -79,6 +134,7 @@ static int inih_config_handler(void *user, const char *section, const char *name
             strncpy(config->image_path, value, sizeof(config->image_path) - 1);
             config->image_path[sizeof(config->image_path) - 1] = '\0';
         }
+        else if (strcmp(name, "write_image") == 0) config->write_image = atoi(value);
         else if (strcmp(name, "shutdown_image") == 0) {
             strncpy(config->shutdown_image, value, sizeof(config->shutdown_image) - 1);
             config->shutdown_image[sizeof(config->shutdown_image) - 1] = '\0';
@@ -87,6 +143,10 @@ static int inih_config_handler(void *user, const char *section, const char *name
             strncpy(config->pid_file, value, sizeof(config->pid_file) - 1);
             config->pid_file[sizeof(config->pid_file) - 1] = '\0';
         }
+        else if (strcmp(name, "control_socket") == 0) {
+            strncpy(config->control_socket, value, sizeof(config->control_socket) - 1);
+            config->control_socket[sizeof(config->control_socket) - 1] = '\0';
+        }
     }
     else if (strcmp(section, "daemon") == 0) {
         if (strcmp(name, "address") == 0) {
@@ -97,6 +157,10 @@ static int inih_config_handler(void *user, const char *section, const char *name
             strncpy(config->daemon_password, value, sizeof(config->daemon_password) - 1);
             config->daemon_password[sizeof(config->daemon_password) - 1] = '\0';
         }
+        else if (strcmp(name, "socket") == 0) {
+            strncpy(config->daemon_socket, value, sizeof(config->daemon_socket) - 1);
+            config->daemon_socket[sizeof(config->daemon_socket) - 1] = '\0';
+        }
     }
     else if (strcmp(section, "color_txt_temp") == 0) {
         if (strcmp(name, "r") == 0) config->color_txt_temp.r = atoi(value);
@@ -143,7 +207,7 @@ static int inih_config_handler(void *user, const char *section, const char *name
 
 /**
  * @brief Loads configuration from INI file.
- * @details Parses the INI file and fills the Config struct. Returns 0 on success, -1 on error. Always check the return value.
+ * @details Zeroes the Config struct, then parses the INI file and fills it, so keys missing from the file default to 0. Returns 0 on success, -1 on error. Always check the return value.
  * @example
  *     Config cfg;
  *     if (load_config_ini(&cfg, "/etc/coolerdash/config.ini") != 0) {
@@ -153,9 +217,93 @@ static int inih_config_handler(void *user, const char *section, const char *name
 int load_config_ini(Config *config, const char *path)
 {
     if (!config || !path) return -1;
+    memset(config, 0, sizeof(*config));
     int error = ini_parse(path, inih_config_handler, config);
     if (error < 0) {
         return -1;
     }
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Build the effective configuration of one device.
+ * @details Each override is offered to the [display], [layout] and [font] parsers; key names are unique across these sections. The refresh interval stays global because all devices share one render loop.
+ * @example
+ *     Config effective;
+ *     config_for_device(&config, &config.devices[0], &effective);
+ */
+int config_for_device(const Config *base, const DeviceConfig *device, Config *out)
+{
+    if (!base || !out) return -1;
+    if (out != base) *out = *base;
+    if (!device) return 0;
+    static const char *const sections[] = { "display", "layout", "font" };
+    for (int i = 0; i < device->override_count; ++i) {
+        const ConfigOverride *override = &device->overrides[i];
+        for (size_t s = 0; s < sizeof(sections) / sizeof(sections[0]); ++s) {
+            inih_config_handler(out, sections[s], override->name, override->value);
+        }
+    }
+    out->display_refresh_interval_sec = base->display_refresh_interval_sec;
+    out->display_refresh_interval_nsec = base->display_refresh_interval_nsec;
+    return 0;
+}
+
+/**
+ * @brief Check the display settings of one (effective) configuration.
+ * @details Writes a message naming the offending key and where (e.g. "[device.top]") to error. Returns 0 if valid, -1 otherwise.
+ * @example
+ *     if (validate_display(&config, "[display]", error, size) != 0) { ... }
+ */
+static int validate_display(const Config *config, const char *where, char *error, size_t error_size)
+{
+    const char *key = NULL;
+    if (config->display_width <= 0 || config->display_height <= 0) key = "width/height";
+    else if (config->lcd_brightness < 0 || config->lcd_brightness > 100) key = "brightness (0-100)";
+    else if (config->lcd_orientation % 90 != 0 || config->lcd_orientation < 0 || config->lcd_orientation > 270) key = "orientation (0, 90, 180, 270)";
+    else if (!config->font_face[0]) key = "face";
+    else if (config->font_size_temp <= 0.0f || config->font_size_labels <= 0.0f) key = "size_temp/size_labels";
+    if (!key) return 0;
+    snprintf(error, error_size, "invalid %s in %s", key, where);
+    return -1;
+}
+
+/**
+ * @brief Check a configuration before it replaces the running one.
+ * @details Rejects values the renderer or the LCD upload cannot handle: empty daemon address, non-positive refresh interval, out-of-range brightness or orientation, empty font face and unordered temperature thresholds. The effective configuration of every [device.*] section is checked as well. Returns 0 if valid, -1 otherwise with a message in error.
+ * @example
+ *     char error[128];
+ *     if (config_validate(&config, error, sizeof(error)) != 0) {
+ *         // keep the previous configuration
+ *     }
+ */
+int config_validate(const Config *config, char *error, size_t error_size)
+{
+    if (!config || !error || error_size == 0) return -1;
+    error[0] = '\0';
+    if (!config->daemon_address[0]) {
+        snprintf(error, error_size, "missing address in [daemon]");
+        return -1;
+    }
+    if (config->display_refresh_interval_sec < 0 || config->display_refresh_interval_nsec < 0 ||
+        config->display_refresh_interval_nsec >= 1000000000 ||
+        (config->display_refresh_interval_sec == 0 && config->display_refresh_interval_nsec == 0)) {
+        snprintf(error, error_size, "invalid refresh_interval_sec/refresh_interval_nsec in [display]");
+        return -1;
+    }
+    if (config->temp_threshold_green > config->temp_threshold_orange || config->temp_threshold_orange > config->temp_threshold_red) {
+        snprintf(error, error_size, "temperature thresholds in [temperature] must be ascending");
+        return -1;
+    }
+    if (validate_display(config, "[display]", error, error_size) != 0) return -1;
+    for (int i = 0; i < config->device_count; ++i) {
+        static Config effective; // Large; avoid the stack
+        char where[48];
+        snprintf(where, sizeof(where), "[device.%.31s]", config->devices[i].label);
+        if (config_for_device(config, &config->devices[i], &effective) != 0 ||
+            validate_display(&effective, where, error, error_size) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
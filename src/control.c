@@ -0,0 +1,202 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Local control socket implementation.
+ * @details Listening socket and client connections are non-blocking event loop sources, so a slow or idle client never stalls rendering. Each client gets a fixed line buffer; a command is executed on newline or end of input.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable strnlen(), lstat() and MSG_NOSIGNAL
+#define _POSIX_C_SOURCE 200809L
+
+// Maximum concurrent client connections
+#define CONTROL_MAX_CLIENTS 4
+
+// Maximum command line length (including terminator)
+#define CONTROL_LINE_SIZE 256
+
+// Include project headers
+#include "../include/control.h"
+#include "../include/event_loop.h"
+
+// Include necessary headers
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+/**
+ * @brief One client connection.
+ * @details fd is -1 for a free slot.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int fd;                       // Client socket (-1 = free)
+    char line[CONTROL_LINE_SIZE]; // Command received so far
+    size_t len;                   // Bytes in line
+} control_client_t;
+
+static int listen_fd = -1;
+static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+static control_command_fn command_handler = NULL;
+static control_client_t clients[CONTROL_MAX_CLIENTS];
+
+/**
+ * @brief Close one client connection.
+ * @details Unregisters it from the event loop and frees the slot.
+ * @example
+ *     close_client(client);
+ */
+static void close_client(control_client_t *client) {
+    if (client->fd < 0) return;
+    event_loop_remove(client->fd);
+    close(client->fd);
+    client->fd = -1;
+    client->len = 0;
+}
+
+/**
+ * @brief Execute the received command and send the reply.
+ * @details Strips trailing whitespace, calls the command handler and closes the connection. The reply fits the socket buffer, so a single send() is enough.
+ * @example
+ *     run_command(client);
+ */
+static void run_command(control_client_t *client) {
+    static char reply[CONTROL_REPLY_SIZE];
+    client->line[client->len] = '\0';
+    while (client->len > 0 && (client->line[client->len - 1] == '\n' || client->line[client->len - 1] == '\r' ||
+                               client->line[client->len - 1] == ' ')) {
+        client->line[--client->len] = '\0';
+    }
+    reply[0] = '\0';
+    command_handler(client->line, reply, sizeof(reply));
+    size_t reply_len = strnlen(reply, sizeof(reply));
+    if (reply_len > 0 && send(client->fd, reply, reply_len, MSG_NOSIGNAL) < 0) {
+        fprintf(stderr, "[CoolerDash] Warning: Could not send control reply: %s\n", strerror(errno));
+    }
+    close_client(client);
+}
+
+/**
+ * @brief Event loop handler of a client connection.
+ * @details Appends input to the line buffer and runs the command on newline or end of input. Overlong commands are rejected.
+ * @example
+ *     // Not intended for direct use; registered by on_accept().
+ */
+static void on_client(int fd, uint32_t events, void *user) {
+    (void)events;
+    control_client_t *client = user;
+    ssize_t n = recv(fd, client->line + client->len, sizeof(client->line) - 1 - client->len, 0);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) close_client(client);
+        return;
+    }
+    client->len += (size_t)n;
+    if (n == 0 || memchr(client->line, '\n', client->len)) {
+        char *newline = memchr(client->line, '\n', client->len);
+        if (newline) client->len = (size_t)(newline - client->line);
+        run_command(client);
+    } else if (client->len >= sizeof(client->line) - 1) {
+        static const char error[] = "error: command too long\n";
+        send(fd, error, sizeof(error) - 1, MSG_NOSIGNAL);
+        close_client(client);
+    }
+}
+
+/**
+ * @brief Event loop handler of the listening socket.
+ * @details Accepts one connection per wakeup; connections beyond CONTROL_MAX_CLIENTS are closed immediately.
+ * @example
+ *     // Not intended for direct use; registered by control_open().
+ */
+static void on_accept(int fd, uint32_t events, void *user) {
+    (void)events;
+    (void)user;
+    int client_fd = accept(fd, NULL, NULL);
+    if (client_fd < 0) return;
+    fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL) | O_NONBLOCK);
+    fcntl(client_fd, F_SETFD, FD_CLOEXEC);
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; ++i) {
+        if (clients[i].fd >= 0) continue;
+        clients[i].fd = client_fd;
+        clients[i].len = 0;
+        if (!event_loop_add(client_fd, on_client, &clients[i])) close_client(&clients[i]);
+        return;
+    }
+    close(client_fd); // Too many clients
+}
+
+/**
+ * @brief Create the control socket and register it with the event loop.
+ * @details Replaces a stale socket file at path. Requires event_loop_init(). Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!control_open(config.control_socket, on_command)) { ... }
+ */
+int control_open(const char *path, control_command_fn on_command) {
+    if (listen_fd >= 0 || !path || !path[0] || !on_command) return 0;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) return 0;
+    strcpy(addr.sun_path, path);
+
+    // Only replace a socket file; never delete anything else at the configured path
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "[CoolerDash] Error: %s exists and is not a socket\n", path);
+            return 0;
+        }
+        unlink(path);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return 0;
+    mode_t old_mask = umask(0177); // Socket file mode 0600: owner only
+    int bound = bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    umask(old_mask);
+    if (!bound || listen(fd, CONTROL_MAX_CLIENTS) != 0) {
+        fprintf(stderr, "[CoolerDash] Error: Could not create control socket %s: %s\n", path, strerror(errno));
+        close(fd);
+        return 0;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; ++i) clients[i].fd = -1;
+    if (!event_loop_add(fd, on_accept, NULL)) {
+        close(fd);
+        unlink(path);
+        return 0;
+    }
+    listen_fd = fd;
+    command_handler = on_command;
+    snprintf(socket_path, sizeof(socket_path), "%s", path);
+    return 1;
+}
+
+/**
+ * @brief Close the control socket and all client connections.
+ * @details Removes the socket file. No-op if the socket is not open.
+ * @example
+ *     control_close();
+ */
+void control_close(void) {
+    if (listen_fd < 0) return;
+    for (int i = 0; i < CONTROL_MAX_CLIENTS; ++i) close_client(&clients[i]);
+    event_loop_remove(listen_fd);
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path);
+    command_handler = NULL;
+}
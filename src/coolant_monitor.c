@@ -8,7 +8,7 @@
 
 /**
  * @brief Coolant temperature monitoring implementation for CoolerDash.
- * @details Implements functions for reading coolant temperature from system sensors and handling sensor path detection.
+ * @details Implements functions for reading coolant temperature from system sensors and handling sensor lookup.
  * @example
  *     See function documentation for usage examples.
  */
@@ -16,74 +16,36 @@
 // Include project headers
 #include "../include/coolant_monitor.h"
 #include "../include/config.h"
-
-// Include necessary headers
-#include <stdio.h>
-#include <string.h>
-#include <dirent.h>
-#include <stdlib.h>
+#include "../include/sensors.h"
 
 /**
- * @brief Cached path to coolant temperature sensor file.
- * @details Set by init_coolant_sensor_path() and used by read_coolant_temp().
+ * @brief Registry index of the coolant temperature sensor.
+ * @details Set by init_coolant_sensor_path() and used by read_coolant_temp(). -1 if no coolant sensor was found.
  * @example
  *     // Not intended for direct use; managed by module functions.
  */
-char coolant_temp_path[512] = {0}; // Holds the detected sensor file path for coolant temperature
+static int coolant_sensor_index = -1;
 
 /**
- * @brief Initializes the hwmon sensor path for coolant temperature at startup (once).
- * @details Detects and sets the path to the coolant temperature sensor file by scanning available hwmon entries. Uses the hwmon_path from the configuration struct.
+ * @brief Initializes the coolant temperature sensor lookup at startup (once).
+ * @details Ensures the shared hwmon registry is populated, looks up the first temperature input whose label contains "coolant" (case-insensitive) and watches it, so the sampler reads it.
  * @example
  *     init_coolant_sensor_path(&config);
  */
 void init_coolant_sensor_path(const Config *config) {
-    DIR *dir = opendir(config->hwmon_path);
-    if (!dir) return;
-    
-    struct dirent *entry;
-    char label_path[512], label[64];
-    
-    while ((entry = readdir(dir)) != NULL) {
-        if (entry->d_name[0] == '.') continue;
-        
-        for (int i = 1; i <= 9; ++i) {
-            snprintf(label_path, sizeof(label_path), "%s/%s/temp%d_label", config->hwmon_path, entry->d_name, i);
-            FILE *flabel = fopen(label_path, "r");
-            if (!flabel) continue;
-            
-            if (fgets(label, sizeof(label), flabel)) {
-                // Cache coolant temperature path
-                if ((strstr(label, "Coolant") || strstr(label, "coolant")) && strlen(coolant_temp_path) == 0) {
-                    snprintf(coolant_temp_path, sizeof(coolant_temp_path), "%s/%s/temp%d_input", config->hwmon_path, entry->d_name, i);
-                    fclose(flabel);
-                    closedir(dir);
-                    return;
-                }
-            }
-            fclose(flabel);
-        }
-    }
-    closedir(dir);
+    sensors_init(config);
+    coolant_sensor_index = sensors_find(SENSOR_KIND_TEMP, "coolant");
+    sensors_watch(coolant_sensor_index);
 }
 
 /**
- * @brief Reads coolant temperature from cached hwmon path.
- * @details Reads the temperature from the coolant sensor file set by init_coolant_sensor_path().
+ * @brief Reads coolant temperature from the hwmon registry.
+ * @details Reads the coolant sensor through its persistent descriptor (single pread()).
  * @example
  *     float temp = read_coolant_temp();
  */
 float read_coolant_temp(void) {
-    if (strlen(coolant_temp_path) == 0) return 0.0f;
-    
-    FILE *finput = fopen(coolant_temp_path, "r");
-    if (!finput) return 0.0f;
-    
-    int t = 0;
-    float temp = 0.0f;
-    if (fscanf(finput, "%d", &t) == 1) {
-        temp = t > 200 ? t / 1000.0f : (float)t;
-    }
-    fclose(finput);
-    return temp;
+    long t = 0;
+    if (coolant_sensor_index < 0 || !sensors_read(coolant_sensor_index, &t)) return 0.0f;
+    return sensors_temp_celsius(t);
 }
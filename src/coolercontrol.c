@@ -13,53 +13,59 @@
  *     See function documentation for usage examples.
  */
 
+// Enable clock_gettime()
+#define _POSIX_C_SOURCE 200809L
+
 // Buffer size constants
-#define CC_UID_SIZE      128
-#define CC_NAME_SIZE     128
-#define CC_COOKIE_SIZE   256
-#define CC_URL_SIZE      256
+#define CC_URL_SIZE      512
 #define CC_USERPWD_SIZE  128
-#define CC_DEVICE_SECTION_SIZE 4096
+
+// Key path tracked while parsing /devices (root, devices[], device, info, channels, <channel>, lcd_info)
+#define CC_JSON_PATH_DEPTH 8
+#define CC_JSON_KEY_SIZE   32
+
+// Filename reported for in-memory image uploads
+#define CC_IMAGE_FILENAME "coolerdash.png"
+
+// TCP keep-alive timing (seconds)
+#define CC_KEEPALIVE_IDLE     30
+#define CC_KEEPALIVE_INTERVAL 10
+
+// Image delivery retry policy
+#define CC_DELIVERY_MAX_ATTEMPTS   3    // Total attempts per image
+#define CC_DELIVERY_BACKOFF_MS     100  // Delay before the first retry
+#define CC_DELIVERY_BACKOFF_MAX_MS 1000 // Upper bound for the doubled delay
+
+// Circuit breaker: consecutive failed deliveries that mark the daemon as down, health probe backoff
+#define CC_BREAKER_THRESHOLD      3
+#define CC_BREAKER_PROBE_MS       1000  // Delay before the first health probe
+#define CC_BREAKER_PROBE_MAX_MS   30000 // Upper bound for the doubled probe delay
+
+// Request deadlines: one refresh interval, clamped to these bounds
+#define CC_TIMEOUT_MIN_MS     500   // Floor for very short refresh intervals
+#define CC_TIMEOUT_MAX_MS     10000 // Ceiling for very long refresh intervals
+#define CC_CONNECT_TIMEOUT_MS 1000  // Upper bound for connection setup
 
 // Include project headers
 #include "../include/coolercontrol.h"
 #include "../include/config.h"
+#include "../include/http_engine.h"
+#include "../include/json_stream.h"
 
 // Include necessary headers
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <time.h>
 #include <sys/stat.h>
 #include <curl/curl.h>
 
-/**
- * @brief Response buffer structure for HTTP responses.
- * @details Used to store dynamically allocated HTTP response data and its size for cURL operations.
- * @example
- *     struct http_response resp = {0};
- *     resp.data = malloc(1);
- *     resp.size = 0;
- *     // Use with cURL: curl_easy_setopt(curl, CURLOPT_WRITEDATA, &resp);
- */
-struct http_response {
-    char *data;
-    size_t size;
-};
-
-/**
- * @brief Callback function to write HTTP response data.
- * @details Writes received HTTP response data into a dynamically growing buffer.
- * @example
- *     struct http_response resp = {0};
- *     resp.data = malloc(1);
- *     resp.size = 0;
- *     // ...
- *     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
- *     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &resp);
- */
 int init_coolercontrol_session(const Config *config);
 int send_image_to_lcd(const Config *config, const char* image_path, const char* device_uid);
+int send_image_data_to_lcd(const Config *config, const unsigned char* image_data, size_t image_size, const char* device_uid);
+int submit_image_data_to_lcd(const Config *config, const unsigned char* image_data, size_t image_size, const char* device_uid, lcd_delivery_done_fn on_done, void *user);
 int upload_image_to_device(const Config *config, const char* image_path, const char* device_uid);
 void cleanup_coolercontrol_session(void);
 int is_session_initialized(void);
@@ -67,78 +73,297 @@ int get_device_name(const Config *config, char* name_buffer, size_t buffer_size)
 int get_device_uid(const Config *config, char* uid_buffer, size_t buffer_size);
 int init_cached_device_uid(const Config *config);
 
-static size_t write_callback(void *contents, size_t size, size_t nmemb, struct http_response *response) {
-    size_t realsize = size * nmemb;
-    char *ptr = realloc(response->data, response->size + realsize + 1);
-    if (!ptr) {
-        fprintf(stderr, "[CoolerDash] Error: realloc failed for response->data\n");
-        if (response->data) {
-            free(response->data);
-            response->data = NULL;
-        }
-        return 0;  // Out of memory
-    }
-    response->data = ptr;
-    memcpy(&(response->data[response->size]), contents, realsize);
-    response->size += realsize;
-    response->data[response->size] = 0;  // Null-terminate
-    return realsize;
-}
-
 /**
  * @brief Session state struct for CoolerControl API.
- * @details Encapsulates all internal session variables (cURL handle, cookie jar, session state, cached UID) for safe and modular access. Avoids global variables and improves maintainability.
+ * @details Encapsulates all internal session variables (cURL handles, session state, cached UID) for safe and modular access. Avoids global variables and improves maintainability. curl_handle carries device discovery and auth_handle carries the login, so a re-login can run while uploads wait for their replay. probe_handle polls /health while the circuit breaker is open. Image uploads use one handle per device (see lcd_delivery_t). The session cookie lives only in the HTTP engine's shared in-memory cookie store.
  * @example
  *     static CoolerControlSession cc_session = {0};
  */
 typedef struct {
     CURL *curl_handle;
-    char cookie_jar[CC_COOKIE_SIZE];
+    CURL *auth_handle;
+    CURL *probe_handle;          // Health probes while the daemon is down
+    const Config *config;        // Configuration the session was created with
     int session_initialized;
     char cached_device_uid[CC_UID_SIZE];
+    cc_device_t *devices;        // Device index from /devices, replaced by the engine thread
+    size_t device_count;
+    pthread_mutex_t index_lock;  // Guards devices/device_count against readers on other threads
+    struct curl_slist *upload_headers; // Extra headers of all upload handles
 } CoolerControlSession;
 
 static CoolerControlSession cc_session = {
     .curl_handle = NULL,
-    .cookie_jar = {0},
+    .auth_handle = NULL,
+    .probe_handle = NULL,
+    .config = NULL,
     .session_initialized = 0,
-    .cached_device_uid = {0}
+    .cached_device_uid = {0},
+    .devices = NULL,
+    .device_count = 0,
+    .index_lock = PTHREAD_MUTEX_INITIALIZER,
+    .upload_headers = NULL
 };
 
 /**
- * @brief Initializes cURL and authenticates with the CoolerControl daemon using configuration.
- * @details Sets up the cURL handle and logs in to the CoolerControl daemon using basic authentication.
+ * @brief Cached multipart form for in-memory image uploads.
+ * @details The mode, brightness and orientation parts are built once; only the images[] payload is swapped per frame through curl_mime_data_cb(), reading directly from the caller's buffer. Rebuilt only when brightness or orientation change.
  * @example
- *     if (!init_coolercontrol_session(&config)) {
- *         // handle error
- *     }
+ *     // Not intended for direct use; managed by prepare_form_template().
  */
-int init_coolercontrol_session(const Config *config) {
-    curl_global_init(CURL_GLOBAL_DEFAULT); 
-    cc_session.curl_handle = curl_easy_init();
-    if (!cc_session.curl_handle) return 0;
-    int written_cookie = snprintf(cc_session.cookie_jar, sizeof(cc_session.cookie_jar), "/tmp/lcd_cookie_%d.txt", getpid());
-    if (written_cookie < 0 || (size_t)written_cookie >= sizeof(cc_session.cookie_jar)) cc_session.cookie_jar[sizeof(cc_session.cookie_jar)-1] = '\0';
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_COOKIEJAR, cc_session.cookie_jar);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_COOKIEFILE, cc_session.cookie_jar);
+typedef struct {
+    curl_mime *form;            // mode, brightness, orientation, images[]
+    curl_mimepart *image_part;  // images[] part whose payload is swapped per frame
+    int brightness;             // lcd_brightness the form was built with
+    int orientation;            // lcd_orientation the form was built with
+    const unsigned char *data;  // Current payload (owned by the caller)
+    size_t size;                // Payload size in bytes
+    size_t offset;              // Read position within the payload
+} lcd_form_template_t;
+
+/**
+ * @brief Upload channel of one LCD device.
+ * @details Each device has its own PUT handle, cached form and delivery state, so uploads to different devices run concurrently on the HTTP engine. At most one image per device is in flight. The form is kept across retries; a one-off form is freed when the delivery finishes.
+ * @example
+ *     // Not intended for direct use; managed by delivery_for() and start_lcd_delivery().
+ */
+typedef struct {
+    char device_uid[CC_UID_SIZE];    // Target device ("" = unused slot)
+    char lcd_channel[CC_CHANNEL_SIZE]; // LCD channel name used in the upload URL
+    CURL *upload_handle;             // PUT handle of this device
+    int url_set;                     // 1 once upload_handle carries the URL for lcd_channel
+    lcd_form_template_t form_template; // Cached form bound to upload_handle
+    http_request_t request;          // Engine request on upload_handle
+    curl_mime *owned_form;           // One-off form for file uploads (NULL when the template is used)
+    int busy;                        // 1 while a delivery (including retries) is in progress
+    int attempt;                     // Attempt number of the current send (1-based)
+    int reauthenticated;             // 1 once this delivery triggered a re-login
+    int waiting_for_login;           // 1 while the delivery waits for auth_request
+    int failing;                     // 1 while consecutive deliveries fail (for log transitions)
+    long backoff_ms;                 // Delay before the next retry
+    long long deadline_ms;           // Monotonic time at which the delivery is abandoned
+    lcd_delivery_done_fn on_done;    // Caller completion callback
+    void *user;                      // Caller context for on_done
+} lcd_delivery_t;
+
+static lcd_delivery_t deliveries[CONFIG_MAX_DEVICES];
+static http_request_t auth_request = {0}; // Asynchronous re-login on cc_session.auth_handle
+static int auth_in_flight = 0;            // 1 while auth_request is submitted
+static void reauth_done(http_request_t *req, CURLcode result, long response_code);
+static void link_delivery_finished(int success, long response_code);
+static void link_login_finished(int ok);
+static int link_is_up(void);
+static void link_init(void);
+static void link_cleanup(void);
+static lcd_delivery_stats_t delivery_stats = {0}; // Updated and copied with __atomic builtins (engine and caller threads)
+
+// HTTP timing telemetry; recorded on the engine thread, copied out under timing_lock
+static cc_endpoint_timing_t endpoint_timing[CC_ENDPOINT_COUNT];
+static pthread_mutex_t timing_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Record cURL's timing and size information of a finished request.
+ * @details Called from every completion path before the handle is reused. Phase times are only recorded for requests that completed at the transport level, so timeouts do not distort the phase histograms.
+ * @example
+ *     record_timing(CC_ENDPOINT_IMAGES, req->easy, result, response_code);
+ */
+static void record_timing(cc_endpoint_t endpoint, CURL *easy, CURLcode result, long response_code) {
+    static const CURLINFO phase_info[] = {
+        CURLINFO_NAMELOOKUP_TIME_T, CURLINFO_CONNECT_TIME_T, CURLINFO_PRETRANSFER_TIME_T,
+        CURLINFO_STARTTRANSFER_TIME_T, CURLINFO_TOTAL_TIME_T
+    };
+    curl_off_t phases[CC_PHASE_COUNT] = {0};
+    for (int i = 0; i < CC_PHASE_WAIT; ++i) {
+        curl_easy_getinfo(easy, phase_info[i], &phases[i]);
+        if (phases[i] < 0) phases[i] = 0;
+    }
+    // Time after the request was sent; older cURL versions cannot tell when the body was sent
+    curl_off_t sent_at = phases[CC_PHASE_PRETRANSFER];
+#if LIBCURL_VERSION_NUM >= 0x080a00
+    curl_off_t posttransfer = 0;
+    if (curl_easy_getinfo(easy, CURLINFO_POSTTRANSFER_TIME_T, &posttransfer) == CURLE_OK && posttransfer > sent_at) {
+        sent_at = posttransfer;
+    }
+#endif
+    if (phases[CC_PHASE_TOTAL] > sent_at) phases[CC_PHASE_WAIT] = phases[CC_PHASE_TOTAL] - sent_at;
+    curl_off_t sent = 0;
+    curl_easy_getinfo(easy, CURLINFO_SIZE_UPLOAD_T, &sent);
+    int status_class = result == CURLE_OK && response_code >= 100 && response_code < 600 ? (int)(response_code / 100) : 0;
+
+    cc_endpoint_timing_t *timing = &endpoint_timing[endpoint];
+    pthread_mutex_lock(&timing_lock);
+    timing->status[status_class]++;
+    if (result == CURLE_OK) {
+        for (int i = 0; i < CC_PHASE_COUNT; ++i) histogram_record(&timing->phases[i], (uint64_t)phases[i]);
+        histogram_record(&timing->bytes_sent, sent > 0 ? (uint64_t)sent : 0);
+    }
+    pthread_mutex_unlock(&timing_lock);
+}
+
+/**
+ * @brief Perform a request and record its timing (blocking).
+ * @details Wrapper around http_engine_perform() for the login and discovery requests.
+ * @example
+ *     CURLcode res = perform_timed(CC_ENDPOINT_DEVICES, cc_session.curl_handle, &code);
+ */
+static CURLcode perform_timed(cc_endpoint_t endpoint, CURL *easy, long *response_code) {
+    CURLcode res = http_engine_perform(easy, response_code);
+    record_timing(endpoint, easy, res, *response_code);
+    return res;
+}
+
+/**
+ * @brief Get current CLOCK_MONOTONIC time in milliseconds.
+ * @details Used for delivery deadlines.
+ * @example
+ *     long long now = monotonic_ms();
+ */
+static long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Return the time budget of one request.
+ * @details One refresh interval: a frame that is not delivered before the next one is rendered is worthless. Clamped to [CC_TIMEOUT_MIN_MS, CC_TIMEOUT_MAX_MS].
+ * @example
+ *     long budget = request_budget_ms(config);
+ */
+static long request_budget_ms(const Config *config) {
+    long long ms = (long long)config->display_refresh_interval_sec * 1000 + config->display_refresh_interval_nsec / 1000000;
+    if (ms < CC_TIMEOUT_MIN_MS) ms = CC_TIMEOUT_MIN_MS;
+    if (ms > CC_TIMEOUT_MAX_MS) ms = CC_TIMEOUT_MAX_MS;
+    return (long)ms;
+}
+
+/**
+ * @brief cURL write callback that drops the response body.
+ * @details Default for every handle: only the status code of login, upload and health responses matters. A NULL write function would make cURL print error bodies to stdout.
+ * @example
+ *     curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, discard_body);
+ */
+static size_t discard_body(char *contents, size_t size, size_t nmemb, void *user) {
+    (void)contents;
+    (void)user;
+    return size * nmemb;
+}
+
+/**
+ * @brief Apply the request deadlines derived from the refresh interval to an easy handle.
+ * @details The whole request is bounded by one budget (see request_budget_ms()) and connection setup by CC_CONNECT_TIMEOUT_MS within it.
+ * @example
+ *     apply_timeouts(easy, config);
+ */
+static void apply_timeouts(CURL *easy, const Config *config) {
+    // Bounded requests: a hung daemon can never block the caller for more than one budget
+    long budget_ms = request_budget_ms(config);
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, budget_ms);
+    curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT_MS, budget_ms < CC_CONNECT_TIMEOUT_MS ? budget_ms : (long)CC_CONNECT_TIMEOUT_MS);
+}
+
+/**
+ * @brief Apply the transport options to an easy handle.
+ * @details Response bodies are discarded unless a request installs its own write callback, and requests are bounded by apply_timeouts(). With daemon_socket set, requests go over that Unix domain socket. Otherwise the TCP connection gets keep-alive probes and TCP_NODELAY so the persistent connection survives idle periods and small uploads are not delayed by Nagle.
+ * @example
+ *     apply_transport_options(cc_session.curl_handle, config);
+ */
+static void apply_transport_options(CURL *easy, const Config *config) {
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, discard_body);
+    apply_timeouts(easy, config);
+    if (config->daemon_socket[0]) {
+        curl_easy_setopt(easy, CURLOPT_UNIX_SOCKET_PATH, config->daemon_socket);
+        return;
+    }
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPIDLE, (long)CC_KEEPALIVE_IDLE);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPINTVL, (long)CC_KEEPALIVE_INTERVAL);
+    curl_easy_setopt(easy, CURLOPT_TCP_NODELAY, 1L);
+}
+
+/**
+ * @brief Configure the login request on the auth handle.
+ * @details POST /login with basic authentication; the response body is ignored. Set once, so a re-login only has to resubmit the handle.
+ * @example
+ *     configure_login(config);
+ */
+static void configure_login(const Config *config) {
     char login_url[CC_URL_SIZE];
     int written_url = snprintf(login_url, sizeof(login_url), "%s/login", config->daemon_address);
     if (written_url < 0 || (size_t)written_url >= sizeof(login_url)) login_url[sizeof(login_url)-1] = '\0';
     char userpwd[CC_USERPWD_SIZE];
     int written_pwd = snprintf(userpwd, sizeof(userpwd), "CCAdmin:%s", config->daemon_password);
     if (written_pwd < 0 || (size_t)written_pwd >= sizeof(userpwd)) userpwd[sizeof(userpwd)-1] = '\0';
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_URL, login_url);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_USERPWD, userpwd);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_POST, 1L);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_POSTFIELDS, "");
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEFUNCTION, NULL); // Ignore response
-    
-    CURLcode res = curl_easy_perform(cc_session.curl_handle);
+    curl_easy_setopt(cc_session.auth_handle, CURLOPT_URL, login_url);
+    curl_easy_setopt(cc_session.auth_handle, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
+    curl_easy_setopt(cc_session.auth_handle, CURLOPT_USERPWD, userpwd);
+    curl_easy_setopt(cc_session.auth_handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(cc_session.auth_handle, CURLOPT_POSTFIELDS, "");
+}
+
+/**
+ * @brief Prepare probe_handle for the unauthenticated /health endpoint.
+ * @details The endpoint is cheap for the daemon and needs no session, so it can be polled while the daemon is starting up.
+ * @example
+ *     configure_probe(config);
+ */
+static void configure_probe(const Config *config) {
+    char health_url[CC_URL_SIZE];
+    snprintf(health_url, sizeof(health_url), "%.*s/health", (int)(sizeof(health_url) - 8), config->daemon_address);
+    curl_easy_setopt(cc_session.probe_handle, CURLOPT_URL, health_url);
+    curl_easy_setopt(cc_session.probe_handle, CURLOPT_HTTPGET, 1L);
+}
+
+/**
+ * @brief Check whether a login response was accepted.
+ * @details The daemon answers a successful login with 200 or 204.
+ * @example
+ *     if (login_succeeded(res, code)) { ... }
+ */
+static int login_succeeded(CURLcode result, long response_code) {
+    return result == CURLE_OK && (response_code == 200 || response_code == 204);
+}
+
+/**
+ * @brief Log in to the daemon and wait for the result (blocking).
+ * @details Stores the new session cookie in the shared cookie store. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!session_login()) { ... }
+ */
+static int session_login(void) {
     long response_code = 0;
-    curl_easy_getinfo(cc_session.curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
+    CURLcode res = perform_timed(CC_ENDPOINT_LOGIN, cc_session.auth_handle, &response_code);
+    return login_succeeded(res, response_code);
+}
+
+/**
+ * @brief Initializes cURL and authenticates with the CoolerControl daemon using configuration.
+ * @details Sets up the HTTP engine and cURL handles and logs in to the CoolerControl daemon using basic authentication. The session cookie is kept in memory only; nothing is written to disk.
+ * @example
+ *     if (!init_coolercontrol_session(&config)) {
+ *         // handle error
+ *     }
+ */
+int init_coolercontrol_session(const Config *config) {
+    curl_global_init(CURL_GLOBAL_DEFAULT); 
+    if (!http_engine_init()) return 0;
+    cc_session.curl_handle = http_engine_easy();
+    cc_session.auth_handle = http_engine_easy();
+    cc_session.probe_handle = http_engine_easy();
+    if (!cc_session.curl_handle || !cc_session.auth_handle || !cc_session.probe_handle) return 0;
+    CURL *handles[] = { cc_session.curl_handle, cc_session.auth_handle, cc_session.probe_handle };
+    for (size_t i = 0; i < sizeof(handles) / sizeof(handles[0]); ++i) {
+        apply_transport_options(handles[i], config);
+        curl_easy_setopt(handles[i], CURLOPT_COOKIEFILE, ""); // Enable the in-memory cookie engine
+    }
+    configure_login(config);
+    configure_probe(config);
+    cc_session.config = config;
+    auth_request.easy = cc_session.auth_handle;
+    auth_request.done = reauth_done;
+    link_init();
     
-    if (res == CURLE_OK && (response_code == 200 || response_code == 204)) {
+    if (session_login()) {
         cc_session.session_initialized = 1;
         return 1;
     }
@@ -147,24 +372,19 @@ int init_coolercontrol_session(const Config *config) {
 }
 
 /**
- * @brief Sends an image directly to the LCD of the CoolerControl device.
- * @details Uploads an image to the LCD display using a multipart HTTP PUT request.
+ * @brief Build the multipart form for one LCD image upload.
+ * @details Adds mode, brightness, orientation and images[]. With image_path the file is streamed by cURL; without it the images[] part is left without payload for prepare_form_template() to fill. Stores the images[] part in *image_part. Returns NULL on failure.
  * @example
- *     send_image_to_lcd(&config, "/opt/coolerdash/images/coolerdash.png", uid);
+ *     curl_mimepart *image_part;
+ *     curl_mime *form = build_lcd_form(d->upload_handle, config, NULL, &image_part);
  */
-int send_image_to_lcd(const Config *config, const char* image_path, const char* device_uid) {
-    if (!cc_session.curl_handle || !image_path || !device_uid || !cc_session.session_initialized) return 0;
-
-    // URL for LCD image upload
-    char upload_url[CC_URL_SIZE];
-    snprintf(upload_url, sizeof(upload_url), 
-             "%s/devices/%s/settings/lcd/lcd/images", config->daemon_address, device_uid);
-    
+static curl_mime *build_lcd_form(CURL *easy, const Config *config, const char* image_path, curl_mimepart **image_part) {
     // Determine MIME type
     const char* mime_type = "image/png";
 
     // Create multipart form
-    curl_mime *form = curl_mime_init(cc_session.curl_handle);
+    curl_mime *form = curl_mime_init(easy);
+    if (!form) return NULL;
     curl_mimepart *field;
     
     // mode field
@@ -189,26 +409,448 @@ int send_image_to_lcd(const Config *config, const char* image_path, const char*
     // images[] field (the actual image)
     field = curl_mime_addpart(form);
     curl_mime_name(field, "images[]");
-    curl_mime_filedata(field, image_path);
+    if (image_path) {
+        curl_mime_filedata(field, image_path);
+    } else {
+        curl_mime_filename(field, CC_IMAGE_FILENAME);
+    }
     curl_mime_type(field, mime_type);
-    
-    // Configure cURL
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_URL, upload_url);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_MIMEPOST, form);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_CUSTOMREQUEST, "PUT");
-    
-    // Execute request
-    CURLcode res = curl_easy_perform(cc_session.curl_handle);
-    long response_code = 0;
-    curl_easy_getinfo(cc_session.curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
-    
-    // Cleanup
-    curl_mime_free(form);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_MIMEPOST, NULL);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_CUSTOMREQUEST, NULL);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEFUNCTION, NULL);
-    
-    return (res == CURLE_OK && response_code == 200);
+    if (image_part) *image_part = field;
+    return form;
+}
+
+/**
+ * @brief cURL read callback for the images[] payload.
+ * @details Copies the next chunk of the caller's PNG buffer into cURL's upload buffer.
+ * @example
+ *     // Registered with curl_mime_data_cb().
+ */
+static size_t payload_read(char *buffer, size_t size, size_t nitems, void *arg) {
+    lcd_form_template_t *tpl = arg;
+    size_t remaining = tpl->size - tpl->offset;
+    size_t n = size * nitems < remaining ? size * nitems : remaining;
+    memcpy(buffer, tpl->data + tpl->offset, n);
+    tpl->offset += n;
+    return n;
+}
+
+/**
+ * @brief cURL seek callback for the images[] payload.
+ * @details Lets cURL rewind the payload, e.g. when a retry resends the same form.
+ * @example
+ *     // Registered with curl_mime_data_cb().
+ */
+static int payload_seek(void *arg, curl_off_t offset, int origin) {
+    lcd_form_template_t *tpl = arg;
+    curl_off_t base = origin == SEEK_CUR ? (curl_off_t)tpl->offset : origin == SEEK_END ? (curl_off_t)tpl->size : 0;
+    curl_off_t target = base + offset;
+    if (target < 0 || target > (curl_off_t)tpl->size) return CURL_SEEKFUNC_FAIL;
+    tpl->offset = (size_t)target;
+    return CURL_SEEKFUNC_OK;
+}
+
+/**
+ * @brief Unbind and free the cached multipart form of a device.
+ * @details The next prepare_form_template() builds and binds a new one.
+ * @example
+ *     release_form_template(d);
+ */
+static void release_form_template(lcd_delivery_t *d) {
+    if (d->form_template.form) {
+        curl_easy_setopt(d->upload_handle, CURLOPT_MIMEPOST, NULL);
+        curl_mime_free(d->form_template.form);
+    }
+    memset(&d->form_template, 0, sizeof(d->form_template));
+}
+
+/**
+ * @brief Unbind and free the one-off form of a file upload.
+ * @details No-op for template deliveries: the template stays bound to the upload handle.
+ * @example
+ *     release_owned_form(d);
+ */
+static void release_owned_form(lcd_delivery_t *d) {
+    if (!d->owned_form) return;
+    curl_easy_setopt(d->upload_handle, CURLOPT_MIMEPOST, NULL);
+    curl_mime_free(d->owned_form);
+    d->owned_form = NULL;
+}
+
+/**
+ * @brief Point the cached form of a device at a new image payload.
+ * @details Builds the form on first use and rebuilds it when brightness or orientation changed; otherwise only the images[] payload source is replaced. The form is bound to the upload handle once, when it is built: cURL only rewinds a bound form between transfers, so re-binding a used form would send an empty body. The payload is not copied and must stay valid until the delivery has finished. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!prepare_form_template(d, config, png, png_size)) return 0;
+ */
+static int prepare_form_template(lcd_delivery_t *d, const Config *config, const unsigned char* image_data, size_t image_size) {
+    lcd_form_template_t *tpl = &d->form_template;
+    if (tpl->form && (tpl->brightness != config->lcd_brightness || tpl->orientation != config->lcd_orientation)) {
+        release_form_template(d);
+    }
+    if (!tpl->form) {
+        tpl->form = build_lcd_form(d->upload_handle, config, NULL, &tpl->image_part);
+        if (!tpl->form) return 0;
+        curl_easy_setopt(d->upload_handle, CURLOPT_MIMEPOST, tpl->form);
+        tpl->brightness = config->lcd_brightness;
+        tpl->orientation = config->lcd_orientation;
+    }
+    tpl->data = image_data;
+    tpl->size = image_size;
+    tpl->offset = 0;
+    if (curl_mime_data_cb(tpl->image_part, (curl_off_t)image_size, payload_read, payload_seek,
+                          NULL, tpl) != CURLE_OK) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Look up the LCD channel name of a device in the index.
+ * @details Falls back to "lcd" if the device or its LCD channel is unknown. Reads the index under the index lock.
+ * @example
+ *     lookup_lcd_channel(uid, d->lcd_channel, sizeof(d->lcd_channel));
+ */
+static void lookup_lcd_channel(const char *device_uid, char *channel, size_t channel_size) {
+    snprintf(channel, channel_size, "lcd");
+    pthread_mutex_lock(&cc_session.index_lock);
+    for (size_t i = 0; i < cc_session.device_count; ++i) {
+        const cc_device_t *dev = &cc_session.devices[i];
+        if (strcmp(dev->uid, device_uid) == 0 && dev->lcd_channel[0]) {
+            snprintf(channel, channel_size, "%s", dev->lcd_channel);
+        }
+    }
+    pthread_mutex_unlock(&cc_session.index_lock);
+}
+
+/**
+ * @brief Return the upload channel of a device, creating it on first use.
+ * @details The LCD channel name for the upload URL is taken from the device index ("lcd" if unknown). Returns NULL if CONFIG_MAX_DEVICES channels are in use or the handle cannot be created.
+ * @example
+ *     lcd_delivery_t *d = delivery_for(config, uid);
+ */
+static lcd_delivery_t *delivery_for(const Config *config, const char *device_uid) {
+    lcd_delivery_t *free_slot = NULL;
+    for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) {
+        if (strcmp(deliveries[i].device_uid, device_uid) == 0) return &deliveries[i];
+        if (!free_slot && !deliveries[i].device_uid[0]) free_slot = &deliveries[i];
+    }
+    if (!free_slot || !device_uid[0]) return NULL;
+    CURL *easy = http_engine_easy();
+    if (!easy) return NULL;
+    apply_transport_options(easy, config);
+    curl_easy_setopt(easy, CURLOPT_COOKIEFILE, ""); // Enable the in-memory cookie engine
+    curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, "PUT");
+    if (!cc_session.upload_headers) {
+        // No "Expect: 100-continue": the daemon accepts every upload, so waiting for the interim reply only costs a round trip
+        cc_session.upload_headers = curl_slist_append(NULL, "Expect:");
+    }
+    curl_easy_setopt(easy, CURLOPT_HTTPHEADER, cc_session.upload_headers);
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->upload_handle = easy;
+    snprintf(free_slot->device_uid, sizeof(free_slot->device_uid), "%s", device_uid);
+    lookup_lcd_channel(device_uid, free_slot->lcd_channel, sizeof(free_slot->lcd_channel));
+    return free_slot;
+}
+
+/**
+ * @brief Finish the current delivery of a device and notify the caller.
+ * @details Updates the counters, logs failure/recovery transitions per device, frees a one-off form and calls on_done.
+ * @example
+ *     finish_lcd_delivery(d, 1);
+ */
+static void finish_lcd_delivery(lcd_delivery_t *d, int success) {
+    long code = __atomic_load_n(&delivery_stats.last_response_code, __ATOMIC_RELAXED);
+    link_delivery_finished(success, code);
+    if (success) {
+        if (__atomic_fetch_add(&delivery_stats.delivered, 1, __ATOMIC_RELAXED) == 0) {
+            __atomic_store_n(&delivery_stats.first_delivered_ms, monotonic_ms(), __ATOMIC_RELAXED);
+        }
+        if (d->failing) {
+            fprintf(stderr, "[CoolerDash] LCD image delivery to %.20s recovered\n", d->device_uid);
+            d->failing = 0;
+        }
+    } else {
+        __atomic_fetch_add(&delivery_stats.failures, 1, __ATOMIC_RELAXED);
+        if (!d->failing) {
+            fprintf(stderr, "[CoolerDash] Warning: LCD image delivery to %.20s failed (HTTP %ld)\n", d->device_uid, code);
+            d->failing = 1;
+        }
+    }
+    release_owned_form(d);
+    d->busy = 0;
+    lcd_delivery_done_fn on_done = d->on_done;
+    void *user = d->user;
+    d->on_done = NULL;
+    d->user = NULL;
+    if (on_done) on_done(success, user);
+}
+
+/**
+ * @brief Abandon the current delivery of a device because its deadline passed.
+ * @details Counted as a missed frame (and as a failure).
+ * @example
+ *     miss_lcd_delivery(d);
+ */
+static void miss_lcd_delivery(lcd_delivery_t *d) {
+    __atomic_fetch_add(&delivery_stats.missed, 1, __ATOMIC_RELAXED);
+    finish_lcd_delivery(d, 0);
+}
+
+/**
+ * @brief Limit the next attempt of a delivery to the time left before its deadline.
+ * @details delay_ms is the backoff before the attempt starts. Returns 1 if the attempt can start in time, 0 if the deadline would pass first.
+ * @example
+ *     if (!arm_attempt(d, 0)) miss_lcd_delivery(d);
+ */
+static int arm_attempt(lcd_delivery_t *d, long delay_ms) {
+    long long remaining = d->deadline_ms - monotonic_ms() - delay_ms;
+    if (remaining <= 0) return 0;
+    curl_easy_setopt(d->upload_handle, CURLOPT_TIMEOUT_MS, (long)remaining);
+    return 1;
+}
+
+/**
+ * @brief Return whether a timed-out attempt never got connected.
+ * @details cURL reports a zero connect time when connection setup did not finish, and no primary IP over TCP (over a Unix socket there is never one). Such an attempt hit CC_CONNECT_TIMEOUT_MS rather than the delivery deadline, so a retry may still fit.
+ * @example
+ *     if (result == CURLE_OPERATION_TIMEDOUT && !connect_timed_out(req->easy)) miss_lcd_delivery(d);
+ */
+static int connect_timed_out(CURL *easy) {
+    curl_off_t connect_us = 0;
+    if (curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &connect_us) == CURLE_OK && connect_us == 0) return 1;
+    if (cc_session.config && cc_session.config->daemon_socket[0]) return 0;
+    char *ip = NULL;
+    return curl_easy_getinfo(easy, CURLINFO_PRIMARY_IP, &ip) == CURLE_OK && (!ip || !ip[0]);
+}
+
+/**
+ * @brief Engine completion callback for the re-login of rejected uploads.
+ * @details On success every upload waiting for the login is replayed once with the new session cookie; otherwise they fail. Also advances a circuit breaker recovery waiting for this login.
+ * @example
+ *     // Not intended for direct use; set as auth_request.done.
+ */
+static void reauth_done(http_request_t *req, CURLcode result, long response_code) {
+    record_timing(CC_ENDPOINT_LOGIN, req->easy, result, response_code);
+    auth_in_flight = 0;
+    int ok = login_succeeded(result, response_code);
+    if (!ok) {
+        __atomic_fetch_add(&delivery_stats.reauth_failures, 1, __ATOMIC_RELAXED);
+        fprintf(stderr, "[CoolerDash] Warning: Re-login to CoolerControl failed (HTTP %ld)\n", result == CURLE_OK ? response_code : 0);
+    }
+    for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) {
+        lcd_delivery_t *d = &deliveries[i];
+        if (!d->waiting_for_login) continue;
+        d->waiting_for_login = 0;
+        if (ok && !arm_attempt(d, 0)) miss_lcd_delivery(d);
+        else if (!ok || !http_engine_submit(&d->request)) finish_lcd_delivery(d, 0);
+    }
+    link_login_finished(ok);
+}
+
+/**
+ * @brief Engine completion callback for image uploads.
+ * @details HTTP 200 is success. A 401/403 means the session expired (e.g. the daemon restarted): the client logs in again and replays the upload once; uploads of other devices rejected meanwhile wait for the same login. Transport errors and 5xx responses are retried up to CC_DELIVERY_MAX_ATTEMPTS with exponential backoff, scheduled on the engine timer instead of sleeping; other 4xx responses are not retried. Every attempt is limited to the delivery deadline; a timeout or a retry that cannot start in time abandons the frame as missed, except a connect timeout, which is retried if the deadline still allows it.
+ * @example
+ *     // Not intended for direct use; set as lcd_delivery_t.request.done.
+ */
+static void lcd_delivery_done(http_request_t *req, CURLcode result, long response_code) {
+    lcd_delivery_t *d = req->user;
+    record_timing(CC_ENDPOINT_IMAGES, req->easy, result, response_code);
+    long code = result == CURLE_OK ? response_code : 0;
+    __atomic_store_n(&delivery_stats.last_response_code, code, __ATOMIC_RELAXED);
+    if (code == 200) {
+        finish_lcd_delivery(d, 1);
+        return;
+    }
+    if (result == CURLE_OPERATION_TIMEDOUT && !connect_timed_out(req->easy)) {
+        miss_lcd_delivery(d); // The attempt used up the deadline; a connect timeout is retried below
+        return;
+    }
+    if ((code == 401 || code == 403) && !d->reauthenticated) {
+        d->reauthenticated = 1;
+        d->waiting_for_login = 1;
+        if (auth_in_flight) return;
+        __atomic_fetch_add(&delivery_stats.reauths, 1, __ATOMIC_RELAXED);
+        if (http_engine_submit(&auth_request)) {
+            auth_in_flight = 1;
+            return;
+        }
+        d->waiting_for_login = 0;
+    }
+    int client_error = code >= 400 && code < 500; // A retry cannot succeed
+    if (!client_error && d->attempt < CC_DELIVERY_MAX_ATTEMPTS) {
+        d->attempt++;
+        __atomic_fetch_add(&delivery_stats.retries, 1, __ATOMIC_RELAXED);
+        long delay_ms = d->backoff_ms;
+        d->backoff_ms = d->backoff_ms * 2 > CC_DELIVERY_BACKOFF_MAX_MS ? CC_DELIVERY_BACKOFF_MAX_MS : d->backoff_ms * 2;
+        if (!arm_attempt(d, delay_ms)) {
+            miss_lcd_delivery(d);
+            return;
+        }
+        if (http_engine_submit_after(req, delay_ms)) return;
+    }
+    finish_lcd_delivery(d, 0);
+}
+
+/**
+ * @brief Start delivering one image to an LCD (asynchronous).
+ * @details The delivery, retries and re-login included, is abandoned after budget_ms. Returns 1 if the delivery was started, 0 if a delivery to the same device is still in progress or the request could not be set up.
+ * @example
+ *     start_lcd_delivery(d, config, NULL, png, png_size, request_budget_ms(config), on_done, NULL);
+ */
+static int start_lcd_delivery(lcd_delivery_t *d, const Config *config, const char* image_path, const unsigned char* image_data, size_t image_size, long budget_ms, lcd_delivery_done_fn on_done, void *user) {
+    if (d->busy) return 0;
+    // File uploads (shutdown image) get a one-off form; frames reuse the cached template
+    if (image_path) {
+        release_form_template(d);
+        d->owned_form = build_lcd_form(d->upload_handle, config, image_path, NULL);
+        if (!d->owned_form) return 0;
+        curl_easy_setopt(d->upload_handle, CURLOPT_MIMEPOST, d->owned_form);
+    } else if (!prepare_form_template(d, config, image_data, image_size)) {
+        return 0;
+    }
+    if (!d->url_set) {
+        // Set once per channel: cURL copies the URL, so setting it per frame would allocate
+        char upload_url[CC_URL_SIZE];
+        snprintf(upload_url, sizeof(upload_url),
+                 "%s/devices/%s/settings/%s/lcd/images", config->daemon_address, d->device_uid, d->lcd_channel);
+        curl_easy_setopt(d->upload_handle, CURLOPT_URL, upload_url);
+        d->url_set = 1;
+    }
+    d->request.easy = d->upload_handle;
+    d->request.done = lcd_delivery_done;
+    d->request.user = d;
+    d->attempt = 1;
+    d->reauthenticated = 0;
+    d->waiting_for_login = 0;
+    d->backoff_ms = CC_DELIVERY_BACKOFF_MS;
+    d->deadline_ms = monotonic_ms() + budget_ms;
+    d->on_done = on_done;
+    d->user = user;
+    d->busy = 1;
+    if (!arm_attempt(d, 0) || !http_engine_submit(&d->request)) {
+        release_owned_form(d);
+        d->busy = 0;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Completion callback used by the blocking send functions.
+ * @details Stores the result in the int pointed to by user.
+ * @example
+ *     // Not intended for direct use.
+ */
+static void blocking_delivery_done(int success, void *user) {
+    *(int *)user = success;
+}
+
+/**
+ * @brief Deliver one image and wait for the result (blocking).
+ * @details Waits for a delivery to the same device already in progress, then starts this one and runs the engine until it has finished, retries included. Both are bounded by their deadlines. Deliveries to other devices keep progressing meanwhile. Returns 1 on success, 0 on failure.
+ * @example
+ *     deliver_lcd_image(config, uid, NULL, png, png_size);
+ */
+static int deliver_lcd_image(const Config *config, const char* device_uid, const char* image_path, const unsigned char* image_data, size_t image_size) {
+    lcd_delivery_t *d = delivery_for(config, device_uid);
+    if (!d) return 0;
+    while (d->busy) {
+        if (http_engine_run(-1) < 0) return 0;
+    }
+    int result = -1;
+    if (!start_lcd_delivery(d, config, image_path, image_data, image_size, request_budget_ms(config), blocking_delivery_done, &result)) return 0;
+    while (result < 0) {
+        if (http_engine_run(-1) < 0) return 0;
+    }
+    return result;
+}
+
+/**
+ * @brief Sends an image directly to the LCD of the CoolerControl device.
+ * @details Uploads an image file to the LCD display using a multipart HTTP PUT request, retried on failure. Blocks until done.
+ * @example
+ *     send_image_to_lcd(&config, "/opt/coolerdash/images/coolerdash.png", uid);
+ */
+int send_image_to_lcd(const Config *config, const char* image_path, const char* device_uid) {
+    if (!image_path || !device_uid || !cc_session.session_initialized) return 0;
+    return deliver_lcd_image(config, device_uid, image_path, NULL, 0);
+}
+
+/**
+ * @brief Sends an in-memory PNG to the LCD of the CoolerControl device.
+ * @details Same request as send_image_to_lcd(), but the image part is taken from memory so no file is written or read. Blocks until done.
+ * @example
+ *     send_image_data_to_lcd(&config, png, png_size, uid);
+ */
+int send_image_data_to_lcd(const Config *config, const unsigned char* image_data, size_t image_size, const char* device_uid) {
+    if (!image_data || image_size == 0 || !device_uid || !cc_session.session_initialized || !link_is_up()) return 0;
+    return deliver_lcd_image(config, device_uid, NULL, image_data, image_size);
+}
+
+/**
+ * @brief Start sending an in-memory PNG to the LCD without waiting.
+ * @details The image is read directly from image_data (no copy), so the buffer must stay unchanged until on_done has been called. The transfer progresses in http_engine_run(); on_done is called from there with the final result. Each device has its own upload channel, so deliveries to different devices run concurrently.
+ * @example
+ *     submit_image_data_to_lcd(&config, png, png_size, uid, on_done, NULL);
+ */
+int submit_image_data_to_lcd(const Config *config, const unsigned char* image_data, size_t image_size, const char* device_uid, lcd_delivery_done_fn on_done, void *user) {
+    if (!image_data || image_size == 0 || !device_uid || !cc_session.session_initialized || !link_is_up()) return 0;
+    lcd_delivery_t *d = delivery_for(config, device_uid);
+    if (!d) return 0;
+    return start_lcd_delivery(d, config, NULL, image_data, image_size, request_budget_ms(config), on_done, user);
+}
+
+/**
+ * @brief Start sending an image file to the LCD with an explicit time budget.
+ * @details Like submit_image_data_to_lcd() but streams image_path and abandons the delivery after budget_ms, e.g. to fit the shutdown image into the service stop timeout.
+ * @example
+ *     submit_image_to_lcd(&config, config.shutdown_image, uid, 2000, on_done, NULL);
+ */
+int submit_image_to_lcd(const Config *config, const char* image_path, const char* device_uid, long budget_ms, lcd_delivery_done_fn on_done, void *user) {
+    if (!image_path || !device_uid || budget_ms <= 0 || !cc_session.session_initialized) return 0;
+    lcd_delivery_t *d = delivery_for(config, device_uid);
+    if (!d) return 0;
+    return start_lcd_delivery(d, config, image_path, NULL, 0, budget_ms, on_done, user);
+}
+
+/**
+ * @brief Abandon all deliveries in progress.
+ * @details Cancels their transfers and a pending re-login; every delivery is counted as a missed frame and its on_done is called with 0.
+ * @example
+ *     abort_lcd_deliveries();
+ */
+void abort_lcd_deliveries(void) {
+    if (auth_in_flight) {
+        http_engine_cancel(&auth_request);
+        auth_in_flight = 0;
+    }
+    for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) {
+        lcd_delivery_t *d = &deliveries[i];
+        if (!d->busy) continue;
+        http_engine_cancel(&d->request);
+        d->waiting_for_login = 0;
+        miss_lcd_delivery(d);
+    }
+}
+
+/**
+ * @brief Run the engine until all deliveries have finished, for at most budget_ms.
+ * @details Deliveries still running when the budget is used up are abandoned with abort_lcd_deliveries(). Returns 1 if all deliveries finished in time, 0 otherwise.
+ * @example
+ *     wait_lcd_deliveries(2000);
+ */
+int wait_lcd_deliveries(long budget_ms) {
+    long long deadline = monotonic_ms() + budget_ms;
+    for (;;) {
+        int busy = 0;
+        for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) busy |= deliveries[i].busy;
+        if (!busy) return 1;
+        long long remaining = deadline - monotonic_ms();
+        if (remaining <= 0 || http_engine_run((int)remaining) < 0) break;
+    }
+    abort_lcd_deliveries();
+    return 0;
 }
 
 /**
@@ -221,26 +863,108 @@ int upload_image_to_device(const Config *config, const char* image_path, const c
     return send_image_to_lcd(config, image_path, device_uid);
 }
 
+/**
+ * @brief Copy the LCD image delivery counters.
+ * @details Counters cover all devices. Each field is loaded atomically, so the copy is safe while the engine thread delivers; fields may come from different deliveries.
+ * @example
+ *     lcd_delivery_stats_t stats;
+ *     get_lcd_delivery_stats(&stats);
+ */
+void get_lcd_delivery_stats(lcd_delivery_stats_t *stats) {
+    if (!stats) return;
+    stats->delivered = __atomic_load_n(&delivery_stats.delivered, __ATOMIC_RELAXED);
+    stats->retries = __atomic_load_n(&delivery_stats.retries, __ATOMIC_RELAXED);
+    stats->failures = __atomic_load_n(&delivery_stats.failures, __ATOMIC_RELAXED);
+    stats->reauths = __atomic_load_n(&delivery_stats.reauths, __ATOMIC_RELAXED);
+    stats->reauth_failures = __atomic_load_n(&delivery_stats.reauth_failures, __ATOMIC_RELAXED);
+    stats->missed = __atomic_load_n(&delivery_stats.missed, __ATOMIC_RELAXED);
+    stats->last_response_code = __atomic_load_n(&delivery_stats.last_response_code, __ATOMIC_RELAXED);
+    stats->first_delivered_ms = __atomic_load_n(&delivery_stats.first_delivered_ms, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Copy the HTTP timing telemetry of one endpoint.
+ * @details Taken under timing_lock, so the copy is consistent even while the upload worker records.
+ * @example
+ *     get_endpoint_timing(CC_ENDPOINT_IMAGES, &timing);
+ */
+int get_endpoint_timing(cc_endpoint_t endpoint, cc_endpoint_timing_t *timing) {
+    if (!timing || endpoint < 0 || endpoint >= CC_ENDPOINT_COUNT) return 0;
+    pthread_mutex_lock(&timing_lock);
+    *timing = endpoint_timing[endpoint];
+    pthread_mutex_unlock(&timing_lock);
+    return 1;
+}
+
+/**
+ * @brief Return a short name for an endpoint.
+ * @details Returns "?" for an invalid endpoint.
+ * @example
+ *     get_endpoint_name(CC_ENDPOINT_DEVICES); // "devices"
+ */
+const char *get_endpoint_name(cc_endpoint_t endpoint) {
+    static const char *const names[CC_ENDPOINT_COUNT] = { "login", "devices", "images", "health" };
+    return endpoint >= 0 && endpoint < CC_ENDPOINT_COUNT ? names[endpoint] : "?";
+}
+
+/**
+ * @brief Return a short name for a request phase.
+ * @details Returns "?" for an invalid phase.
+ * @example
+ *     get_phase_name(CC_PHASE_WAIT); // "wait"
+ */
+const char *get_phase_name(cc_phase_t phase) {
+    static const char *const names[CC_PHASE_COUNT] = { "dns", "connect", "pretransfer", "first byte", "total", "wait" };
+    return phase >= 0 && phase < CC_PHASE_COUNT ? names[phase] : "?";
+}
+
 /**
  * @brief Terminates the CoolerControl session and cleans up.
- * @details Frees all resources, cleans up cURL, and removes the session cookie file.
+ * @details Frees all resources and cleans up cURL. The session cookie is dropped with the shared cookie store.
  * @example
  *     cleanup_coolercontrol_session();
  */
 void cleanup_coolercontrol_session(void) {
     static int cleanup_done = 0;
     if (cleanup_done) return;
-    int all_cleaned = 1;
+    http_engine_cancel(&auth_request);
+    auth_in_flight = 0;
+    link_cleanup();
+    for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) {
+        lcd_delivery_t *d = &deliveries[i];
+        if (!d->upload_handle) continue;
+        if (d->busy) {
+            http_engine_cancel(&d->request);
+            release_owned_form(d);
+            d->busy = 0;
+        }
+        release_form_template(d);
+        curl_easy_cleanup(d->upload_handle);
+        memset(d, 0, sizeof(*d));
+    }
     if (cc_session.curl_handle) {
         curl_easy_cleanup(cc_session.curl_handle);
         cc_session.curl_handle = NULL;
     }
-    curl_global_cleanup();
-    if (unlink(cc_session.cookie_jar) != 0) {
-        all_cleaned = 0;
+    if (cc_session.auth_handle) {
+        curl_easy_cleanup(cc_session.auth_handle);
+        cc_session.auth_handle = NULL;
+    }
+    if (cc_session.probe_handle) {
+        curl_easy_cleanup(cc_session.probe_handle);
+        cc_session.probe_handle = NULL;
     }
+    curl_slist_free_all(cc_session.upload_headers);
+    cc_session.upload_headers = NULL;
+    http_engine_cleanup(); // Free multi handle and share once no easy handle uses them
+    curl_global_cleanup();
+    pthread_mutex_lock(&cc_session.index_lock);
+    free(cc_session.devices);
+    cc_session.devices = NULL;
+    cc_session.device_count = 0;
+    pthread_mutex_unlock(&cc_session.index_lock);
     cc_session.session_initialized = 0;
-    if (all_cleaned) cleanup_done = 1;
+    cleanup_done = 1;
 }
 
 /**
@@ -256,23 +980,156 @@ int is_session_initialized(void) {
 }
 
 /**
- * @brief Parses the first Liquidctl device and extracts name and/or uid.
- * @details Parses the device list and extracts the name and/or uid of the first Liquidctl device.
+ * @brief Re-apply the request deadlines after the refresh interval changed.
+ * @details See header.
  * @example
- *     char name[128], uid[128];
- *     parse_device_fields(&config, name, sizeof(name), uid, sizeof(uid));
+ *     update_coolercontrol_timeouts(&config);
  */
-static int parse_device_fields(const Config *config, char* name_buffer, size_t name_size, char* uid_buffer, size_t uid_size) {
-    // Initialize response buffer
-    struct http_response response = {0};
-    response.data = malloc(1);
-    if (!response.data) {
-        fprintf(stderr, "[CoolerDash] Error: malloc failed for response.data\n");
-        return 0;
+void update_coolercontrol_timeouts(const Config *config) {
+    if (!config || !cc_session.session_initialized) return;
+    CURL *handles[] = { cc_session.curl_handle, cc_session.auth_handle, cc_session.probe_handle };
+    for (size_t i = 0; i < sizeof(handles) / sizeof(handles[0]); ++i) {
+        if (handles[i]) apply_timeouts(handles[i], config);
     }
-    response.size = 0;
-    if (!response.data) return 0;
-    
+    for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) {
+        if (deliveries[i].upload_handle) apply_timeouts(deliveries[i].upload_handle, config);
+    }
+}
+
+/**
+ * @brief Parse state for the streaming /devices parse.
+ * @details path holds the most recent key at each nesting level, which is enough to locate uid/name/type of each device and the lcd_info of its channels without building a tree.
+ * @example
+ *     // Not intended for direct use; see refresh_device_index().
+ */
+typedef struct {
+    json_stream_t json;
+    cc_device_t *devices;       // Devices parsed so far (grown by doubling)
+    size_t count;
+    size_t capacity;
+    int out_of_memory;          // 1 if growing the device array failed
+    char path[CC_JSON_PATH_DEPTH][CC_JSON_KEY_SIZE];
+} device_parse_t;
+
+/**
+ * @brief Copy a string into a fixed buffer with truncation.
+ * @details Always NUL-terminates.
+ * @example
+ *     copy_field(dev->uid, sizeof(dev->uid), text);
+ */
+static void copy_field(char *dst, size_t dst_size, const char *src) {
+    snprintf(dst, dst_size, "%s", src);
+}
+
+/**
+ * @brief Check whether the key at a nesting level equals a name.
+ * @details Levels beyond CC_JSON_PATH_DEPTH never match.
+ * @example
+ *     if (path_is(ctx, 1, "devices")) { ... }
+ */
+static int path_is(const device_parse_t *ctx, int depth, const char *key) {
+    return depth > 0 && depth < CC_JSON_PATH_DEPTH && strcmp(ctx->path[depth], key) == 0;
+}
+
+/**
+ * @brief Append an empty device to the parse result.
+ * @details Returns the new device, or NULL if out of memory.
+ * @example
+ *     cc_device_t *dev = add_device(ctx);
+ */
+static cc_device_t *add_device(device_parse_t *ctx) {
+    if (ctx->count == ctx->capacity) {
+        size_t capacity = ctx->capacity ? ctx->capacity * 2 : 8;
+        cc_device_t *grown = realloc(ctx->devices, capacity * sizeof(*grown));
+        if (!grown) {
+            ctx->out_of_memory = 1;
+            return NULL;
+        }
+        ctx->devices = grown;
+        ctx->capacity = capacity;
+    }
+    cc_device_t *dev = &ctx->devices[ctx->count++];
+    memset(dev, 0, sizeof(*dev));
+    return dev;
+}
+
+/**
+ * @brief Record the LCD channel of the current device.
+ * @details Called for lcd_info and its members; the channel name is the key two levels up.
+ * @example
+ *     mark_lcd(ctx, dev, 6);
+ */
+static void mark_lcd(device_parse_t *ctx, cc_device_t *dev, int lcd_info_depth) {
+    if (!dev->has_lcd) {
+        dev->has_lcd = 1;
+        copy_field(dev->lcd_channel, sizeof(dev->lcd_channel), ctx->path[lcd_info_depth - 1]);
+    }
+}
+
+/**
+ * @brief JSON token callback for /devices.
+ * @details Device objects are the elements of the root "devices" array (depth 3). uid, name and type are members of the device; LCD data lives at info.channels.<channel>.lcd_info. Everything else is skipped.
+ * @example
+ *     // Not intended for direct use; registered with json_stream_init().
+ */
+static void on_device_token(json_event_t event, const char *text, int depth, void *user) {
+    device_parse_t *ctx = user;
+    if (event == JSON_EVENT_KEY) {
+        if (depth < CC_JSON_PATH_DEPTH) copy_field(ctx->path[depth], CC_JSON_KEY_SIZE, text);
+        return;
+    }
+    if (event == JSON_EVENT_OBJECT_START || event == JSON_EVENT_ARRAY_START) {
+        if (depth < CC_JSON_PATH_DEPTH) ctx->path[depth][0] = '\0';
+        if (event == JSON_EVENT_OBJECT_START && depth == 3 && path_is(ctx, 1, "devices")) add_device(ctx);
+    }
+    if (ctx->count == 0 || !path_is(ctx, 1, "devices") || depth < 3) return;
+    cc_device_t *dev = &ctx->devices[ctx->count - 1];
+    if (depth == 3 && event == JSON_EVENT_STRING) {
+        if (path_is(ctx, 3, "uid")) copy_field(dev->uid, sizeof(dev->uid), text);
+        else if (path_is(ctx, 3, "name")) copy_field(dev->name, sizeof(dev->name), text);
+        else if (path_is(ctx, 3, "type")) copy_field(dev->type, sizeof(dev->type), text);
+        return;
+    }
+    if (!path_is(ctx, 3, "info") || !path_is(ctx, 4, "channels")) return;
+    if (depth == 7 && event == JSON_EVENT_OBJECT_START && path_is(ctx, 6, "lcd_info")) {
+        mark_lcd(ctx, dev, 6);
+    } else if (depth == 7 && event == JSON_EVENT_NUMBER && path_is(ctx, 6, "lcd_info")) {
+        mark_lcd(ctx, dev, 6);
+        if (path_is(ctx, 7, "screen_width")) dev->lcd_width = atoi(text);
+        else if (path_is(ctx, 7, "screen_height")) dev->lcd_height = atoi(text);
+        else if (path_is(ctx, 7, "max_image_size_bytes")) dev->lcd_max_image_size = atol(text);
+    }
+}
+
+/**
+ * @brief cURL write callback feeding /devices to the JSON parser.
+ * @details Bodies of non-200 responses (e.g. 401 before a re-login) are discarded. Returning less than the chunk size aborts the transfer on a syntax error.
+ * @example
+ *     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, device_write_callback);
+ */
+static size_t device_write_callback(char *contents, size_t size, size_t nmemb, void *user) {
+    device_parse_t *ctx = user;
+    size_t realsize = size * nmemb;
+    long response_code = 0;
+    curl_easy_getinfo(cc_session.curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
+    if (response_code != 200) return realsize;
+    return json_stream_feed(&ctx->json, contents, realsize) ? realsize : 0;
+}
+
+/**
+ * @brief Prepare curl_handle for a /devices request.
+ * @details Allocates the parse state and points the write callback at it. Returns NULL on allocation failure.
+ * @example
+ *     device_parse_t *ctx = begin_device_refresh(config);
+ */
+static device_parse_t *begin_device_refresh(const Config *config) {
+    device_parse_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        fprintf(stderr, "[CoolerDash] Error: calloc failed for device index\n");
+        return NULL;
+    }
+    json_stream_init(&ctx->json, on_device_token, ctx);
+
     // URL for device list
     char devices_url[CC_URL_SIZE];
     // Build devices URL safely
@@ -281,89 +1138,372 @@ static int parse_device_fields(const Config *config, char* name_buffer, size_t n
     // Configure cURL for GET request
     curl_easy_setopt(cc_session.curl_handle, CURLOPT_URL, devices_url);
     curl_easy_setopt(cc_session.curl_handle, CURLOPT_HTTPGET, 1L);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEDATA, &response);
-    
-    CURLcode res = curl_easy_perform(cc_session.curl_handle);
+    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEFUNCTION, device_write_callback);
+    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEDATA, ctx);
+    return ctx;
+}
+
+/**
+ * @brief Finish a /devices request and install the new index.
+ * @details The index is only replaced if the whole document parsed. Frees ctx. Returns 1 on success, 0 on failure.
+ * @example
+ *     int ok = finish_device_refresh(ctx, res, response_code);
+ */
+static int finish_device_refresh(device_parse_t *ctx, CURLcode res, long response_code) {
     if (res != CURLE_OK) {
         fprintf(stderr, "[CoolerDash] cURL request failed: %s\n", curl_easy_strerror(res));
     }
+    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEFUNCTION, discard_body);
+    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEDATA, NULL);
+
+    int ok = res == CURLE_OK && response_code == 200 && json_stream_finish(&ctx->json) && !ctx->out_of_memory;
+    if (ok) {
+        pthread_mutex_lock(&cc_session.index_lock);
+        cc_device_t *previous = cc_session.devices;
+        cc_session.devices = ctx->devices;
+        cc_session.device_count = ctx->count;
+        pthread_mutex_unlock(&cc_session.index_lock);
+        free(previous);
+    } else {
+        if (res == CURLE_OK && response_code == 200) fprintf(stderr, "[CoolerDash] Error: Could not parse device list\n");
+        free(ctx->devices);
+    }
+    free(ctx);
+    return ok;
+}
+
+/**
+ * @brief Fetch /devices once and rebuild the device index.
+ * @details Streams the response through the JSON parser; the index is only replaced if the whole document parsed. A 401/403 triggers one re-login and retry.
+ * @example
+ *     refresh_device_index(&config);
+ */
+int refresh_device_index(const Config *config) {
+    if (!cc_session.curl_handle || !cc_session.session_initialized) return 0;
+    device_parse_t *ctx = begin_device_refresh(config);
+    if (!ctx) return 0;
+    
     long response_code = 0;
-    if (curl_easy_getinfo(cc_session.curl_handle, CURLINFO_RESPONSE_CODE, &response_code) != CURLE_OK) {
-        fprintf(stderr, "[CoolerDash] Failed to get HTTP response code.\n");
+    CURLcode res = perform_timed(CC_ENDPOINT_DEVICES, cc_session.curl_handle, &response_code);
+    if (res == CURLE_OK && (response_code == 401 || response_code == 403)) {
+        // Session expired (daemon restarted): log in again and repeat the request once
+        __atomic_fetch_add(&delivery_stats.reauths, 1, __ATOMIC_RELAXED);
+        if (session_login()) {
+            res = perform_timed(CC_ENDPOINT_DEVICES, cc_session.curl_handle, &response_code);
+        } else {
+            __atomic_fetch_add(&delivery_stats.reauth_failures, 1, __ATOMIC_RELAXED);
+        }
     }
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEFUNCTION, NULL);
-    curl_easy_setopt(cc_session.curl_handle, CURLOPT_WRITEDATA, NULL);
-    int found = 0;
-    if (res == CURLE_OK && response_code == 200 && response.data) {
-        char *search_pos = response.data;
-        while ((search_pos = strstr(search_pos, "\"uid\":\"")) != NULL) {
-            char *device_start = search_pos;
-            while (device_start > response.data && *device_start != '{') device_start--;
-            char *device_end = strchr(search_pos, '}');
-            if (!device_end) device_end = response.data + response.size;
-            char device_section[CC_DEVICE_SECTION_SIZE];
-            size_t section_length = device_end - device_start;
-            if (section_length < sizeof(device_section)) {
-                memcpy(device_section, device_start, section_length);
-                device_section[section_length] = '\0';
-                if (strstr(device_section, "\"type\":\"Liquidctl\"")) {
-                    // Extract name if requested
-                    if (name_buffer && name_size > 0) {
-                        char *name_pos = strstr(device_section, "\"name\":\"");
-                        if (name_pos) {
-                            name_pos += 8;
-                            char *name_end = strchr(name_pos, '"');
-                            if (name_end) {
-                                size_t name_length = name_end - name_pos;
-                                if (name_length < name_size) {
-                                    strncpy(name_buffer, name_pos, name_length);
-                                    name_buffer[name_length] = '\0';
-                                } else {
-                                    strncpy(name_buffer, name_pos, name_size - 1);
-                                    name_buffer[name_size - 1] = '\0';
-                                }
-                                found = 1;
-                            }
-                        }
-                    }
-                    // Extract uid if requested
-                    if (uid_buffer && uid_size > 0) {
-                        char *uid_pos = strstr(device_section, "\"uid\":\"");
-                        if (uid_pos) {
-                            uid_pos += 7;
-                            char *uid_end = strchr(uid_pos, '"');
-                            if (uid_end) {
-                                size_t uid_length = uid_end - uid_pos;
-                                if (uid_length < uid_size) {
-                                    strncpy(uid_buffer, uid_pos, uid_length);
-                                    uid_buffer[uid_length] = '\0';
-                                } else {
-                                    strncpy(uid_buffer, uid_pos, uid_size - 1);
-                                    uid_buffer[uid_size - 1] = '\0';
-                                }
-                                found = 1;
-                            }
-                        }
-                    }
-                    // If at least one field was found, break out of the loop
-                    if (found) break;
-                }
-            }
-            search_pos = device_end;
+    return finish_device_refresh(ctx, res, response_code);
+}
+
+/**
+ * @brief Circuit breaker between the render loop and an unavailable daemon.
+ * @details UP: frames are rendered and uploaded. After CC_BREAKER_THRESHOLD consecutive deliveries failed at the transport level or with 5xx, the link goes DOWN: frames are skipped and /health is polled with exponential backoff. A healthy probe moves to RECOVERING, which logs in again and re-discovers the devices before going UP. Everything except stats runs on the thread owning the HTTP engine; stats is shared with the render thread under lock.
+ * @example
+ *     // Not intended for direct use; see lcd_link_allows_frame().
+ */
+static struct {
+    pthread_mutex_t lock;          // Protects stats
+    cc_link_stats_t stats;         // State and transition counters
+    long long down_since_ms;       // Start of the current outage
+    int consecutive_failures;      // Failed deliveries since the last success
+    long probe_delay_ms;           // Delay before the next health probe
+    http_request_t probe_request;  // /health on probe_handle
+    http_request_t devices_request; // /devices on curl_handle during recovery
+    device_parse_t *devices_ctx;   // Parse state of devices_request
+} lcd_link = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+/**
+ * @brief Return whether the link is UP.
+ * @details Safe to call from any thread.
+ * @example
+ *     if (!link_is_up()) return 0;
+ */
+static int link_is_up(void) {
+    pthread_mutex_lock(&lcd_link.lock);
+    int up = lcd_link.stats.state == CC_LINK_UP;
+    pthread_mutex_unlock(&lcd_link.lock);
+    return up;
+}
+
+/**
+ * @brief Change the link state and update the transition counters.
+ * @details Logs when the link goes down from UP and when it comes back.
+ * @example
+ *     set_link_state(CC_LINK_DOWN);
+ */
+static void set_link_state(cc_link_state_t state) {
+    pthread_mutex_lock(&lcd_link.lock);
+    cc_link_state_t previous = lcd_link.stats.state;
+    lcd_link.stats.state = state;
+    if (previous == CC_LINK_UP && state == CC_LINK_DOWN) {
+        lcd_link.stats.outages++;
+        lcd_link.down_since_ms = monotonic_ms();
+    } else if (previous != CC_LINK_UP && state == CC_LINK_UP) {
+        lcd_link.stats.recoveries++;
+        lcd_link.stats.last_outage_ms = monotonic_ms() - lcd_link.down_since_ms;
+    } else if (previous == CC_LINK_RECOVERING && state == CC_LINK_DOWN) {
+        lcd_link.stats.recovery_failures++;
+    }
+    long long outage_ms = lcd_link.stats.last_outage_ms;
+    pthread_mutex_unlock(&lcd_link.lock);
+    if (previous == CC_LINK_UP && state == CC_LINK_DOWN) {
+        fprintf(stderr, "[CoolerDash] Warning: CoolerControl unavailable, pausing LCD updates\n");
+    } else if (previous != CC_LINK_UP && state == CC_LINK_UP) {
+        fprintf(stderr, "[CoolerDash] CoolerControl available again after %.1f s, resuming LCD updates\n", outage_ms / 1000.0);
+    }
+}
+
+/**
+ * @brief Schedule the next health probe and double the delay for the one after it.
+ * @details The delay is capped at CC_BREAKER_PROBE_MAX_MS.
+ * @example
+ *     schedule_probe();
+ */
+static void schedule_probe(void) {
+    long delay_ms = lcd_link.probe_delay_ms;
+    lcd_link.probe_delay_ms = delay_ms * 2 > CC_BREAKER_PROBE_MAX_MS ? CC_BREAKER_PROBE_MAX_MS : delay_ms * 2;
+    if (!http_engine_submit_after(&lcd_link.probe_request, delay_ms)) {
+        fprintf(stderr, "[CoolerDash] Error: Could not schedule CoolerControl health probe\n");
+    }
+}
+
+/**
+ * @brief Give up the current recovery attempt and return to probing.
+ * @details Called when the login or device discovery after a healthy probe failed.
+ * @example
+ *     recovery_failed();
+ */
+static void recovery_failed(void) {
+    set_link_state(CC_LINK_DOWN);
+    schedule_probe();
+}
+
+/**
+ * @brief Count the result of a finished image delivery.
+ * @details Only transport errors and 5xx count towards opening the breaker; 4xx responses mean the daemon is alive. Results arriving while the link is not UP are ignored.
+ * @example
+ *     // Not intended for direct use; called by finish_lcd_delivery().
+ */
+static void link_delivery_finished(int success, long response_code) {
+    if (!link_is_up()) return;
+    if (success) {
+        lcd_link.consecutive_failures = 0;
+        return;
+    }
+    if (response_code != 0 && response_code < 500) return;
+    if (++lcd_link.consecutive_failures < CC_BREAKER_THRESHOLD) return;
+    lcd_link.consecutive_failures = 0;
+    lcd_link.probe_delay_ms = CC_BREAKER_PROBE_MS;
+    set_link_state(CC_LINK_DOWN);
+    schedule_probe();
+}
+
+/**
+ * @brief Engine completion callback of the recovery /devices request.
+ * @details Installs the new index, refreshes the LCD channel of every upload channel and reopens the link.
+ * @example
+ *     // Not intended for direct use; set as lcd_link.devices_request.done.
+ */
+static void link_devices_done(http_request_t *req, CURLcode result, long response_code) {
+    record_timing(CC_ENDPOINT_DEVICES, req->easy, result, response_code);
+    int ok = finish_device_refresh(lcd_link.devices_ctx, result, response_code);
+    lcd_link.devices_ctx = NULL;
+    if (!ok) {
+        recovery_failed();
+        return;
+    }
+    for (int i = 0; i < CONFIG_MAX_DEVICES; ++i) {
+        if (deliveries[i].device_uid[0]) {
+            lookup_lcd_channel(deliveries[i].device_uid, deliveries[i].lcd_channel, sizeof(deliveries[i].lcd_channel));
+            deliveries[i].url_set = 0; // The channel may have changed
         }
     }
-    // Free response buffer after parsing
-    if (response.data) {
-        free(response.data);
-        response.data = NULL;
+    lcd_link.consecutive_failures = 0;
+    set_link_state(CC_LINK_UP);
+}
+
+/**
+ * @brief Continue a recovery once the re-login has finished.
+ * @details Starts device discovery after a successful login. No-op unless the link is RECOVERING.
+ * @example
+ *     // Not intended for direct use; called by reauth_done().
+ */
+static void link_login_finished(int ok) {
+    pthread_mutex_lock(&lcd_link.lock);
+    int recovering = lcd_link.stats.state == CC_LINK_RECOVERING;
+    pthread_mutex_unlock(&lcd_link.lock);
+    if (!recovering) return;
+    if (ok) lcd_link.devices_ctx = begin_device_refresh(cc_session.config);
+    if (!lcd_link.devices_ctx) {
+        recovery_failed();
+        return;
+    }
+    lcd_link.devices_request.easy = cc_session.curl_handle;
+    lcd_link.devices_request.done = link_devices_done;
+    if (!http_engine_submit(&lcd_link.devices_request)) {
+        finish_device_refresh(lcd_link.devices_ctx, CURLE_FAILED_INIT, 0);
+        lcd_link.devices_ctx = NULL;
+        recovery_failed();
     }
+}
+
+/**
+ * @brief Engine completion callback of a /health probe.
+ * @details A 2xx answer starts the recovery with a re-login (joining one already in flight); otherwise the next probe is scheduled.
+ * @example
+ *     // Not intended for direct use; set as lcd_link.probe_request.done.
+ */
+static void link_probe_done(http_request_t *req, CURLcode result, long response_code) {
+    record_timing(CC_ENDPOINT_HEALTH, req->easy, result, response_code);
+    int healthy = result == CURLE_OK && response_code >= 200 && response_code < 300;
+    pthread_mutex_lock(&lcd_link.lock);
+    lcd_link.stats.probes++;
+    if (!healthy) lcd_link.stats.probe_failures++;
+    pthread_mutex_unlock(&lcd_link.lock);
+    if (!healthy) {
+        schedule_probe();
+        return;
+    }
+    set_link_state(CC_LINK_RECOVERING);
+    if (auth_in_flight) return; // reauth_done() continues the recovery
+    if (!http_engine_submit(&auth_request)) {
+        recovery_failed();
+        return;
+    }
+    auth_in_flight = 1;
+}
+
+/**
+ * @brief Bind the breaker requests to their handles and reset the link to UP.
+ * @details Called from init_coolercontrol_session() once probe_handle is configured.
+ * @example
+ *     link_init();
+ */
+static void link_init(void) {
+    lcd_link.probe_request.easy = cc_session.probe_handle;
+    lcd_link.probe_request.done = link_probe_done;
+    lcd_link.consecutive_failures = 0;
+    pthread_mutex_lock(&lcd_link.lock);
+    lcd_link.stats.state = CC_LINK_UP;
+    pthread_mutex_unlock(&lcd_link.lock);
+}
+
+/**
+ * @brief Cancel breaker requests in flight.
+ * @details Called from cleanup_coolercontrol_session() before the handles are freed.
+ * @example
+ *     link_cleanup();
+ */
+static void link_cleanup(void) {
+    http_engine_cancel(&lcd_link.probe_request);
+    http_engine_cancel(&lcd_link.devices_request);
+    if (lcd_link.devices_ctx) {
+        finish_device_refresh(lcd_link.devices_ctx, CURLE_ABORTED_BY_CALLBACK, 0);
+        lcd_link.devices_ctx = NULL;
+    }
+}
+
+/**
+ * @brief Return whether a frame should be rendered and uploaded.
+ * @details Returns 0 while the circuit breaker is open (DOWN or RECOVERING) and counts the frame as skipped. Safe to call from any thread.
+ * @example
+ *     if (!lcd_link_allows_frame()) return;
+ */
+int lcd_link_allows_frame(void) {
+    pthread_mutex_lock(&lcd_link.lock);
+    int up = lcd_link.stats.state == CC_LINK_UP;
+    if (!up) lcd_link.stats.frames_skipped++;
+    pthread_mutex_unlock(&lcd_link.lock);
+    return up;
+}
+
+/**
+ * @brief Drive the health probes without blocking.
+ * @details For callers that own the HTTP engine but do not run it otherwise (inline uploads without the upload worker). No-op while the link is UP.
+ * @example
+ *     if (!lcd_link_allows_frame()) service_lcd_link();
+ */
+void service_lcd_link(void) {
+    if (!link_is_up()) http_engine_run(0);
+}
+
+/**
+ * @brief Copy the circuit breaker state and counters.
+ * @details Safe to call from any thread.
+ * @example
+ *     cc_link_stats_t stats;
+ *     get_lcd_link_stats(&stats);
+ */
+void get_lcd_link_stats(cc_link_stats_t *stats) {
+    if (!stats) return;
+    pthread_mutex_lock(&lcd_link.lock);
+    *stats = lcd_link.stats;
+    pthread_mutex_unlock(&lcd_link.lock);
+}
+
+/**
+ * @brief Return the number of devices in the index.
+ * @details See header.
+ * @example
+ *     size_t n = get_device_count();
+ */
+size_t get_device_count(void) {
+    pthread_mutex_lock(&cc_session.index_lock);
+    size_t count = cc_session.device_count;
+    pthread_mutex_unlock(&cc_session.index_lock);
+    return count;
+}
+
+/**
+ * @brief Copy one device of the index.
+ * @details See header.
+ * @example
+ *     cc_device_t dev;
+ *     if (copy_device_info(0, &dev)) { ... }
+ */
+int copy_device_info(size_t index, cc_device_t *device) {
+    if (!device) return 0;
+    pthread_mutex_lock(&cc_session.index_lock);
+    int found = index < cc_session.device_count;
+    if (found) *device = cc_session.devices[index];
+    pthread_mutex_unlock(&cc_session.index_lock);
     return found;
 }
 
+/**
+ * @brief Select the LCD device to drive.
+ * @details Fetches the index on first use. Prefers the first Liquidctl device with an LCD channel and falls back to the first Liquidctl device. The selected entry is copied into *device under the index lock, so the circuit breaker may replace the index meanwhile. Returns 1 if a device was found, 0 otherwise.
+ * @example
+ *     cc_device_t dev;
+ *     if (find_lcd_device(config, &dev)) { ... }
+ */
+static int find_lcd_device(const Config *config, cc_device_t *device) {
+    pthread_mutex_lock(&cc_session.index_lock);
+    int indexed = cc_session.devices != NULL;
+    pthread_mutex_unlock(&cc_session.index_lock);
+    if (!indexed && !refresh_device_index(config)) return 0;
+
+    pthread_mutex_lock(&cc_session.index_lock);
+    const cc_device_t *found = NULL;
+    for (size_t i = 0; i < cc_session.device_count; ++i) {
+        const cc_device_t *dev = &cc_session.devices[i];
+        if (strcmp(dev->type, "Liquidctl") != 0 || !dev->uid[0]) continue;
+        if (dev->has_lcd) {
+            found = dev;
+            break;
+        }
+        if (!found) found = dev;
+    }
+    if (found) *device = *found;
+    pthread_mutex_unlock(&cc_session.index_lock);
+    return found != NULL;
+}
+
 /**
  * @brief Retrieves the full name of the LCD device.
- * @details Queries the CoolerControl API for the device name and writes it to the provided buffer.
+ * @details Copies the name of the selected device from the device index into the provided buffer.
  * @example
  *     char name[128];
  *     if (get_device_name(&config, name, sizeof(name))) {
@@ -372,12 +1512,15 @@ static int parse_device_fields(const Config *config, char* name_buffer, size_t n
  */
 int get_device_name(const Config *config, char* name_buffer, size_t buffer_size) {
     if (!cc_session.curl_handle || !name_buffer || buffer_size == 0 || !cc_session.session_initialized) return 0;
-    return parse_device_fields(config, name_buffer, buffer_size, NULL, 0);
+    cc_device_t dev;
+    if (!find_lcd_device(config, &dev) || !dev.name[0]) return 0;
+    copy_field(name_buffer, buffer_size, dev.name);
+    return 1;
 }
 
 /**
  * @brief Retrieves the UID of the first LCD device found.
- * @details Queries the CoolerControl API for the device UID and writes it to the provided buffer.
+ * @details Copies the UID of the selected device from the device index into the provided buffer.
  * @example
  *     char uid[128];
  *     if (get_device_uid(&config, uid, sizeof(uid))) {
@@ -386,7 +1529,10 @@ int get_device_name(const Config *config, char* name_buffer, size_t buffer_size)
  */
 int get_device_uid(const Config *config, char* uid_buffer, size_t buffer_size) {
     if (!cc_session.curl_handle || !uid_buffer || buffer_size == 0 || !cc_session.session_initialized) return 0;
-    return parse_device_fields(config, NULL, 0, uid_buffer, buffer_size);
+    cc_device_t dev;
+    if (!find_lcd_device(config, &dev)) return 0;
+    copy_field(uid_buffer, buffer_size, dev.uid);
+    return 1;
 }
 
 /**
@@ -16,78 +16,48 @@
 // Include project headers
 #include "../include/cpu_monitor.h"
 #include "../include/config.h"
-
-// Include necessary headers
-#include <stdio.h>
-#include <string.h>
-#include <dirent.h>
-#include <stdlib.h>
+#include "../include/sensors.h"
 
 /**
- * @brief Cached path to CPU temperature sensor file.
- * @details Set by init_cpu_sensor_path() and used by read_cpu_temp().
+ * @brief Registry index of the CPU temperature sensor.
+ * @details Set by init_cpu_sensor_path() and used by read_cpu_temp(). -1 if no CPU sensor was found.
  * @example
  *     // Not intended for direct use; managed by module functions.
  */
-char cpu_temp_path[512] = {0};
+static int cpu_sensor_index = -1;
 
 /**
- * @brief Initialize hwmon sensor path for CPU temperature at startup (once).
- * @details Detects and sets the path to the CPU temperature sensor file by scanning available hwmon entries. Uses the hwmon_path from the configuration struct. Internally uses opendir(), readdir(), fopen(), fclose(), closedir(). Always checks and frees resources. Returns nothing; path is cached in cpu_temp_path.
+ * @brief Initialize the CPU temperature sensor lookup at startup (once).
+ * @details Ensures the shared hwmon registry is populated (one directory scan for all sensors), looks up the input labelled "Package id 0" and watches it, so the sampler reads it. Returns nothing; the index is cached for read_cpu_temp().
  * @example
  *     init_cpu_sensor_path(&config);
  */
 void init_cpu_sensor_path(const Config *config) {
-    DIR *dir = opendir(config->hwmon_path);
-    if (!dir) return;
-    
-    struct dirent *entry;
-    char label_path[512], label[64];
-    
-    // Scan through hwmon directory entries
-    while ((entry = readdir(dir)) != NULL) {
-        if (entry->d_name[0] == '.') continue; // Skip hidden files/directories
-        
-        // Check each possible temp label for the current hwmon entry
-        for (int i = 1; i <= 9; ++i) {
-            snprintf(label_path, sizeof(label_path), "%s/%s/temp%d_label", config->hwmon_path, entry->d_name, i);
-            FILE *flabel = fopen(label_path, "r");
-            if (!flabel) continue;
-            
-            // Read the label and check if it matches "Package id 0"
-            if (fgets(label, sizeof(label), flabel)) {
-                // Cache CPU temperature path for later use
-                if (strstr(label, "Package id 0") && strlen(cpu_temp_path) == 0) {
-                    snprintf(cpu_temp_path, sizeof(cpu_temp_path), "%s/%s/temp%d_input", config->hwmon_path, entry->d_name, i);
-                    fclose(flabel);
-                    closedir(dir);
-                    return;
-                }
-            }
-            fclose(flabel);
-        }
-    }
-    closedir(dir);
+    sensors_init(config);
+    cpu_sensor_index = sensors_find(SENSOR_KIND_TEMP, "Package id 0");
+    sensors_watch(cpu_sensor_index);
 }
 
 /**
- * @brief Read CPU temperature from cached hwmon path.
- * @details Reads the temperature from the CPU sensor file set by init_cpu_sensor_path(). Uses fopen(), fscanf(), fclose(). Always checks and frees resources. Returns 0.0f on error or if no path is cached.
+ * @brief Read CPU temperature from the hwmon registry.
+ * @details Reads the CPU sensor through its persistent descriptor (single pread()). Returns 0.0f on error or if no CPU sensor was found.
  * @example
  *     float temp = read_cpu_temp();
  */
 float read_cpu_temp(void) {
-    if (strlen(cpu_temp_path) == 0) return 0.0f;
-    
-    FILE *finput = fopen(cpu_temp_path, "r");
-    if (!finput) return 0.0f;
-    
-    int t = 0;
-    float temp = 0.0f;
-    // Read the integer temperature value, convert to float
-    if (fscanf(finput, "%d", &t) == 1) {
-        temp = t > 200 ? t / 1000.0f : (float)t;
-    }
-    fclose(finput);
-    return temp;
+    long t = 0;
+    if (cpu_sensor_index < 0 || !sensors_read(cpu_sensor_index, &t)) return 0.0f;
+    return sensors_temp_celsius(t);
+}
+
+/**
+ * @brief Extract CPU temperature from a registry snapshot.
+ * @details Looks up the CPU sensor entry in a snapshot filled by sensors_sample_all(). Returns 0.0f if the CPU sensor is unknown or its read failed.
+ * @example
+ *     float temp = cpu_temp_from_snapshot(&snap);
+ */
+float cpu_temp_from_snapshot(const sensors_snapshot_t *snapshot) {
+    if (!snapshot || cpu_sensor_index < 0 || cpu_sensor_index >= snapshot->count) return 0.0f;
+    if (!snapshot->valid[cpu_sensor_index]) return 0.0f;
+    return sensors_temp_celsius(snapshot->value[cpu_sensor_index]);
 }
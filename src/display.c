@@ -13,21 +13,35 @@
  *     See function documentation for usage examples.
  */
 
+// Enable posix_memalign()
+#define _POSIX_C_SOURCE 200112L
+
+// Pixel buffer alignment in bytes (cache line / AVX-512 friendly)
+#define DISPLAY_BUFFER_ALIGN 64
+
+// Initial capacity of the encoded PNG buffer (grows by doubling)
+#define PNG_BUFFER_INITIAL_SIZE (64 * 1024)
+
 // Include project headers
 #include "../include/display.h"
 #include "../include/config.h"
 #include "../include/coolercontrol.h"
-#include "../include/cpu_monitor.h"
-#include "../include/gpu_monitor.h"
+#include "../include/glyph_atlas.h"
+#include "../include/sampler.h"
+#include "../include/uploader.h"
 
 // Include necessary headers
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <cairo/cairo.h>
 
 // Constants for display layout
+#define BAR_RADIUS 8.0 // Bar corner radius in px
+#define BAR_END_WIDTH 8 // Width of the rounded right end of a bar fill in px (at least BAR_RADIUS)
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -55,109 +69,471 @@ void lerp_temp_color(const Config *config, float val, int* r, int* g, int* b) {
 }
 
 /**
- * @brief Forward declarations for internal display rendering functions.
- * @details These functions are only used internally in display.c for modular rendering logic.
+ * @brief Configuration subset that determines the static background layer.
+ * @details Two keys compare equal (memcmp) exactly when the cached background can be reused. Always zero the key before filling it so padding and unused font_face bytes compare equal.
  * @example
- *     // Not intended for direct use; see render_display() and draw_combined_image().
+ *     background_key_t key;
+ *     background_key_from_config(&key, config);
  */
-static void draw_temperature_bars(cairo_t *cr, const sensor_data_t *data, const Config *config);
-static void draw_temperature_displays(cairo_t *cr, const sensor_data_t *data, const Config *config);
-static void draw_labels(cairo_t *cr, const Config *config);
-static int should_update_display(const sensor_data_t *data, const Config *config);
+typedef struct {
+    int width;
+    int height;
+    int box_height;
+    int bar_width;
+    int bar_height;
+    int bar_gap;
+    float border_line_width;
+    float font_size_labels;
+    char font_face[64];
+    Color color_txt_label;
+    Color color_bg_bar;
+    Color color_border_bar;
+} background_key_t;
 
 /**
- * @brief Render display based on sensor data (only default mode).
- * @details Renders the LCD display image using the provided sensor data. Handles drawing, saving, and uploading the image.
+ * @brief Pre-rendered bar layers, built together with the background.
+ * @details Both bars share one geometry, so one set serves both. frame is painted over the temperature text, which hides the text under the bars as a full redraw does; the fill is then drawn through the A8 masks with a pixel-aligned rectangle clip at most, so no clip path is built per frame. ends[k] is the rounded end of a fill that stops k px before the end of the bar, where it meets the rounded inside of the border; ends[BAR_END_WIDTH] serves every fill that stops further left.
  * @example
- *     int result = render_display(&config, &sensor_data);
+ *     // Not intended for direct use; built by prepare_bar_layers().
  */
-int render_display(const Config *config, const sensor_data_t *data) {
-    if (!data || !config) return 0;
+typedef struct {
+    cairo_surface_t *frame;                      // ARGB32: trough and border of one bar, transparent elsewhere
+    int margin;                                  // Pixels around the bar outline in frame (outer half of the border plus antialiasing)
+    cairo_surface_t *inside;                     // A8, bar sized: inside of the border
+    cairo_surface_t *ends[BAR_END_WIDTH + 1];    // A8, BAR_END_WIDTH wide: rounded fill ends
+} bar_layers_t;
 
-    cairo_surface_t *surface = NULL;
-    cairo_t *cr = NULL;
-    int success = 0;
+/**
+ * @brief Growable buffer holding the encoded PNG of the current frame.
+ * @details size is reset every frame; capacity only grows, so after the first few frames the output buffer is not reallocated. libpng and zlib still allocate their own encoder state on every cairo_surface_write_to_png_stream() call; these are the only allocations of a steady-state frame.
+ * @example
+ *     // Not intended for direct use; filled by png_buffer_write().
+ */
+typedef struct {
+    unsigned char *data; // Encoded PNG bytes
+    size_t size;         // Bytes used by the current frame
+    size_t capacity;     // Allocated bytes
+} png_buffer_t;
 
-    // Only update if sensor data changed significantly
-    if (!should_update_display(data, config)) {
-        return 1; // No update needed, but no error
+/**
+ * @brief Persistent render target state.
+ * @details Owns the 64-byte aligned pixel buffer, the Cairo image surface wrapping it and the Cairo context. Allocated once on the first frame and rebuilt only when the display resolution changes, so steady-state frames do not re-create them. Together with the cached layers this makes drawing a steady-state frame allocation-free (make test checks it); only the PNG encoder allocates.
+ * @example
+ *     // Not intended for direct use; managed by display_state_prepare() and display_output_release().
+ */
+typedef struct {
+    unsigned char *pixels;    // Aligned pixel buffer backing the surface
+    cairo_surface_t *surface; // Image surface over pixels
+    cairo_t *cr;              // Context reused across frames
+    int width;                // Width the state was built for
+    int height;               // Height the state was built for
+    cairo_surface_t *background;     // Cached static layer (black fill and labels)
+    bar_layers_t bars;               // Cached bar layers, rebuilt with the background
+    background_key_t background_key; // Config subset the cached layers were rendered with
+    glyph_atlas_t glyphs;            // Pre-rasterized temperature glyphs
+    png_buffer_t png;                // Encoded frame, reused across frames
+} display_state_t;
+
+/**
+ * @brief One LCD output with its own configuration and render state.
+ * @details Every device gets its own render target, background cache and change detection, so outputs with different resolutions or themes never invalidate each other's caches.
+ * @example
+ *     // Not intended for direct use; created by display_add_output().
+ */
+typedef struct {
+    Config config;                // Per-device configuration
+    char device_uid[CC_UID_SIZE]; // Target device ("" = render only, no upload)
+    display_state_t state;        // Render target of this output
+    sensor_data_t last_data;      // Values of the last drawn frame
+    int has_frame;                // 1 once a frame was drawn
+} display_output_t;
+
+static display_output_t outputs[CONFIG_MAX_DEVICES];
+static int output_count = 0;
+static display_output_t default_output; // Used by render_display(); never uploads
+static int link_paused = 0;             // 1 while frames are skipped because the daemon is unavailable
+
+/**
+ * @brief Destroy a surface and clear the pointer to it.
+ * @details No effect if *surface is NULL.
+ * @example
+ *     surface_release(&state->background);
+ */
+static void surface_release(cairo_surface_t **surface) {
+    if (*surface) {
+        cairo_surface_destroy(*surface);
+        *surface = NULL;
     }
+}
 
-    // Create Cairo surface for drawing
-    surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, config->display_width, config->display_height);
-    if (!surface || cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
-        goto cleanup;
+/**
+ * @brief Free the cached bar layers.
+ * @details Leaves the layers empty so prepare_background() rebuilds them.
+ * @example
+ *     bar_layers_release(&state->bars);
+ */
+static void bar_layers_release(bar_layers_t *bars) {
+    surface_release(&bars->frame);
+    surface_release(&bars->inside);
+    for (int k = 0; k <= BAR_END_WIDTH; ++k) {
+        surface_release(&bars->ends[k]);
     }
+    bars->margin = 0;
+}
 
-    cr = cairo_create(surface);
-    if (!cr || cairo_status(cr) != CAIRO_STATUS_SUCCESS) {
-        goto cleanup;
+/**
+ * @brief Free the persistent render target.
+ * @details Destroys the cached background and bar layers, context and surface and frees the pixel buffer. Leaves the state empty so the next frame rebuilds it.
+ * @example
+ *     display_state_release(state);
+ */
+static void display_state_release(display_state_t *state) {
+    surface_release(&state->background);
+    bar_layers_release(&state->bars);
+    if (state->cr) {
+        cairo_destroy(state->cr);
+        state->cr = NULL;
+    }
+    if (state->surface) {
+        cairo_surface_destroy(state->surface);
+        state->surface = NULL;
     }
+    if (state->pixels) {
+        free(state->pixels);
+        state->pixels = NULL;
+    }
+    state->width = 0;
+    state->height = 0;
+}
 
-    // Fill background with black
-    cairo_set_source_rgb(cr, 0, 0, 0);
-    cairo_paint(cr);
+/**
+ * @brief Ensure the persistent render target matches the configuration.
+ * @details Reuses the existing buffer, surface and context if the resolution is unchanged. Otherwise (first frame or resolution change) allocates a 64-byte aligned buffer with a 64-byte aligned row stride and wraps it in a new surface and context. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!display_state_prepare(state, config)) return 0;
+ */
+static int display_state_prepare(display_state_t *state, const Config *config) {
+    if (state->cr && state->width == config->display_width && state->height == config->display_height) {
+        return 1;
+    }
+    display_state_release(state);
+    if (config->display_width <= 0 || config->display_height <= 0) return 0;
 
-    // Draw labels (CPU/GPU)
-    draw_labels(cr, config);
+    int stride = cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, config->display_width);
+    if (stride <= 0) return 0;
+    stride = (stride + DISPLAY_BUFFER_ALIGN - 1) / DISPLAY_BUFFER_ALIGN * DISPLAY_BUFFER_ALIGN;
+    void *pixels = NULL;
+    if (posix_memalign(&pixels, DISPLAY_BUFFER_ALIGN, (size_t)stride * (size_t)config->display_height) != 0) {
+        return 0;
+    }
+    state->pixels = pixels;
+    state->surface = cairo_image_surface_create_for_data(state->pixels, CAIRO_FORMAT_RGB24,
+                                                         config->display_width, config->display_height, stride);
+    if (cairo_surface_status(state->surface) != CAIRO_STATUS_SUCCESS) {
+        display_state_release(state);
+        return 0;
+    }
+    state->cr = cairo_create(state->surface);
+    if (cairo_status(state->cr) != CAIRO_STATUS_SUCCESS) {
+        display_state_release(state);
+        return 0;
+    }
+    state->width = config->display_width;
+    state->height = config->display_height;
+    return 1;
+}
 
-    // Draw temperature values
-    draw_temperature_displays(cr, data, config);
+/**
+ * @brief Release all resources of one output.
+ * @details Frees the render target, glyph atlas and PNG buffer and resets change detection.
+ * @example
+ *     display_output_release(&outputs[i]);
+ */
+static void display_output_release(display_output_t *output) {
+    display_state_t *state = &output->state;
+    display_state_release(state);
+    glyph_atlas_release(&state->glyphs);
+    free(state->png.data);
+    state->png.data = NULL;
+    state->png.size = 0;
+    state->png.capacity = 0;
+    output->has_frame = 0;
+}
 
-    // Draw temperature bars
-    draw_temperature_bars(cr, data, config);
+/**
+ * @brief Release display rendering resources.
+ * @details Frees the persistent render targets of all outputs and forgets the outputs. Safe to call if nothing was rendered yet.
+ * @example
+ *     cleanup_display();
+ */
+void cleanup_display(void) {
+    for (int i = 0; i < output_count; ++i) {
+        display_output_release(&outputs[i]);
+    }
+    output_count = 0;
+    display_output_release(&default_output);
+}
 
-    // Ensure image directory exists
+/**
+ * @brief Add an LCD output driven by draw_combined_image().
+ * @details The configuration is copied, so per-device overrides stay independent of the base configuration. Returns 1 on success, 0 if CONFIG_MAX_DEVICES outputs exist or the arguments are invalid.
+ * @example
+ *     display_add_output(&device_config, uid);
+ */
+int display_add_output(const Config *config, const char *device_uid) {
+    if (!config || !device_uid || !device_uid[0] || output_count >= CONFIG_MAX_DEVICES) return 0;
+    display_output_t *output = &outputs[output_count];
+    memset(output, 0, sizeof(*output));
+    output->config = *config;
+    snprintf(output->device_uid, sizeof(output->device_uid), "%s", device_uid);
+    output_count++;
+    return 1;
+}
+
+/**
+ * @brief Replace the configuration of an output.
+ * @details Used by the configuration reload. The render target, background layer and glyph atlas are keyed by the values they were built from, so only the caches the change invalidates are rebuilt on the next frame; the next frame is drawn regardless of change detection. Returns 1 on success, 0 for an invalid index.
+ * @example
+ *     display_set_output_config(i, &device_config);
+ */
+int display_set_output_config(int index, const Config *config) {
+    if (!config || index < 0 || index >= output_count) return 0;
+    outputs[index].config = *config;
+    outputs[index].has_frame = 0;
+    return 1;
+}
+
+/**
+ * @brief Draw the next frame of every output regardless of change detection.
+ * @details Needed after a configuration change that does not alter the temperatures, e.g. a new color or brightness. A glyph atlas that failed to build is attempted once more, since the font may have been installed meanwhile.
+ * @example
+ *     display_redraw();
+ */
+void display_redraw(void) {
+    default_output.has_frame = 0;
+    glyph_atlas_retry(&default_output.state.glyphs);
+    for (int i = 0; i < output_count; ++i) {
+        outputs[i].has_frame = 0;
+        glyph_atlas_retry(&outputs[i].state.glyphs);
+    }
+}
+
+/**
+ * @brief Return the number of outputs added with display_add_output().
+ * @details Zero means draw_combined_image() renders the single cached device.
+ * @example
+ *     for (int i = 0; i < display_output_count(); ++i) { ... }
+ */
+int display_output_count(void) {
+    return output_count;
+}
+
+/**
+ * @brief Return the configuration of an output.
+ * @details Returns NULL for an invalid index.
+ * @example
+ *     const Config *device_config = display_output_config(i);
+ */
+const Config *display_output_config(int index) {
+    return index >= 0 && index < output_count ? &outputs[index].config : NULL;
+}
+
+/**
+ * @brief Return the device UID of an output.
+ * @details Returns NULL for an invalid index.
+ * @example
+ *     const char *uid = display_output_uid(i);
+ */
+const char *display_output_uid(int index) {
+    return index >= 0 && index < output_count ? outputs[index].device_uid : NULL;
+}
+
+/**
+ * @brief Cairo PNG stream callback appending to a png_buffer_t.
+ * @details Grows the buffer by doubling when needed. Returns CAIRO_STATUS_WRITE_ERROR if memory cannot be allocated.
+ * @example
+ *     cairo_surface_write_to_png_stream(surface, png_buffer_write, &state->png);
+ */
+static cairo_status_t png_buffer_write(void *closure, const unsigned char *data, unsigned int length) {
+    png_buffer_t *png = closure;
+    if (png->size + length > png->capacity) {
+        size_t capacity = png->capacity ? png->capacity : PNG_BUFFER_INITIAL_SIZE;
+        while (capacity < png->size + length) capacity *= 2;
+        unsigned char *grown = realloc(png->data, capacity);
+        if (!grown) return CAIRO_STATUS_WRITE_ERROR;
+        png->data = grown;
+        png->capacity = capacity;
+    }
+    memcpy(png->data + png->size, data, length);
+    png->size += length;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Write the encoded frame to config->image_path (debug sink).
+ * @details Only used when write_image is enabled in the configuration. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (config->write_image) write_debug_image(config, &state->png);
+ */
+static int write_debug_image(const Config *config, const png_buffer_t *png) {
     struct stat st = {0};
     if (stat(config->image_dir, &st) == -1) {
         mkdir(config->image_dir, 0755);
     }
+    FILE *file = fopen(config->image_path, "wb");
+    if (!file) return 0;
+    size_t written = fwrite(png->data, 1, png->size, file);
+    return fclose(file) == 0 && written == png->size;
+}
 
-    // Save PNG image
-    if (cairo_surface_write_to_png(surface, config->image_path) == CAIRO_STATUS_SUCCESS) {
-        fflush(NULL); // Ensure PNG is written before upload
-        success = 1;
+/**
+ * @brief Forward declarations for internal display rendering functions.
+ * @details These functions are only used internally in display.c for modular rendering logic.
+ * @example
+ *     // Not intended for direct use; see render_display() and draw_combined_image().
+ */
+static void draw_temperature_bars(cairo_t *cr, const bar_layers_t *bars, const sensor_data_t *data, const Config *config);
+static void draw_temperature_displays(cairo_t *cr, glyph_atlas_t *glyphs, const sensor_data_t *data, const Config *config);
+static void draw_labels(cairo_t *cr, const Config *config);
+static int prepare_background(display_state_t *state, const Config *config);
+static int should_update_display(display_output_t *output, const sensor_data_t *data, const Config *config);
 
-        // Upload image to LCD if session is initialized
-        if (is_session_initialized()) {
-            const char* device_uid = get_cached_device_uid();
-            if (device_uid[0]) {
-                // Send image to LCD (double send for reliability)
-                send_image_to_lcd(config, config->image_path, device_uid);
-                send_image_to_lcd(config, config->image_path, device_uid);
-            }
-        }
+/**
+ * @brief Draw one frame into the persistent render target.
+ * @details Prepares the target and the cached layers, then draws the frame from them: one blit of the background, the temperature text, and per bar its cached frame and fill. Once the caches are built this allocates nothing. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!draw_frame(state, config, data)) return 0;
+ */
+static int draw_frame(display_state_t *state, const Config *config, const sensor_data_t *data) {
+    // Reuse persistent surface/context (rebuilt only on resolution change)
+    if (!display_state_prepare(state, config)) {
+        return 0;
     }
+    // Static layers (labels, bar troughs, borders, fill masks) are rendered once and cached
+    if (!prepare_background(state, config)) {
+        return 0;
+    }
+    cairo_t *cr = state->cr;
+    cairo_save(cr); // Frame-local state (source, font, clip) is dropped by cairo_restore()
+    cairo_new_path(cr);
 
-cleanup:
-    // Free Cairo resources
-    if (cr) {
-        cairo_destroy(cr);
-        cr = NULL;
+    // Start the frame with a single blit of the cached background
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cr, state->background, 0, 0);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    // Draw temperature values; the bars are painted over them, as in a full redraw
+    draw_temperature_displays(cr, &state->glyphs, data, config);
+
+    // Draw the bars from their cached layers
+    draw_temperature_bars(cr, &state->bars, data, config);
+
+    cairo_restore(cr);
+    cairo_surface_flush(state->surface);
+    return 1;
+}
+
+/**
+ * @brief Render one output based on sensor data (only default mode).
+ * @details Renders the LCD display image using the provided sensor data into the output's persistent render target. Handles drawing, saving, and uploading the image to the output's device; an output without device (the default output) is only rendered.
+ * @example
+ *     render_output(&outputs[i], &outputs[i].config, &sensor_data);
+ */
+static int render_output(display_output_t *output, const Config *config, const sensor_data_t *data) {
+    display_state_t *state = &output->state;
+    int success = 0;
+
+    // Only update if sensor data changed significantly
+    if (!should_update_display(output, data, config)) {
+        return 1; // No update needed, but no error
     }
-    if (surface) {
-        cairo_surface_destroy(surface);
-        surface = NULL;
+
+    if (!draw_frame(state, config, data)) {
+        return 0;
+    }
+
+    // Encode PNG into the reusable in-memory buffer
+    state->png.size = 0;
+    if (cairo_surface_write_to_png_stream(state->surface, png_buffer_write, &state->png) == CAIRO_STATUS_SUCCESS) {
+        success = 1;
+
+        // Optional debug copy on disk
+        if (config->write_image && !write_debug_image(config, &state->png)) {
+            fprintf(stderr, "[CoolerDash] Warning: Could not write debug image %s\n", config->image_path);
+        }
+
+        // Hand the frame to the upload worker (never blocks on the network)
+        const char* device_uid = output->device_uid;
+        if (!device_uid[0]) {
+            // Default output: render only
+        } else if (uploader_is_running()) {
+            uploader_submit(config, device_uid, state->png.data, state->png.size);
+        } else if (is_session_initialized()) {
+            // Send image to LCD (acknowledged, retried on failure)
+            send_image_data_to_lcd(config, state->png.data, state->png.size, device_uid);
+        }
     }
 
     return success;
 }
 
+/**
+ * @brief Render display based on sensor data (only default mode).
+ * @details Renders the LCD display image using the provided sensor data into a render target of its own and writes the debug copy if enabled. The frame is not uploaded; LCDs are driven through the outputs added with display_add_output().
+ * @example
+ *     int result = render_display(&config, &sensor_data);
+ */
+int render_display(const Config *config, const sensor_data_t *data) {
+    if (!data || !config) return 0;
+    return render_output(&default_output, config, data);
+}
+
+/**
+ * @brief Draw a frame like render_display() without encoding it.
+ * @details See header.
+ * @example
+ *     draw_display_frame(&config, &sensor_data);
+ */
+int draw_display_frame(const Config *config, const sensor_data_t *data) {
+    if (!data || !config) return 0;
+    return draw_frame(&default_output.state, config, data);
+}
+
+/**
+ * @brief Draw one temperature string at a baseline position.
+ * @details Blits cached glyph masks when an atlas is available, otherwise falls back to cairo_show_text() with the font already selected on cr.
+ * @example
+ *     draw_temperature_text(cr, atlas, "42\xC2\xB0", x, y);
+ */
+static void draw_temperature_text(cairo_t *cr, const glyph_atlas_t *atlas, const char *text, double x, double y) {
+    if (atlas) {
+        glyph_atlas_draw(cr, atlas, text, x, y);
+        return;
+    }
+    cairo_move_to(cr, x, y);
+    cairo_show_text(cr, text);
+}
+
 /**
  * @brief Draw temperature displays (large numbers for CPU, GPU).
  * @details Draws the temperature values for CPU and GPU in their respective boxes according to the 240x240px layout. CPU and GPU temperatures are centered in their boxes.
  * @example
- *     draw_temperature_displays(cr, &sensor_data);
+ *     draw_temperature_displays(cr, &state->glyphs, &sensor_data, config);
  */
-static void draw_temperature_displays(cairo_t *cr, const sensor_data_t *data, const Config *config) {
+static void draw_temperature_displays(cairo_t *cr, glyph_atlas_t *glyphs, const sensor_data_t *data, const Config *config) {
     // Box positions for 240x240 layout, two boxes (top/bottom)
     const int cpu_box_x = 0; // top box, full width
     const int cpu_box_y = 0 ;
     const int gpu_box_x = 0; // bottom box, full width
     const int gpu_box_y = config->box_height;
     
-    // Set font and size
-    cairo_select_font_face(cr, config->font_face, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    // Glyph masks for the temperature font (rebuilt only when face or size changes)
+    const glyph_atlas_t *atlas = glyph_atlas_prepare(glyphs, config) ? glyphs : NULL;
+    if (!atlas) {
+        cairo_select_font_face(cr, config->font_face, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+        cairo_set_font_size(cr, config->font_size_temp);
+    }
     cairo_set_source_rgb(cr, config->color_txt_temp.r / 255.0, config->color_txt_temp.g / 255.0, config->color_txt_temp.b / 255.0);
 
     char temp_str[8];
@@ -165,121 +541,252 @@ static void draw_temperature_displays(cairo_t *cr, const sensor_data_t *data, co
 
     // CPU temperature display (number + degree symbol in one string)
     snprintf(temp_str, sizeof(temp_str), "%d\xC2\xB0", (int)data->cpu_temp);
-    cairo_set_font_size(cr, config->font_size_temp);
-    cairo_text_extents(cr, temp_str, &ext);
+    if (atlas) glyph_atlas_measure(atlas, temp_str, &ext);
+    else cairo_text_extents(cr, temp_str, &ext);
     // Centered in top box (no bearing correction)
     const double cpu_temp_x = cpu_box_x + (config->box_width - ext.width) / 2 + 22;
     const double cpu_temp_y = cpu_box_y + (config->box_height + ext.height) / 2 - 22;
-    cairo_move_to(cr, cpu_temp_x, cpu_temp_y);
-    cairo_show_text(cr, temp_str);
+    draw_temperature_text(cr, atlas, temp_str, cpu_temp_x, cpu_temp_y);
 
     // GPU temperature display (number + degree symbol in one string)
     snprintf(temp_str, sizeof(temp_str), "%d\xC2\xB0", (int)data->gpu_temp);
-    cairo_set_font_size(cr, config->font_size_temp);
-    cairo_text_extents(cr, temp_str, &ext);
+    if (atlas) glyph_atlas_measure(atlas, temp_str, &ext);
+    else cairo_text_extents(cr, temp_str, &ext);
     // Centered in bottom box (no bearing correction)
     const double gpu_temp_x = gpu_box_x + (config->box_width - ext.width) / 2 + 22;
     const double gpu_temp_y = gpu_box_y + (config->box_height + ext.height) / 2 + 22;
-    cairo_move_to(cr, gpu_temp_x, gpu_temp_y);
-    cairo_show_text(cr, temp_str);
+    draw_temperature_text(cr, atlas, temp_str, gpu_temp_x, gpu_temp_y);
 }
 
 /**
- * @brief Draw temperature bars (CPU and GPU).
- * @details Draws horizontal bars representing CPU and GPU temperatures, with color gradient according to temperature value. Uses cairo for drawing, clamps values to valid range, and handles rounded corners. No resources are allocated in this function.
+ * @brief Compute bar positions from the layout configuration.
+ * @details Bars are centered horizontally; CPU and GPU bars are stacked around the vertical center with bar_gap between them.
  * @example
- *     draw_temperature_bars(cr, &sensor_data);
+ *     int bar_x, cpu_bar_y, gpu_bar_y;
+ *     bar_geometry(config, &bar_x, &cpu_bar_y, &gpu_bar_y);
  */
-static void draw_temperature_bars(cairo_t *cr, const sensor_data_t *data, const Config *config) {
-    // Calculate horizontal position (centered)
-    const int bar_x = (config->display_width - config->bar_width) / 2;
-    // Calculate vertical positions for CPU and GPU bars
-    const int cpu_bar_y = (config->display_height - (2 * config->bar_height + config->bar_gap)) / 2 + 1;
-    const int gpu_bar_y = cpu_bar_y + config->bar_height + config->bar_gap;
-    
-    // --- CPU bar ---
-    int r, g, b;
-    lerp_temp_color(config, data->cpu_temp, &r, &g, &b); // Get color for CPU temperature
-    const int cpu_val_w = (data->cpu_temp > 0.0f) ? 
-        (int)((data->cpu_temp / 100.0f) * config->bar_width) : 0; // Calculate filled width
-    const int safe_cpu_val_w = (cpu_val_w < 0) ? 0 : 
-        (cpu_val_w > config->bar_width) ? config->bar_width : cpu_val_w; // Clamp to valid range
-    
-    // Draw CPU bar background (rounded corners)
-    double radius = 8.0; // Corner radius in px
-    cairo_set_source_rgb(cr, config->color_bg_bar.r / 255.0, config->color_bg_bar.g / 255.0, config->color_bg_bar.b / 255.0);
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, bar_x + config->bar_width - radius, cpu_bar_y + radius, radius, -M_PI_2, 0);
-    cairo_arc(cr, bar_x + config->bar_width - radius, cpu_bar_y + config->bar_height - radius, radius, 0, M_PI_2);
-    cairo_arc(cr, bar_x + radius, cpu_bar_y + config->bar_height - radius, radius, M_PI_2, M_PI);
-    cairo_arc(cr, bar_x + radius, cpu_bar_y + radius, radius, M_PI, 1.5 * M_PI);
-    cairo_close_path(cr);
-    cairo_fill(cr);
-    // Draw CPU bar fill (temperature color, rounded)
-    cairo_set_source_rgb(cr, r/255.0, g/255.0, b/255.0);
-    double fill_width = safe_cpu_val_w;
+static void bar_geometry(const Config *config, int *bar_x, int *cpu_bar_y, int *gpu_bar_y) {
+    *bar_x = (config->display_width - config->bar_width) / 2;
+    *cpu_bar_y = (config->display_height - (2 * config->bar_height + config->bar_gap)) / 2 + 1;
+    *gpu_bar_y = *cpu_bar_y + config->bar_height + config->bar_gap;
+}
+
+/**
+ * @brief Add a rounded rectangle sub-path.
+ * @details Builds the bar outline from four quarter arcs. No drawing is done; the caller fills, strokes or clips.
+ * @example
+ *     rounded_rect_path(cr, x, y, w, h, 8.0);
+ *     cairo_fill(cr);
+ */
+static void rounded_rect_path(cairo_t *cr, double x, double y, double w, double h, double radius) {
     cairo_new_sub_path(cr);
-    if (fill_width > 2 * radius) {
-        cairo_arc(cr, bar_x + fill_width - radius, cpu_bar_y + radius, radius, -M_PI_2, 0);
-        cairo_arc(cr, bar_x + fill_width - radius, cpu_bar_y + config->bar_height - radius, radius, 0, M_PI_2);
-        cairo_arc(cr, bar_x + radius, cpu_bar_y + config->bar_height - radius, radius, M_PI_2, M_PI);
-        cairo_arc(cr, bar_x + radius, cpu_bar_y + radius, radius, M_PI, 1.5 * M_PI);
-    } else {
-        // If fill is too small, draw as rectangle
-        cairo_rectangle(cr, bar_x, cpu_bar_y, fill_width, config->bar_height);
-    }
+    cairo_arc(cr, x + w - radius, y + radius, radius, -M_PI_2, 0);
+    cairo_arc(cr, x + w - radius, y + h - radius, radius, 0, M_PI_2);
+    cairo_arc(cr, x + radius, y + h - radius, radius, M_PI_2, M_PI);
+    cairo_arc(cr, x + radius, y + radius, radius, M_PI, 1.5 * M_PI);
     cairo_close_path(cr);
+}
+
+/**
+ * @brief Draw the static part of one bar (trough and border).
+ * @details Fills the rounded trough with the bar background color and strokes its border. Rendered into the cached bar frame only.
+ * @example
+ *     draw_bar_static(cr, config, bar_x, cpu_bar_y);
+ */
+static void draw_bar_static(cairo_t *cr, const Config *config, int bar_x, int bar_y) {
+    rounded_rect_path(cr, bar_x, bar_y, config->bar_width, config->bar_height, BAR_RADIUS);
+    cairo_set_source_rgb(cr, config->color_bg_bar.r / 255.0, config->color_bg_bar.g / 255.0, config->color_bg_bar.b / 255.0);
     cairo_fill(cr);
-    // Draw CPU bar border (rounded)
+    rounded_rect_path(cr, bar_x, bar_y, config->bar_width, config->bar_height, BAR_RADIUS);
     cairo_set_line_width(cr, config->border_line_width);
     cairo_set_source_rgb(cr, config->color_border_bar.r / 255.0, config->color_border_bar.g / 255.0, config->color_border_bar.b / 255.0);
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, bar_x + config->bar_width - radius, cpu_bar_y + radius, radius, -M_PI_2, 0);
-    cairo_arc(cr, bar_x + config->bar_width - radius, cpu_bar_y + config->bar_height - radius, radius, 0, M_PI_2);
-    cairo_arc(cr, bar_x + radius, cpu_bar_y + config->bar_height - radius, radius, M_PI_2, M_PI);
-    cairo_arc(cr, bar_x + radius, cpu_bar_y + radius, radius, M_PI, 1.5 * M_PI);
-    cairo_close_path(cr);
     cairo_stroke(cr);
+}
 
-    // --- GPU bar ---
-    lerp_temp_color(config, data->gpu_temp, &r, &g, &b); // Get color for GPU temperature
-    const int gpu_val_w = (data->gpu_temp > 0.0f) ? 
-        (int)((data->gpu_temp / 100.0f) * config->bar_width) : 0; // Calculate filled width
-    const int safe_gpu_val_w = (gpu_val_w < 0) ? 0 : 
-        (gpu_val_w > config->bar_width) ? config->bar_width : gpu_val_w; // Clamp to valid range
-    // Draw GPU bar background (rounded corners)
-    cairo_set_source_rgb(cr, config->color_bg_bar.r / 255.0, config->color_bg_bar.g / 255.0, config->color_bg_bar.b / 255.0);
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, bar_x + config->bar_width - radius, gpu_bar_y + radius, radius, -M_PI_2, 0);
-    cairo_arc(cr, bar_x + config->bar_width - radius, gpu_bar_y + config->bar_height - radius, radius, 0, M_PI_2);
-    cairo_arc(cr, bar_x + radius, gpu_bar_y + config->bar_height - radius, radius, M_PI_2, M_PI);
-    cairo_arc(cr, bar_x + radius, gpu_bar_y + radius, radius, M_PI, 1.5 * M_PI);
-    cairo_close_path(cr);
-    cairo_fill(cr);
-    // Draw GPU bar fill (temperature color, rounded)
-    cairo_set_source_rgb(cr, r/255.0, g/255.0, b/255.0);
-    fill_width = safe_gpu_val_w;
-    cairo_new_sub_path(cr);
-    if (fill_width > 2 * radius) {
-        cairo_arc(cr, bar_x + fill_width - radius, gpu_bar_y + radius, radius, -M_PI_2, 0);
-        cairo_arc(cr, bar_x + fill_width - radius, gpu_bar_y + config->bar_height - radius, radius, 0, M_PI_2);
-        cairo_arc(cr, bar_x + radius, gpu_bar_y + config->bar_height - radius, radius, M_PI_2, M_PI);
-        cairo_arc(cr, bar_x + radius, gpu_bar_y + radius, radius, M_PI, 1.5 * M_PI);
-    } else {
-        cairo_rectangle(cr, bar_x, gpu_bar_y, fill_width, config->bar_height);
+/**
+ * @brief Draw one bar: its cached frame and the dynamic fill.
+ * @details The frame (trough and border) is painted over whatever text is underneath. The temperature-colored fill goes through the cached inside mask, cut at a pixel-aligned rectangle, plus the cached rounded end, so the border pixels stay exactly as if the border had been stroked after the fill. No clip path is built and nothing is allocated.
+ * @example
+ *     draw_bar(cr, &state->bars, config, bar_x, cpu_bar_y, data->cpu_temp);
+ */
+static void draw_bar(cairo_t *cr, const bar_layers_t *bars, const Config *config, int bar_x, int bar_y, float temp) {
+    cairo_set_source_surface(cr, bars->frame, bar_x - bars->margin, bar_y - bars->margin);
+    cairo_paint(cr);
+
+    int r, g, b;
+    lerp_temp_color(config, temp, &r, &g, &b); // Get color for temperature
+    const int val_w = (temp > 0.0f) ? (int)((temp / 100.0f) * config->bar_width) : 0; // Calculate filled width
+    const int safe_val_w = (val_w < 0) ? 0 :
+        (val_w > config->bar_width) ? config->bar_width : val_w; // Clamp to valid range
+    if (safe_val_w == 0) return;
+
+    // A fill too small for rounded ends is a plain rectangle
+    const int end_width = safe_val_w > 2 * BAR_RADIUS ? BAR_END_WIDTH : 0;
+    cairo_set_source_rgb(cr, r / 255.0, g / 255.0, b / 255.0);
+    cairo_save(cr);
+    cairo_rectangle(cr, bar_x, bar_y, safe_val_w - end_width, config->bar_height);
+    cairo_clip(cr);
+    cairo_mask_surface(cr, bars->inside, bar_x, bar_y);
+    cairo_restore(cr);
+    if (end_width) {
+        const int before_end = config->bar_width - safe_val_w;
+        cairo_mask_surface(cr, bars->ends[before_end < BAR_END_WIDTH ? before_end : BAR_END_WIDTH],
+                           bar_x + safe_val_w - end_width, bar_y);
     }
-    cairo_close_path(cr);
+}
+
+/**
+ * @brief Draw the temperature bars (CPU and GPU).
+ * @details Draws both bars from the cached bar layers with their temperature-colored fills. No resources are allocated in this function.
+ * @example
+ *     draw_temperature_bars(cr, &state->bars, &sensor_data, config);
+ */
+static void draw_temperature_bars(cairo_t *cr, const bar_layers_t *bars, const sensor_data_t *data, const Config *config) {
+    int bar_x, cpu_bar_y, gpu_bar_y;
+    bar_geometry(config, &bar_x, &cpu_bar_y, &gpu_bar_y);
+    draw_bar(cr, bars, config, bar_x, cpu_bar_y, data->cpu_temp);
+    draw_bar(cr, bars, config, bar_x, gpu_bar_y, data->gpu_temp);
+}
+
+/**
+ * @brief Add the outline of the inside of a bar border as a sub-path.
+ * @details The outline is the bar outline inset by half the border width, i.e. the inner edge of the stroked border, in bar-local coordinates.
+ * @example
+ *     bar_inside_path(cr, config);
+ *     cairo_fill(cr);
+ */
+static void bar_inside_path(cairo_t *cr, const Config *config) {
+    const double inset = config->border_line_width / 2.0;
+    rounded_rect_path(cr, inset, inset, config->bar_width - 2 * inset, config->bar_height - 2 * inset,
+                      BAR_RADIUS > inset ? BAR_RADIUS - inset : 0.0);
+}
+
+/**
+ * @brief Create a cleared surface and a context drawing into it.
+ * @details Returns the surface and stores the context in *cr, or returns NULL (nothing left allocated) on failure.
+ * @example
+ *     cairo_t *cr;
+ *     cairo_surface_t *mask = layer_create(CAIRO_FORMAT_A8, w, h, &cr);
+ */
+static cairo_surface_t *layer_create(cairo_format_t format, int width, int height, cairo_t **cr) {
+    cairo_surface_t *surface = cairo_image_surface_create(format, width, height);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(surface);
+        return NULL;
+    }
+    *cr = cairo_create(surface);
+    if (cairo_status(*cr) != CAIRO_STATUS_SUCCESS) {
+        cairo_destroy(*cr);
+        cairo_surface_destroy(surface);
+        return NULL;
+    }
+    return surface;
+}
+
+/**
+ * @brief Render the cached bar layers.
+ * @details Draws the bar frame (trough and border) with a margin for the outer half of the border, the inside mask, and the rounded fill ends: ends[k] is the fill of width bar_width - k clipped to the inside, cut to its last BAR_END_WIDTH px. Clip paths are only used here, once per rebuild. Returns 1 on success, 0 on failure (the layers are left empty).
+ * @example
+ *     if (!prepare_bar_layers(&state->bars, config)) return 0;
+ */
+static int prepare_bar_layers(bar_layers_t *bars, const Config *config) {
+    bar_layers_release(bars);
+    if (config->bar_width <= 0 || config->bar_height <= 0) return 0;
+    cairo_t *cr;
+
+    bars->margin = (int)ceil(config->border_line_width / 2.0) + 1;
+    bars->frame = layer_create(CAIRO_FORMAT_ARGB32, config->bar_width + 2 * bars->margin,
+                               config->bar_height + 2 * bars->margin, &cr);
+    if (!bars->frame) return 0;
+    draw_bar_static(cr, config, bars->margin, bars->margin);
+    cairo_destroy(cr);
+    cairo_surface_flush(bars->frame);
+
+    bars->inside = layer_create(CAIRO_FORMAT_A8, config->bar_width, config->bar_height, &cr);
+    if (!bars->inside) {
+        bar_layers_release(bars);
+        return 0;
+    }
+    bar_inside_path(cr, config);
     cairo_fill(cr);
-    // Draw GPU bar border (rounded)
-    cairo_set_line_width(cr, config->border_line_width);
-    cairo_set_source_rgb(cr, config->color_border_bar.r / 255.0, config->color_border_bar.g / 255.0, config->color_border_bar.b / 255.0);
-    cairo_new_sub_path(cr);
-    cairo_arc(cr, bar_x + config->bar_width - radius, gpu_bar_y + radius, radius, -M_PI_2, 0);
-    cairo_arc(cr, bar_x + config->bar_width - radius, gpu_bar_y + config->bar_height - radius, radius, 0, M_PI_2);
-    cairo_arc(cr, bar_x + radius, gpu_bar_y + config->bar_height - radius, radius, M_PI_2, M_PI);
-    cairo_arc(cr, bar_x + radius, gpu_bar_y + radius, radius, M_PI, 1.5 * M_PI);
-    cairo_close_path(cr);
-    cairo_stroke(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(bars->inside);
+
+    for (int k = 0; k <= BAR_END_WIDTH; ++k) {
+        bars->ends[k] = layer_create(CAIRO_FORMAT_A8, BAR_END_WIDTH, config->bar_height, &cr);
+        if (!bars->ends[k]) {
+            bar_layers_release(bars);
+            return 0;
+        }
+        const int fill_width = config->bar_width - k;
+        cairo_translate(cr, BAR_END_WIDTH - fill_width, 0);
+        bar_inside_path(cr, config);
+        cairo_clip(cr);
+        rounded_rect_path(cr, 0, 0, fill_width, config->bar_height, BAR_RADIUS);
+        cairo_fill(cr);
+        cairo_destroy(cr);
+        cairo_surface_flush(bars->ends[k]);
+    }
+    return 1;
+}
+
+/**
+ * @brief Fill a background key from the configuration.
+ * @details Zeroes the key first so it can be compared with memcmp().
+ * @example
+ *     background_key_from_config(&key, config);
+ */
+static void background_key_from_config(background_key_t *key, const Config *config) {
+    memset(key, 0, sizeof(*key));
+    key->width = config->display_width;
+    key->height = config->display_height;
+    key->box_height = config->box_height;
+    key->bar_width = config->bar_width;
+    key->bar_height = config->bar_height;
+    key->bar_gap = config->bar_gap;
+    key->border_line_width = config->border_line_width;
+    key->font_size_labels = config->font_size_labels;
+    strncpy(key->font_face, config->font_face, sizeof(key->font_face) - 1);
+    key->color_txt_label = config->color_txt_label;
+    key->color_bg_bar = config->color_bg_bar;
+    key->color_border_bar = config->color_border_bar;
+}
+
+/**
+ * @brief Ensure the cached background layer is up to date.
+ * @details Renders black fill and CPU/GPU labels into a separate surface and the bar layers (see prepare_bar_layers()) once, and again only when any of the configuration values they depend on change. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!prepare_background(state, config)) return 0;
+ */
+static int prepare_background(display_state_t *state, const Config *config) {
+    background_key_t key;
+    background_key_from_config(&key, config);
+    if (state->background && memcmp(&key, &state->background_key, sizeof(key)) == 0) {
+        return 1;
+    }
+    surface_release(&state->background);
+    if (!prepare_bar_layers(&state->bars, config)) {
+        return 0;
+    }
+    cairo_t *cr;
+    cairo_surface_t *surface = layer_create(CAIRO_FORMAT_RGB24, config->display_width, config->display_height, &cr);
+    if (!surface) {
+        bar_layers_release(&state->bars);
+        return 0;
+    }
+
+    // Fill background with black
+    cairo_set_source_rgb(cr, 0, 0, 0);
+    cairo_paint(cr);
+
+    // Draw labels (CPU/GPU); the bars are painted over them every frame
+    draw_labels(cr, config);
+
+    cairo_destroy(cr);
+    cairo_surface_flush(surface);
+    state->background = surface;
+    state->background_key = key;
+    return 1;
 }
 
 /**
@@ -303,25 +810,24 @@ static void draw_labels(cairo_t *cr, const Config *config) {
 
 /**
  * @brief Check if display update is needed (change detection).
- * @details Compares current sensor data with last drawn values and determines if a redraw is necessary. Uses static variables for last data and first run detection. Returns 1 if update is needed, 0 otherwise.
+ * @details Compares current sensor data with the last values drawn on this output and determines if a redraw is necessary. Returns 1 if update is needed, 0 otherwise.
  * @example
- *     if (should_update_display(&sensor_data, config)) {
+ *     if (should_update_display(output, &sensor_data, config)) {
  *         // redraw
  *     }
  */
-static int should_update_display(const sensor_data_t *data, const Config *config) {
-    static sensor_data_t last_data = {.cpu_temp = -1.0f, .gpu_temp = -1.0f};
-    static int first_run = 1;
-    if (first_run) {
-        first_run = 0;
-        last_data = *data;
+static int should_update_display(display_output_t *output, const sensor_data_t *data, const Config *config) {
+    sensor_data_t *last_data = &output->last_data;
+    if (!output->has_frame) {
+        output->has_frame = 1;
+        *last_data = *data;
         return 1;
     }
     // Check for significant changes (only CPU/GPU temperatures)
     // Uses >= so that a change of exactly config->change_tolerance_temp triggers an update
-    if (fabsf(data->cpu_temp - last_data.cpu_temp) >= config->change_tolerance_temp ||
-        fabsf(data->gpu_temp - last_data.gpu_temp) >= config->change_tolerance_temp) {
-        last_data = *data;
+    if (fabsf(data->cpu_temp - last_data->cpu_temp) >= config->change_tolerance_temp ||
+        fabsf(data->gpu_temp - last_data->gpu_temp) >= config->change_tolerance_temp) {
+        *last_data = *data;
         return 1;
     }
     return 0;
@@ -329,19 +835,30 @@ static int should_update_display(const sensor_data_t *data, const Config *config
 
 /**
  * @brief Collects sensor data and renders display (default mode only).
- * @details Reads all relevant sensor data (CPU and GPU temperatures) and renders the display image. Also uploads the image to the device if available. Handles errors silently and frees all resources. Main entry point for display updates in default mode.
+ * @details Takes the latest snapshot published by the background sampler (lock-free, never waits on a slow sensor) and renders the display image. If the sampler is not running, sensors are sampled inline. The same snapshot is rendered and uploaded for each output added by display_add_output(); without outputs nothing is rendered (see setup_outputs() in main.c). While CoolerControl is unavailable nothing is rendered; the first frame after recovery is drawn unconditionally, since the LCD may have been reset. Handles errors silently. Main entry point for display updates in default mode.
  * @example
  *     draw_combined_image(&config);
  */
 void draw_combined_image(const Config *config) {
+    if (output_count == 0) return; // Idle: no LCD to drive
+    if (!lcd_link_allows_frame()) {
+        // Without the upload worker nobody else drives the health probes
+        if (!uploader_is_running()) service_lcd_link();
+        link_paused = 1;
+        return;
+    }
+    if (link_paused) {
+        link_paused = 0;
+        display_redraw();
+    }
     sensor_data_t sensor_data = {0};
     // Temperatures
-    sensor_data.cpu_temp = read_cpu_temp();
-    sensor_data.gpu_temp = read_gpu_temp(config);
-    // Render display
-    int render_result = render_display(config, &sensor_data);
-    if (render_result == 0) {
-        // Silent continuation on render errors
-        return;
+    if (!sampler_is_running() || !sampler_read(&sensor_data)) {
+        sampler_sample_once(config, &sensor_data);
+    }
+    // Render display (silent continuation on render errors)
+    // One frame per device; uploads of earlier outputs proceed while later ones render
+    for (int i = 0; i < output_count; ++i) {
+        render_output(&outputs[i], &outputs[i].config, &sensor_data);
     }
 }
@@ -0,0 +1,137 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Main thread event loop implementation.
+ * @details Fixed table of sources; the epoll data of each descriptor points at its table slot, so dispatch needs no lookup. Slots freed during a dispatch round are only reused in the next one, so stale events of a removed descriptor can never reach a new handler.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable epoll_create1() flags
+#define _POSIX_C_SOURCE 200809L
+
+// Maximum events handled per wakeup
+#define EVENT_LOOP_MAX_EVENTS 8
+
+// Include project headers
+#include "../include/event_loop.h"
+
+// Include necessary headers
+#include <errno.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+/**
+ * @brief One registered descriptor.
+ * @details fd is -1 for a free slot; retired marks a slot freed during the current dispatch round.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int fd;                    // Registered descriptor (-1 = free)
+    event_handler_fn handler;  // Readiness handler
+    void *user;                // Caller context for handler
+    int retired;               // Freed in this round; not reusable yet
+} event_source_t;
+
+static int epoll_fd = -1;
+static event_source_t sources[EVENT_LOOP_MAX_SOURCES];
+
+/**
+ * @brief Create the epoll instance.
+ * @details Idempotent. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!event_loop_init()) { ... }
+ */
+int event_loop_init(void) {
+    if (epoll_fd >= 0) return 1;
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) return 0;
+    for (int i = 0; i < EVENT_LOOP_MAX_SOURCES; ++i) {
+        sources[i].fd = -1;
+        sources[i].retired = 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Register a descriptor for input readiness.
+ * @details The descriptor stays owned by the caller; remove it before closing. Returns 1 on success, 0 if the table is full or epoll rejects the descriptor.
+ * @example
+ *     event_loop_add(timer_fd, on_timer, &state);
+ */
+int event_loop_add(int fd, event_handler_fn handler, void *user) {
+    if (epoll_fd < 0 || fd < 0 || !handler) return 0;
+    event_source_t *slot = NULL;
+    for (int i = 0; i < EVENT_LOOP_MAX_SOURCES && !slot; ++i) {
+        if (sources[i].fd < 0 && !sources[i].retired) slot = &sources[i];
+    }
+    if (!slot) return 0;
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = slot };
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) return 0;
+    slot->fd = fd;
+    slot->handler = handler;
+    slot->user = user;
+    return 1;
+}
+
+/**
+ * @brief Unregister a descriptor.
+ * @details Pending events of the descriptor in the current dispatch round are dropped. No-op for unknown descriptors.
+ * @example
+ *     event_loop_remove(timer_fd);
+ */
+void event_loop_remove(int fd) {
+    if (epoll_fd < 0 || fd < 0) return;
+    for (int i = 0; i < EVENT_LOOP_MAX_SOURCES; ++i) {
+        if (sources[i].fd != fd) continue;
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        sources[i].fd = -1;
+        sources[i].retired = 1;
+        return;
+    }
+}
+
+/**
+ * @brief Wait for and dispatch events once.
+ * @details Waits up to timeout_ms (-1 = forever) and calls the handlers of all ready descriptors. Returns the number of handlers called, 0 on timeout or EINTR, -1 on error.
+ * @example
+ *     while (running) event_loop_run(-1);
+ */
+int event_loop_run(int timeout_ms) {
+    if (epoll_fd < 0) return -1;
+    struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+    int n = epoll_wait(epoll_fd, events, EVENT_LOOP_MAX_EVENTS, timeout_ms);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+    int called = 0;
+    for (int i = 0; i < n; ++i) {
+        event_source_t *source = events[i].data.ptr;
+        if (source->fd < 0) continue; // Removed by an earlier handler of this round
+        source->handler(source->fd, events[i].events, source->user);
+        called++;
+    }
+    for (int i = 0; i < EVENT_LOOP_MAX_SOURCES; ++i) sources[i].retired = 0;
+    return called;
+}
+
+/**
+ * @brief Close the epoll instance and forget all sources.
+ * @details Registered descriptors are not closed.
+ * @example
+ *     event_loop_cleanup();
+ */
+void event_loop_cleanup(void) {
+    if (epoll_fd >= 0) close(epoll_fd);
+    epoll_fd = -1;
+    for (int i = 0; i < EVENT_LOOP_MAX_SOURCES; ++i) {
+        sources[i].fd = -1;
+        sources[i].retired = 0;
+    }
+}
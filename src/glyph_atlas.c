@@ -0,0 +1,210 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Pre-rasterized glyph atlas implementation for temperature text.
+ * @details Rasterizes the temperature character set once per font configuration and composes strings from the cached masks.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Include project headers
+#include "../include/glyph_atlas.h"
+#include "../include/config.h"
+
+// Include necessary headers
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <cairo/cairo.h>
+
+// Index of the degree sign in the atlas
+#define GLYPH_DEGREE 12
+
+/**
+ * @brief UTF-8 text of each cached glyph, indexed like glyph_atlas_t.glyphs.
+ * @details Digits 0-9, '-', '%' and the degree sign.
+ * @example
+ *     // Not intended for direct use.
+ */
+static const char *const glyph_text[GLYPH_ATLAS_COUNT] = {
+    "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "-", "%", "\xC2\xB0"
+};
+
+/**
+ * @brief Map the next character of a string to an atlas index.
+ * @details Advances *text past the character (1 byte, or 2 for the UTF-8 degree sign). Returns the glyph index or -1 if the character is not cached.
+ * @example
+ *     int idx = next_glyph(&p);
+ */
+static int next_glyph(const char **text) {
+    const unsigned char c = (unsigned char)**text;
+    if (c >= '0' && c <= '9') { (*text)++; return c - '0'; }
+    if (c == '-') { (*text)++; return 10; }
+    if (c == '%') { (*text)++; return 11; }
+    if (c == 0xC2 && (unsigned char)(*text)[1] == 0xB0) { *text += 2; return GLYPH_DEGREE; }
+    if (c) (*text)++;
+    return -1;
+}
+
+/**
+ * @brief Free all glyph masks of an atlas.
+ * @details Safe to call on an empty atlas. Clears the failure latch as well.
+ * @example
+ *     glyph_atlas_release(&atlas);
+ */
+void glyph_atlas_release(glyph_atlas_t *atlas) {
+    if (!atlas) return;
+    for (int i = 0; i < GLYPH_ATLAS_COUNT; ++i) {
+        if (atlas->glyphs[i].mask) {
+            cairo_surface_destroy(atlas->glyphs[i].mask);
+            atlas->glyphs[i].mask = NULL;
+        }
+    }
+    atlas->valid = 0;
+    atlas->failed = 0;
+}
+
+/**
+ * @brief Rasterize one glyph into an A8 mask.
+ * @details Measures the glyph with a scratch context and renders it with a 1px margin. Empty glyphs (no ink) get no mask but keep their advance. A measurement that puts the scratch context into an error state (e.g. a size FreeType rejects) fails the glyph instead of leaving it empty. Returns 1 on success, 0 on failure.
+ * @example
+ *     rasterize_glyph(scratch, config, &atlas->glyphs[i], "7");
+ */
+static int rasterize_glyph(cairo_t *scratch, const Config *config, glyph_t *glyph, const char *text) {
+    cairo_text_extents(scratch, text, &glyph->ext);
+    glyph->mask = NULL;
+    if (cairo_status(scratch) != CAIRO_STATUS_SUCCESS) return 0; // Font could not be scaled; extents are zero
+    if (glyph->ext.width <= 0 || glyph->ext.height <= 0) return 1;
+
+    const int w = (int)ceil(glyph->ext.width) + 2;
+    const int h = (int)ceil(glyph->ext.height) + 2;
+    cairo_surface_t *mask = cairo_image_surface_create(CAIRO_FORMAT_A8, w, h);
+    if (cairo_surface_status(mask) != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(mask);
+        return 0;
+    }
+    cairo_t *cr = cairo_create(mask);
+    cairo_select_font_face(cr, config->font_face, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, config->font_size_temp);
+    glyph->origin_x = 1.0 - glyph->ext.x_bearing;
+    glyph->origin_y = 1.0 - glyph->ext.y_bearing;
+    cairo_move_to(cr, glyph->origin_x, glyph->origin_y);
+    cairo_show_text(cr, text);
+    cairo_status_t status = cairo_status(cr);
+    cairo_destroy(cr);
+    cairo_surface_flush(mask);
+    if (status != CAIRO_STATUS_SUCCESS) {
+        cairo_surface_destroy(mask);
+        return 0;
+    }
+    glyph->mask = mask;
+    return 1;
+}
+
+/**
+ * @brief Ensure the atlas matches the configured temperature font.
+ * @details Compares face and size with the values the atlas was built (or failed to build) for; a change (e.g. after a config edit) triggers a full rebuild. A failed build is remembered for that face and size, so the caller's fallback is used without retrying every frame.
+ * @example
+ *     glyph_atlas_prepare(&atlas, &config);
+ */
+int glyph_atlas_prepare(glyph_atlas_t *atlas, const Config *config) {
+    if (!atlas || !config) return 0;
+    int same_font = atlas->font_size == config->font_size_temp &&
+                    strncmp(atlas->font_face, config->font_face, sizeof(atlas->font_face)) == 0;
+    if (same_font && atlas->valid) return 1;
+    if (same_font && atlas->failed) return 0;
+    glyph_atlas_release(atlas);
+    strncpy(atlas->font_face, config->font_face, sizeof(atlas->font_face) - 1);
+    atlas->font_face[sizeof(atlas->font_face) - 1] = '\0';
+    atlas->font_size = config->font_size_temp;
+
+    cairo_surface_t *scratch_surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+    cairo_t *scratch = cairo_create(scratch_surface);
+    cairo_select_font_face(scratch, config->font_face, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(scratch, config->font_size_temp);
+    int ok = cairo_status(scratch) == CAIRO_STATUS_SUCCESS;
+    for (int i = 0; ok && i < GLYPH_ATLAS_COUNT; ++i) {
+        ok = rasterize_glyph(scratch, config, &atlas->glyphs[i], glyph_text[i]);
+    }
+    cairo_destroy(scratch);
+    cairo_surface_destroy(scratch_surface);
+    if (!ok) {
+        glyph_atlas_release(atlas);
+        atlas->failed = 1;
+        fprintf(stderr, "[CoolerDash] Warning: Could not rasterize the glyph atlas for '%s' at %.1f; drawing temperatures with cairo_show_text()\n",
+                atlas->font_face, atlas->font_size);
+        return 0;
+    }
+    atlas->valid = 1;
+    return 1;
+}
+
+/**
+ * @brief Allow a failed atlas build to be attempted again.
+ * @details The next glyph_atlas_prepare() rebuilds even if face and size are unchanged.
+ * @example
+ *     glyph_atlas_retry(&atlas);
+ */
+void glyph_atlas_retry(glyph_atlas_t *atlas) {
+    if (atlas) atlas->failed = 0;
+}
+
+/**
+ * @brief Measure a string composed from cached glyphs.
+ * @details Accumulates advances and takes the union of the glyph ink boxes.
+ * @example
+ *     glyph_atlas_measure(&atlas, text, &ext);
+ */
+void glyph_atlas_measure(const glyph_atlas_t *atlas, const char *text, cairo_text_extents_t *ext) {
+    memset(ext, 0, sizeof(*ext));
+    double pen_x = 0.0;
+    double min_x = 0.0, max_x = 0.0, min_y = 0.0, max_y = 0.0;
+    int have_ink = 0;
+    while (*text) {
+        int idx = next_glyph(&text);
+        if (idx < 0) continue;
+        const cairo_text_extents_t *g = &atlas->glyphs[idx].ext;
+        if (g->width > 0 && g->height > 0) {
+            const double x0 = pen_x + g->x_bearing, x1 = x0 + g->width;
+            const double y0 = g->y_bearing, y1 = y0 + g->height;
+            if (!have_ink || x0 < min_x) min_x = x0;
+            if (!have_ink || x1 > max_x) max_x = x1;
+            if (!have_ink || y0 < min_y) min_y = y0;
+            if (!have_ink || y1 > max_y) max_y = y1;
+            have_ink = 1;
+        }
+        pen_x += g->x_advance;
+    }
+    if (have_ink) {
+        ext->x_bearing = min_x;
+        ext->y_bearing = min_y;
+        ext->width = max_x - min_x;
+        ext->height = max_y - min_y;
+    }
+    ext->x_advance = pen_x;
+}
+
+/**
+ * @brief Draw a string by blitting cached glyph masks.
+ * @details Mask positions are rounded to whole pixels so the A8 masks are copied without resampling.
+ * @example
+ *     glyph_atlas_draw(cr, &atlas, text, x, y);
+ */
+void glyph_atlas_draw(cairo_t *cr, const glyph_atlas_t *atlas, const char *text, double x, double y) {
+    double pen_x = x;
+    while (*text) {
+        int idx = next_glyph(&text);
+        if (idx < 0) continue;
+        const glyph_t *g = &atlas->glyphs[idx];
+        if (g->mask) {
+            cairo_mask_surface(cr, g->mask, floor(pen_x - g->origin_x + 0.5), floor(y - g->origin_y + 0.5));
+        }
+        pen_x += g->ext.x_advance;
+    }
+}
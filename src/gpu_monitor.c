@@ -13,13 +13,46 @@
  *     See function documentation for usage examples.
  */
 
+// Enable clock_gettime() and nanosleep()
+#define _POSIX_C_SOURCE 200112L
+#define _XOPEN_SOURCE 600
+
+// NVML library loaded at runtime
+#define NVML_LIBRARY "libnvidia-ml.so.1"
+
+// Search path used by execlp() when PATH is not set
+#define SMI_DEFAULT_PATH "/bin:/usr/bin"
+
+// nvidia-smi stream supervision constants
+#define SMI_LINE_SIZE          128
+#define SMI_MIN_INTERVAL_MS    100
+#define SMI_BACKOFF_INITIAL_MS 1000
+#define SMI_BACKOFF_MAX_MS     60000
+
+// A stream that has not delivered a value for this many intervals (plus the start-up grace) is considered hung
+#define SMI_STALE_INTERVALS    3
+#define SMI_START_GRACE_MS     2000
+
+// How long a stopped child may take to exit after SIGTERM before it gets SIGKILL, and the polling step
+#define SMI_STOP_GRACE_MS      200
+#define SMI_STOP_POLL_MS       10
+
 // Include project headers
 #include "../include/gpu_monitor.h"
 #include "../include/config.h"
 
 // Include necessary headers
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
 #include <stdio.h>
-#include <sys/time.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 /**
  * @brief Global variable for GPU availability.
@@ -29,21 +62,279 @@
  */
 static int gpu_available = -1;  // -1 = unknown, 0 = not available, 1 = available
 
+/**
+ * @brief Minimal NVML type definitions.
+ * @details Only the handful of NVML symbols used by CoolerDash are declared here, so no NVIDIA headers are needed at build time. Values match nvml.h.
+ * @example
+ *     // Not intended for direct use; see nvml_load().
+ */
+typedef int nvmlReturn_t;
+typedef struct nvmlDevice_st *nvmlDevice_t;
+#define NVML_SUCCESS 0
+#define NVML_TEMPERATURE_GPU 0
+
+/**
+ * @brief NVML backend state (dlopen()ed at runtime).
+ * @details Holds the library handle, the resolved entry points and the device handle of the first GPU. lib is NULL if NVML is not in use and the nvidia-smi fallback is active.
+ * @example
+ *     // Not intended for direct use; managed by init_gpu_monitor().
+ */
+static struct {
+    void *lib;
+    nvmlDevice_t device;
+    nvmlReturn_t (*init)(void);
+    nvmlReturn_t (*shutdown)(void);
+    nvmlReturn_t (*get_count)(unsigned int *count);
+    nvmlReturn_t (*get_handle)(unsigned int index, nvmlDevice_t *device);
+    nvmlReturn_t (*get_temperature)(nvmlDevice_t device, int sensor, unsigned int *temp);
+} nvml = {0};
+
 /**
  * @brief Get current time in milliseconds.
- * @details Returns the current system time in milliseconds since the epoch.
+ * @details Returns CLOCK_MONOTONIC in milliseconds, so the stale deadline and the restart backoff are not moved by wall-clock changes.
  * @example
  *     long long now = get_current_time_ms();
  */
 static long long get_current_time_ms(void) {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return (long long)(tv.tv_sec) * 1000 + (long long)(tv.tv_usec) / 1000;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Unload the NVML library and reset the backend state.
+ * @details Calls nvmlShutdown() if NVML was initialized and closes the library handle.
+ * @example
+ *     nvml_unload();
+ */
+static void nvml_unload(void) {
+    if (nvml.lib) {
+        if (nvml.device && nvml.shutdown) nvml.shutdown();
+        dlclose(nvml.lib);
+    }
+    nvml.lib = NULL;
+    nvml.device = NULL;
+}
+
+/**
+ * @brief Load NVML at runtime and open the first GPU.
+ * @details dlopen()s libnvidia-ml.so.1, resolves the versioned entry points and initializes NVML. No process is forked. Returns 1 if a GPU handle was obtained, 0 if NVML is missing or unusable (the library is unloaded again in that case).
+ * @example
+ *     if (!nvml_load()) {
+ *         // fall back to nvidia-smi
+ *     }
+ */
+static int nvml_load(void) {
+    nvml.lib = dlopen(NVML_LIBRARY, RTLD_NOW | RTLD_LOCAL);
+    if (!nvml.lib) return 0;
+    nvml.init = (nvmlReturn_t (*)(void))dlsym(nvml.lib, "nvmlInit_v2");
+    nvml.shutdown = (nvmlReturn_t (*)(void))dlsym(nvml.lib, "nvmlShutdown");
+    nvml.get_count = (nvmlReturn_t (*)(unsigned int *))dlsym(nvml.lib, "nvmlDeviceGetCount_v2");
+    nvml.get_handle = (nvmlReturn_t (*)(unsigned int, nvmlDevice_t *))dlsym(nvml.lib, "nvmlDeviceGetHandleByIndex_v2");
+    nvml.get_temperature = (nvmlReturn_t (*)(nvmlDevice_t, int, unsigned int *))dlsym(nvml.lib, "nvmlDeviceGetTemperature");
+    if (!nvml.init || !nvml.shutdown || !nvml.get_count || !nvml.get_handle || !nvml.get_temperature ||
+        nvml.init() != NVML_SUCCESS) {
+        nvml_unload();
+        return 0;
+    }
+    unsigned int count = 0;
+    nvmlDevice_t device = NULL;
+    if (nvml.get_count(&count) != NVML_SUCCESS || count == 0 ||
+        nvml.get_handle(0, &device) != NVML_SUCCESS || !device) {
+        nvml.shutdown();
+        dlclose(nvml.lib);
+        nvml.lib = NULL;
+        return 0;
+    }
+    nvml.device = device;
+    return 1;
+}
+
+/**
+ * @brief Supervised nvidia-smi streaming reader state.
+ * @details Used when NVML is not available. A single long-lived "nvidia-smi -lms" child writes one CSV line per interval into a non-blocking pipe; partial lines are kept in line[] until completed. If the child dies or stops delivering values it is restarted after an exponential backoff, and its last value is dropped.
+ * @example
+ *     // Not intended for direct use; managed by smi_stream_poll().
+ */
+static struct {
+    pid_t pid;                // Child PID, 0 if not running
+    int fd;                   // Read end of the stdout pipe, -1 if closed
+    char line[SMI_LINE_SIZE]; // Partial line carried over between reads
+    size_t line_len;
+    long long restart_at_ms;  // Earliest time for the next (re)start
+    long long backoff_ms;     // Current restart backoff
+    long long interval_ms;    // Interval the running child was started with
+    long long deadline_ms;    // Time by which the next value is due
+    float temp;               // Last value of the running child
+    int has_temp;             // 1 if temp came from the running child
+} smi = { 0, -1, {0}, 0, 0, SMI_BACKOFF_INITIAL_MS, 0, 0, 0.0f, 0 };
+
+/**
+ * @brief Start the long-lived nvidia-smi child.
+ * @details Forks nvidia-smi with "--query-gpu=temperature.gpu --format=csv,noheader,nounits -lms <interval>" for GPU 0, connects its stdout to a non-blocking pipe and discards stderr. The child is called from the sampler thread, which comes and goes with sampler_stop()/sampler_start(), so no parent-death signal is used (it is tied to the forking thread); the child is stopped explicitly by stop_gpu_stream(), and if CoolerDash is killed it dies of SIGPIPE on its next line. Returns 1 if the child was started, 0 otherwise.
+ * @example
+ *     smi_stream_start(&config);
+ */
+static int smi_stream_start(const Config *config) {
+    int pipefd[2];
+    if (pipe(pipefd) != 0) return 0;
+    long long interval_ms = (long long)(config->gpu_cache_interval * 1000);
+    if (interval_ms < SMI_MIN_INTERVAL_MS) interval_ms = SMI_MIN_INTERVAL_MS;
+    char lms[24];
+    snprintf(lms, sizeof(lms), "%lld", interval_ms);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return 0;
+    }
+    if (pid == 0) {
+        // Child: stdout -> pipe, stderr -> /dev/null
+        // The mask is inherited from the forking thread, which blocks all signals; SIGTERM must stay deliverable
+        sigset_t none;
+        sigemptyset(&none);
+        sigprocmask(SIG_SETMASK, &none, NULL);
+        signal(SIGPIPE, SIG_DFL); // Die once CoolerDash is gone and the pipe has no reader
+        dup2(pipefd[1], STDOUT_FILENO);
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) dup2(devnull, STDERR_FILENO);
+        close(pipefd[0]);
+        close(pipefd[1]);
+        execlp("nvidia-smi", "nvidia-smi", "--id=0", "--query-gpu=temperature.gpu",
+               "--format=csv,noheader,nounits", "-lms", lms, (char *)NULL);
+        _exit(127);
+    }
+    close(pipefd[1]);
+    fcntl(pipefd[0], F_SETFL, fcntl(pipefd[0], F_GETFL) | O_NONBLOCK);
+    fcntl(pipefd[0], F_SETFD, FD_CLOEXEC);
+    smi.pid = pid;
+    smi.fd = pipefd[0];
+    smi.line_len = 0;
+    smi.interval_ms = interval_ms;
+    smi.deadline_ms = get_current_time_ms() + SMI_START_GRACE_MS + SMI_STALE_INTERVALS * interval_ms;
+    smi.has_temp = 0;
+    return 1;
+}
+
+/**
+ * @brief Reap the nvidia-smi child, escalating to SIGKILL if it does not exit.
+ * @details Called after SIGTERM. Polls with WNOHANG for up to SMI_STOP_GRACE_MS, then sends SIGKILL and reaps the child, so a hung nvidia-smi cannot stall the main loop for longer than the grace period.
+ * @example
+ *     kill(pid, SIGTERM);
+ *     smi_reap(pid);
+ */
+static void smi_reap(pid_t pid) {
+    const struct timespec step = { 0, SMI_STOP_POLL_MS * 1000000L };
+    const long long deadline_ms = get_current_time_ms() + SMI_STOP_GRACE_MS;
+    do {
+        pid_t r = waitpid(pid, NULL, WNOHANG);
+        if (r == pid || (r < 0 && errno != EINTR)) return; // Reaped, or not our child any more
+        nanosleep(&step, NULL);
+    } while (get_current_time_ms() < deadline_ms);
+    kill(pid, SIGKILL);
+    while (waitpid(pid, NULL, 0) < 0 && errno == EINTR) continue;
+}
+
+/**
+ * @brief Stop the nvidia-smi child and close the pipe.
+ * @details Sends SIGTERM, reaps the child (SIGKILL after SMI_STOP_GRACE_MS), closes the read end and drops the last value. Blocks for at most the grace period.
+ * @example
+ *     smi_stream_stop();
+ */
+static void smi_stream_stop(void) {
+    smi.has_temp = 0;
+    if (smi.pid > 0) {
+        kill(smi.pid, SIGTERM);
+        smi_reap(smi.pid);
+        smi.pid = 0;
+    }
+    if (smi.fd >= 0) {
+        close(smi.fd);
+        smi.fd = -1;
+    }
+}
+
+/**
+ * @brief Drain the nvidia-smi pipe and parse complete lines.
+ * @details Never blocks: reads until EAGAIN, keeps the value of the last complete line and a trailing partial line for the next call. On EOF, child exit or a child that missed SMI_STALE_INTERVALS intervals, the child is stopped and reaped, its value dropped and a restart scheduled with exponential backoff; the backoff resets once a valid line is parsed. Returns 1 and sets *temp if the running child has delivered a current value, 0 otherwise.
+ * @example
+ *     float t;
+ *     if (smi_stream_poll(&config, &t)) { ... }
+ */
+static int smi_stream_poll(const Config *config, float *temp) {
+    long long now_ms = get_current_time_ms();
+    if (smi.fd < 0) {
+        if (now_ms < smi.restart_at_ms || !smi_stream_start(config)) {
+            if (now_ms >= smi.restart_at_ms) smi.restart_at_ms = now_ms + smi.backoff_ms;
+            return 0;
+        }
+    }
+
+    int dead = 0;
+    char buf[256];
+    for (;;) {
+        ssize_t n = read(smi.fd, buf, sizeof(buf));
+        if (n > 0) {
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buf[i] != '\n') {
+                    if (smi.line_len < sizeof(smi.line) - 1) smi.line[smi.line_len++] = buf[i];
+                    continue;
+                }
+                smi.line[smi.line_len] = '\0';
+                char *end = NULL;
+                float value = strtof(smi.line, &end);
+                if (end != smi.line) {
+                    smi.temp = value;
+                    smi.has_temp = 1;
+                    smi.deadline_ms = now_ms + SMI_STALE_INTERVALS * smi.interval_ms;
+                    smi.backoff_ms = SMI_BACKOFF_INITIAL_MS;
+                }
+                smi.line_len = 0;
+            }
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) dead = 1;
+        break;
+    }
+    if (now_ms > smi.deadline_ms) dead = 1; // Hung or no GPU output: treat like an exit
+    if (dead) {
+        // Child exited or missed its deadline: reap it and restart later with exponential backoff
+        smi_stream_stop();
+        smi.restart_at_ms = now_ms + smi.backoff_ms;
+        smi.backoff_ms *= 2;
+        if (smi.backoff_ms > SMI_BACKOFF_MAX_MS) smi.backoff_ms = SMI_BACKOFF_MAX_MS;
+        return 0;
+    }
+    if (smi.has_temp) *temp = smi.temp;
+    return smi.has_temp;
+}
+
+/**
+ * @brief Check whether nvidia-smi can be executed.
+ * @details Searches PATH the way execlp() does, with access() only, so the probe forks nothing. Returns 1 if an executable nvidia-smi was found, 0 otherwise.
+ * @example
+ *     if (smi_on_path()) { ... }
+ */
+static int smi_on_path(void) {
+    const char *path = getenv("PATH");
+    if (!path) path = SMI_DEFAULT_PATH;
+    for (;;) {
+        const char *end = strchr(path, ':');
+        size_t len = end ? (size_t)(end - path) : strlen(path);
+        char candidate[512];
+        if (len == 0) snprintf(candidate, sizeof(candidate), "nvidia-smi"); // Empty entry: current directory
+        else snprintf(candidate, sizeof(candidate), "%.*s/nvidia-smi", (int)len, path);
+        if (len < sizeof(candidate) - sizeof("/nvidia-smi") && access(candidate, X_OK) == 0) return 1;
+        if (!end) return 0;
+        path = end + 1;
+    }
 }
 
 /**
  * @brief Checks GPU availability and initializes GPU monitoring using configuration.
- * @details Checks if an NVIDIA GPU is available and initializes the monitoring backend. Uses config values for cache interval etc. Internally uses popen() to check for nvidia-smi. Always checks and frees resources with pclose().
+ * @details Checks if an NVIDIA GPU is available and initializes the monitoring backend. NVML is tried first via dlopen(); only if it is missing or unusable, PATH is searched for nvidia-smi without running it. Whether nvidia-smi actually sees a GPU is left to the stream started by the first read, which backs off if it reports nothing.
  * @example
  *     if (init_gpu_monitor(&config)) {
  *         // GPU available
@@ -56,25 +347,18 @@ int init_gpu_monitor(const Config *config) {
         return gpu_available;  // Already checked
     }
     
-    FILE *fp = popen("nvidia-smi -L 2>/dev/null", "r");
-    if (fp) {
-        char line[256];
-        if (fgets(line, sizeof(line), fp) != NULL) {
-            gpu_available = 1;  // GPU found
-        } else {
-            gpu_available = 0;  // No GPU found
-        }
-        pclose(fp);
-    } else {
-        gpu_available = 0;  // nvidia-smi not available
+    if (nvml_load()) {
+        gpu_available = 1;  // GPU found via NVML, no nvidia-smi needed
+        return gpu_available;
     }
     
+    gpu_available = smi_on_path();  // nvidia-smi stream fallback, started on the first read
     return gpu_available;
 }
 
 /**
  * @brief Reads only GPU temperature (optimized for mode "def").
- * @details Reads the current temperature from the GPU sensor, with caching for performance. Uses popen() and fscanf() to read the value. Always checks and frees resources with pclose(). Returns 0.0f if no GPU is available or on error.
+ * @details Reads the current temperature from the GPU sensor, with caching for performance. Queries NVML directly when loaded; otherwise takes the latest value from the supervised nvidia-smi stream without blocking. Returns 0.0f if no GPU is available, no value has been received yet or the stream died or stalled.
  * @example
  *     float temp = read_gpu_temp(&config);
  */
@@ -86,15 +370,13 @@ float read_gpu_temp(const Config *config) {
     long long now_ms = get_current_time_ms();
     long long cache_interval_ms = (long long)(config->gpu_cache_interval * 1000);
     
-    if (now_ms - last_update_ms >= cache_interval_ms) {
-        FILE *fp = popen("nvidia-smi --query-gpu=temperature.gpu --format=csv,noheader,nounits 2>/dev/null", "r");
-        if (fp) {
-            if (fscanf(fp, "%f", &cached_temp) != 1) {
-                cached_temp = 0.0f;
-            }
-            pclose(fp);
-            last_update_ms = now_ms;
-        }
+    if (now_ms - last_update_ms >= cache_interval_ms && nvml.lib) {
+        unsigned int temp = 0;
+        cached_temp = (nvml.get_temperature(nvml.device, NVML_TEMPERATURE_GPU, &temp) == NVML_SUCCESS) ? (float)temp : 0.0f;
+        last_update_ms = now_ms;
+    } else if (!nvml.lib) {
+        if (!smi_stream_poll(config, &cached_temp)) cached_temp = 0.0f; // Never show the value of a dead stream
+        last_update_ms = now_ms;
     }
     return cached_temp;
 }
@@ -113,3 +395,24 @@ int get_gpu_data_full(const Config *config, gpu_data_t *data) {
     data->temperature = read_gpu_temp(config);
     return 1;
 }
+
+/**
+ * @brief Releases GPU monitoring resources.
+ * @details Stops the nvidia-smi stream child and shuts down and unloads NVML if it was loaded. Safe to call if the GPU monitor was never initialized.
+ * @example
+ *     cleanup_gpu_monitor();
+ */
+void cleanup_gpu_monitor(void) {
+    smi_stream_stop();
+    nvml_unload();
+}
+
+/**
+ * @brief Terminates the nvidia-smi stream child, if any.
+ * @details Called from the main loop on shutdown and on reload. Waits at most SMI_STOP_GRACE_MS for the child to exit before killing it.
+ * @example
+ *     stop_gpu_stream();
+ */
+void stop_gpu_stream(void) {
+    smi_stream_stop();
+}
@@ -0,0 +1,101 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Fixed-memory log-linear histogram implementation.
+ * @details Bucket i below 2 * HISTOGRAM_SUB_BUCKETS holds exactly the value i. Above, a value with its highest bit at position b is shifted right by b - HISTOGRAM_SUB_BITS, leaving a top part in [SUB_BUCKETS, 2 * SUB_BUCKETS); the bucket index is shift * SUB_BUCKETS + top.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Include project headers
+#include "../include/histogram.h"
+
+// Include necessary headers
+#include <stdint.h>
+
+/**
+ * @brief Map a value to its bucket index.
+ * @details Values of 2^HISTOGRAM_MAX_BITS and above land in the last bucket.
+ * @example
+ *     int i = bucket_index(1250);
+ */
+static int bucket_index(uint64_t value) {
+    if (value < 2 * HISTOGRAM_SUB_BUCKETS) return (int)value;
+    int msb = 63 - __builtin_clzll(value);
+    if (msb >= HISTOGRAM_MAX_BITS) return HISTOGRAM_BUCKETS - 1;
+    int shift = msb - HISTOGRAM_SUB_BITS;
+    return shift * HISTOGRAM_SUB_BUCKETS + (int)(value >> shift);
+}
+
+/**
+ * @brief Return the smallest value of a bucket and its width.
+ * @details Inverse of bucket_index().
+ * @example
+ *     uint64_t width;
+ *     uint64_t low = bucket_lower(i, &width);
+ */
+static uint64_t bucket_lower(int index, uint64_t *width) {
+    if (index < 2 * HISTOGRAM_SUB_BUCKETS) {
+        *width = 1;
+        return (uint64_t)index;
+    }
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t top = (uint64_t)(index % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS);
+    *width = 1ULL << shift;
+    return top << shift;
+}
+
+/**
+ * @brief Add one value.
+ * @details Updates the bucket count and the exact count/sum/min/max.
+ * @example
+ *     histogram_record(&h, elapsed_us);
+ */
+void histogram_record(histogram_t *h, uint64_t value) {
+    h->counts[bucket_index(value)]++;
+    if (h->count == 0 || value < h->min) h->min = value;
+    if (h->count == 0 || value > h->max) h->max = value;
+    h->count++;
+    h->sum += value;
+}
+
+/**
+ * @brief Estimate a percentile.
+ * @details Walks the buckets until the cumulative count reaches the rank of p.
+ * @example
+ *     uint64_t p50 = histogram_percentile(&h, 50.0);
+ */
+uint64_t histogram_percentile(const histogram_t *h, double p) {
+    if (h->count == 0) return 0;
+    if (p < 0.0) p = 0.0;
+    if (p > 100.0) p = 100.0;
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)(h->count - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        seen += h->counts[i];
+        if (seen < rank) continue;
+        if (i == HISTOGRAM_BUCKETS - 1) return h->max; // Saturated bucket has no upper bound
+        uint64_t width;
+        uint64_t value = bucket_lower(i, &width) + width / 2;
+        if (value < h->min) value = h->min;
+        if (value > h->max) value = h->max;
+        return value;
+    }
+    return h->max;
+}
+
+/**
+ * @brief Return the mean of all recorded values.
+ * @details Exact, from the running sum.
+ * @example
+ *     double avg = histogram_mean(&h);
+ */
+double histogram_mean(const histogram_t *h) {
+    return h->count ? (double)h->sum / (double)h->count : 0.0;
+}
@@ -0,0 +1,442 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Non-blocking HTTP engine implementation (curl multi + epoll).
+ * @details Implements the curl socket/timer callbacks on top of epoll and a timerfd, deferred request starts, and completion dispatch.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable clock_gettime() and struct itimerspec
+#define _POSIX_C_SOURCE 200809L
+
+// Maximum epoll events handled per http_engine_run() call
+#define HTTP_ENGINE_MAX_EVENTS 16
+
+// Include project headers
+#include "../include/http_engine.h"
+
+// Include necessary headers
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <curl/curl.h>
+
+/**
+ * @brief Engine state.
+ * @details active lists requests added to the multi handle, deferred lists requests waiting for their start time. curl_deadline_ns is the absolute CLOCK_MONOTONIC time curl asked to be called back at (-1 = none). The timerfd is registered in epfd and armed at the earliest of curl_deadline_ns and the first deferred start.
+ * @example
+ *     // Not intended for direct use; managed by module functions.
+ */
+static struct {
+    CURLM *multi;
+    CURLSH *share;
+    int epfd;
+    int timerfd;
+    long long curl_deadline_ns;
+    int running_handles;
+    http_request_t *active;
+    http_request_t *deferred;
+} engine = { NULL, NULL, -1, -1, -1, 0, NULL, NULL };
+
+static http_engine_stats_t stats = {0}; // Updated by the engine thread, read from any thread (__atomic builtins)
+
+/**
+ * @brief Get current CLOCK_MONOTONIC time in nanoseconds.
+ * @details Used for timer deadlines.
+ * @example
+ *     long long now = monotonic_ns();
+ */
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Arm the timerfd at the earliest pending deadline.
+ * @details Disarms it if neither curl nor a deferred request needs a wakeup. Deadlines in the past fire immediately.
+ * @example
+ *     arm_timer();
+ */
+static void arm_timer(void) {
+    long long deadline = engine.curl_deadline_ns;
+    for (http_request_t *req = engine.deferred; req; req = req->next) {
+        if (deadline < 0 || req->due_ns < deadline) deadline = req->due_ns;
+    }
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if (deadline >= 0) {
+        if (deadline <= 0) deadline = 1; // it_value of zero would disarm
+        its.it_value.tv_sec = (time_t)(deadline / 1000000000LL);
+        its.it_value.tv_nsec = (long)(deadline % 1000000000LL);
+    }
+    timerfd_settime(engine.timerfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/**
+ * @brief curl socket callback: mirror curl's interest set into epoll.
+ * @details socketp is non-NULL once the socket has been added to epoll, so the first call adds and later calls modify.
+ * @example
+ *     // Registered with CURLMOPT_SOCKETFUNCTION.
+ */
+static int socket_callback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp) {
+    (void)easy;
+    (void)userp;
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(engine.epfd, EPOLL_CTL_DEL, s, NULL);
+        curl_multi_assign(engine.multi, s, NULL);
+        return 0;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.data.fd = s;
+    if (what & CURL_POLL_IN) ev.events |= EPOLLIN;
+    if (what & CURL_POLL_OUT) ev.events |= EPOLLOUT;
+    if (socketp) {
+        epoll_ctl(engine.epfd, EPOLL_CTL_MOD, s, &ev);
+    } else {
+        if (epoll_ctl(engine.epfd, EPOLL_CTL_ADD, s, &ev) < 0 && errno == EEXIST) {
+            epoll_ctl(engine.epfd, EPOLL_CTL_MOD, s, &ev);
+        }
+        curl_multi_assign(engine.multi, s, &engine);
+    }
+    return 0;
+}
+
+/**
+ * @brief curl timer callback: remember the requested deadline.
+ * @details Must not call back into curl; the timerfd wakes http_engine_run() instead.
+ * @example
+ *     // Registered with CURLMOPT_TIMERFUNCTION.
+ */
+static int timer_callback(CURLM *multi, long timeout_ms, void *userp) {
+    (void)multi;
+    (void)userp;
+    engine.curl_deadline_ns = timeout_ms < 0 ? -1 : monotonic_ns() + (long long)timeout_ms * 1000000LL;
+    arm_timer();
+    return 0;
+}
+
+/**
+ * @brief Unlink a request from a singly linked list.
+ * @details Returns 1 if the request was found and removed, 0 otherwise.
+ * @example
+ *     list_remove(&engine.active, req);
+ */
+static int list_remove(http_request_t **head, http_request_t *req) {
+    for (http_request_t **p = head; *p; p = &(*p)->next) {
+        if (*p == req) {
+            *p = req->next;
+            req->next = NULL;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Create the multi handle, the cookie/DNS share and the epoll/timer descriptors.
+ * @details The timerfd is part of the epoll set, so a single descriptor represents all engine activity.
+ * @example
+ *     http_engine_init();
+ */
+int http_engine_init(void) {
+    if (engine.multi) return 1;
+    engine.epfd = epoll_create1(EPOLL_CLOEXEC);
+    engine.timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    engine.multi = curl_multi_init();
+    engine.share = curl_share_init();
+    if (engine.epfd < 0 || engine.timerfd < 0 || !engine.multi || !engine.share) {
+        http_engine_cleanup();
+        return 0;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = engine.timerfd;
+    if (epoll_ctl(engine.epfd, EPOLL_CTL_ADD, engine.timerfd, &ev) < 0) {
+        http_engine_cleanup();
+        return 0;
+    }
+    curl_share_setopt(engine.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+    curl_share_setopt(engine.share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_multi_setopt(engine.multi, CURLMOPT_SOCKETFUNCTION, socket_callback);
+    curl_multi_setopt(engine.multi, CURLMOPT_TIMERFUNCTION, timer_callback);
+    engine.curl_deadline_ns = -1;
+    return 1;
+}
+
+/**
+ * @brief Create an easy handle attached to the engine's cookie/DNS share.
+ * @details Returns NULL if the engine is not initialized.
+ * @example
+ *     CURL *easy = http_engine_easy();
+ */
+CURL *http_engine_easy(void) {
+    if (!engine.share) return NULL;
+    CURL *easy = curl_easy_init();
+    if (easy) curl_easy_setopt(easy, CURLOPT_SHARE, engine.share);
+    return easy;
+}
+
+/**
+ * @brief Start an asynchronous request.
+ * @details The request pointer is stored as CURLOPT_PRIVATE to find it again on completion.
+ * @example
+ *     http_engine_submit(&req);
+ */
+int http_engine_submit(http_request_t *req) {
+    if (!engine.multi || !req || !req->easy || !req->done) return 0;
+    curl_easy_setopt(req->easy, CURLOPT_PRIVATE, req);
+    if (curl_multi_add_handle(engine.multi, req->easy) != CURLM_OK) return 0;
+    req->next = engine.active;
+    engine.active = req;
+    return 1;
+}
+
+/**
+ * @brief Start an asynchronous request after a delay.
+ * @details A delay of zero or less starts the request immediately.
+ * @example
+ *     http_engine_submit_after(&req, 200);
+ */
+int http_engine_submit_after(http_request_t *req, long delay_ms) {
+    if (delay_ms <= 0) return http_engine_submit(req);
+    if (!engine.multi || !req || !req->easy || !req->done) return 0;
+    req->due_ns = monotonic_ns() + (long long)delay_ms * 1000000LL;
+    req->next = engine.deferred;
+    engine.deferred = req;
+    arm_timer();
+    return 1;
+}
+
+/**
+ * @brief Handle a timerfd expiry.
+ * @details Calls curl's timeout handler if its deadline passed and starts every deferred request whose time has come.
+ * @example
+ *     handle_timer();
+ */
+static void handle_timer(void) {
+    uint64_t expirations;
+    if (read(engine.timerfd, &expirations, sizeof(expirations)) < 0) {
+        // Nothing to read (spurious wakeup); deadlines are checked below anyway
+    }
+    long long now = monotonic_ns();
+    if (engine.curl_deadline_ns >= 0 && now >= engine.curl_deadline_ns) {
+        engine.curl_deadline_ns = -1;
+        curl_multi_socket_action(engine.multi, CURL_SOCKET_TIMEOUT, 0, &engine.running_handles);
+    }
+    http_request_t **p = &engine.deferred;
+    while (*p) {
+        http_request_t *req = *p;
+        if (req->due_ns <= now) {
+            *p = req->next;
+            req->next = NULL;
+            if (!http_engine_submit(req)) {
+                req->done(req, CURLE_FAILED_INIT, 0);
+            }
+        } else {
+            p = &req->next;
+        }
+    }
+}
+
+/**
+ * @brief Dispatch finished transfers.
+ * @details Records connection reuse, then removes each finished handle from the multi handle before calling done(), so the callback may resubmit it. Returns the number of completed requests.
+ * @example
+ *     int completed = dispatch_completions();
+ */
+static int dispatch_completions(void) {
+    int completed = 0;
+    int queued;
+    CURLMsg *msg;
+    while ((msg = curl_multi_info_read(engine.multi, &queued)) != NULL) {
+        if (msg->msg != CURLMSG_DONE) continue;
+        CURL *easy = msg->easy_handle;
+        CURLcode result = msg->data.result;
+        http_request_t *req = NULL;
+        long response_code = 0;
+        long connects = 0;
+        curl_easy_getinfo(easy, CURLINFO_PRIVATE, (char **)&req);
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response_code);
+        curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+        __atomic_fetch_add(&stats.requests, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&stats.new_connections, (unsigned long long)connects, __ATOMIC_RELAXED);
+        if (connects == 0 && result == CURLE_OK) __atomic_fetch_add(&stats.reused, 1, __ATOMIC_RELAXED);
+        curl_multi_remove_handle(engine.multi, easy);
+        if (!req) continue;
+        list_remove(&engine.active, req);
+        completed++;
+        req->done(req, result, response_code);
+    }
+    return completed;
+}
+
+/**
+ * @brief Wait for and process engine events.
+ * @details Socket events are translated to CURL_CSELECT_* flags; errors and hangups are reported as readable so curl sees them.
+ * @example
+ *     http_engine_run(-1);
+ */
+int http_engine_run(int timeout_ms) {
+    if (!engine.multi) return -1;
+    struct epoll_event events[HTTP_ENGINE_MAX_EVENTS];
+    int n = epoll_wait(engine.epfd, events, HTTP_ENGINE_MAX_EVENTS, timeout_ms);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == engine.timerfd) {
+            handle_timer();
+            continue;
+        }
+        int flags = 0;
+        if (events[i].events & (EPOLLIN | EPOLLHUP)) flags |= CURL_CSELECT_IN;
+        if (events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+        if (events[i].events & EPOLLERR) flags |= CURL_CSELECT_ERR;
+        curl_multi_socket_action(engine.multi, fd, flags, &engine.running_handles);
+    }
+    return dispatch_completions();
+}
+
+/**
+ * @brief Completion state of a blocking request.
+ * @details Filled by perform_done() for http_engine_perform().
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int finished;
+    CURLcode result;
+    long response_code;
+} perform_state_t;
+
+/**
+ * @brief Completion callback of http_engine_perform().
+ * @details Stores the result in the caller's perform_state_t.
+ * @example
+ *     // Not intended for direct use.
+ */
+static void perform_done(http_request_t *req, CURLcode result, long response_code) {
+    perform_state_t *state = req->user;
+    state->finished = 1;
+    state->result = result;
+    state->response_code = response_code;
+}
+
+/**
+ * @brief Perform one request and wait for it (blocking wrapper).
+ * @details Used for init-time requests (login, discovery) and the shutdown image.
+ * @example
+ *     http_engine_perform(easy, &code);
+ */
+CURLcode http_engine_perform(CURL *easy, long *response_code) {
+    perform_state_t state = { 0, CURLE_FAILED_INIT, 0 };
+    http_request_t req = { .easy = easy, .done = perform_done, .user = &state, .due_ns = 0, .next = NULL };
+    if (!http_engine_submit(&req)) return CURLE_FAILED_INIT;
+    while (!state.finished) {
+        if (http_engine_run(-1) < 0) {
+            list_remove(&engine.active, &req);
+            curl_multi_remove_handle(engine.multi, easy);
+            break;
+        }
+    }
+    if (response_code) *response_code = state.response_code;
+    return state.result;
+}
+
+/**
+ * @brief Cancel a request without calling done().
+ * @details Removes the request from whichever engine list holds it; a request that is not pending is ignored.
+ * @example
+ *     http_engine_cancel(&req);
+ */
+void http_engine_cancel(http_request_t *req) {
+    if (!req) return;
+    if (list_remove(&engine.active, req)) {
+        curl_multi_remove_handle(engine.multi, req->easy);
+    } else if (list_remove(&engine.deferred, req)) {
+        arm_timer();
+    }
+}
+
+/**
+ * @brief Return the number of requests in flight or waiting for their start time.
+ * @details Counts both engine lists.
+ * @example
+ *     int n = http_engine_pending();
+ */
+int http_engine_pending(void) {
+    int count = 0;
+    for (http_request_t *req = engine.active; req; req = req->next) count++;
+    for (http_request_t *req = engine.deferred; req; req = req->next) count++;
+    return count;
+}
+
+/**
+ * @brief Return the engine's epoll descriptor.
+ * @details See header.
+ * @example
+ *     int fd = http_engine_fd();
+ */
+int http_engine_fd(void) {
+    return engine.epfd;
+}
+
+/**
+ * @brief Copy the engine transport counters.
+ * @details Each counter is loaded atomically; counters may come from different transfers.
+ * @example
+ *     http_engine_get_stats(&stats);
+ */
+void http_engine_get_stats(http_engine_stats_t *out) {
+    if (!out) return;
+    out->requests = __atomic_load_n(&stats.requests, __ATOMIC_RELAXED);
+    out->new_connections = __atomic_load_n(&stats.new_connections, __ATOMIC_RELAXED);
+    out->reused = __atomic_load_n(&stats.reused, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Abort all requests and free engine resources.
+ * @details Active easy handles are detached from the multi handle. Owners must free their easy handles before calling this, otherwise the share is still in use and cannot be freed.
+ * @example
+ *     http_engine_cleanup();
+ */
+void http_engine_cleanup(void) {
+    while (engine.active) {
+        http_request_t *req = engine.active;
+        engine.active = req->next;
+        req->next = NULL;
+        curl_multi_remove_handle(engine.multi, req->easy);
+    }
+    engine.deferred = NULL;
+    if (engine.multi) {
+        curl_multi_cleanup(engine.multi);
+        engine.multi = NULL;
+    }
+    if (engine.share) {
+        curl_share_cleanup(engine.share);
+        engine.share = NULL;
+    }
+    if (engine.timerfd >= 0) {
+        close(engine.timerfd);
+        engine.timerfd = -1;
+    }
+    if (engine.epfd >= 0) {
+        close(engine.epfd);
+        engine.epfd = -1;
+    }
+    engine.curl_deadline_ns = -1;
+    engine.running_handles = 0;
+}
@@ -0,0 +1,416 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Incremental (SAX-style) JSON parser implementation.
+ * @details A byte-at-a-time lexer whose whole state lives in json_stream_t, so input can be split at any position.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Include project headers
+#include "../include/json_stream.h"
+
+// Include necessary headers
+#include <stdlib.h>
+#include <string.h>
+
+// Unicode replacement character for invalid surrogates
+#define JSON_REPLACEMENT_CHAR 0xFFFD
+
+/**
+ * @brief Lexer states.
+ * @details JS_VALUE/JS_KEY/JS_COLON/JS_AFTER expect structural input; JS_STRING/JS_ESCAPE/JS_UNICODE/JS_ATOM are inside a token; JS_DONE follows the top-level value.
+ * @example
+ *     // Not intended for direct use.
+ */
+enum {
+    JS_VALUE,
+    JS_KEY,
+    JS_COLON,
+    JS_AFTER,
+    JS_STRING,
+    JS_ESCAPE,
+    JS_UNICODE,
+    JS_ATOM,
+    JS_DONE
+};
+
+/**
+ * @brief Mark a syntax error.
+ * @details Returns 0 so callers can write return fail(parser).
+ * @example
+ *     return fail(parser);
+ */
+static int fail(json_stream_t *parser) {
+    parser->error = 1;
+    return 0;
+}
+
+/**
+ * @brief Check for JSON whitespace.
+ * @details Space, tab, CR and LF.
+ * @example
+ *     if (is_space(c)) continue;
+ */
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * @brief Check for a character that can be part of a number or literal.
+ * @details Digits, sign, decimal point, exponent and the lowercase letters of true/false/null.
+ * @example
+ *     if (is_atom_char(c)) { ... }
+ */
+static int is_atom_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+/**
+ * @brief Append one byte to the current token.
+ * @details Bytes beyond JSON_STREAM_MAX_TOKEN - 1 are dropped (truncation).
+ * @example
+ *     token_append(parser, c);
+ */
+static void token_append(json_stream_t *parser, char c) {
+    if (parser->token_len < JSON_STREAM_MAX_TOKEN - 1) parser->token[parser->token_len++] = c;
+}
+
+/**
+ * @brief Append a code point to the current token as UTF-8.
+ * @details Handles the full Unicode range.
+ * @example
+ *     token_append_utf8(parser, 0xB0);
+ */
+static void token_append_utf8(json_stream_t *parser, unsigned int cp) {
+    if (cp < 0x80) {
+        token_append(parser, (char)cp);
+    } else if (cp < 0x800) {
+        token_append(parser, (char)(0xC0 | (cp >> 6)));
+        token_append(parser, (char)(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        token_append(parser, (char)(0xE0 | (cp >> 12)));
+        token_append(parser, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        token_append(parser, (char)(0x80 | (cp & 0x3F)));
+    } else {
+        token_append(parser, (char)(0xF0 | (cp >> 18)));
+        token_append(parser, (char)(0x80 | ((cp >> 12) & 0x3F)));
+        token_append(parser, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        token_append(parser, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+/**
+ * @brief Emit a replacement character for an unpaired high surrogate.
+ * @details Called before any string content that does not complete the pair.
+ * @example
+ *     flush_surrogate(parser);
+ */
+static void flush_surrogate(json_stream_t *parser) {
+    if (parser->high_surrogate) {
+        token_append_utf8(parser, JSON_REPLACEMENT_CHAR);
+        parser->high_surrogate = 0;
+    }
+}
+
+/**
+ * @brief Decode a completed \uXXXX escape.
+ * @details Combines UTF-16 surrogate pairs; lone surrogates become U+FFFD.
+ * @example
+ *     add_codepoint(parser, parser->codepoint);
+ */
+static void add_codepoint(json_stream_t *parser, unsigned int cp) {
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        flush_surrogate(parser);
+        parser->high_surrogate = cp;
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        if (parser->high_surrogate) {
+            token_append_utf8(parser, 0x10000 + ((parser->high_surrogate - 0xD800) << 10) + (cp - 0xDC00));
+            parser->high_surrogate = 0;
+        } else {
+            token_append_utf8(parser, JSON_REPLACEMENT_CHAR);
+        }
+    } else {
+        flush_surrogate(parser);
+        token_append_utf8(parser, cp);
+    }
+}
+
+/**
+ * @brief Set the state after a complete value.
+ * @details A value at depth 0 completes the document.
+ * @example
+ *     value_done(parser);
+ */
+static void value_done(json_stream_t *parser) {
+    parser->state = parser->depth == 0 ? JS_DONE : JS_AFTER;
+}
+
+/**
+ * @brief Start the current token.
+ * @details Clears the token buffer and the surrogate state.
+ * @example
+ *     begin_token(parser, JS_STRING);
+ */
+static void begin_token(json_stream_t *parser, int state) {
+    parser->token_len = 0;
+    parser->high_surrogate = 0;
+    parser->first = 0;
+    parser->state = state;
+}
+
+/**
+ * @brief Open an object or array.
+ * @details Returns 1 on success, 0 if JSON_STREAM_MAX_DEPTH is exceeded.
+ * @example
+ *     open_container(parser, '{');
+ */
+static int open_container(json_stream_t *parser, char type) {
+    if (parser->depth >= JSON_STREAM_MAX_DEPTH) return fail(parser);
+    parser->stack[parser->depth++] = type;
+    parser->on_event(type == '{' ? JSON_EVENT_OBJECT_START : JSON_EVENT_ARRAY_START, NULL, parser->depth, parser->user);
+    parser->first = 1;
+    parser->state = type == '{' ? JS_KEY : JS_VALUE;
+    return 1;
+}
+
+/**
+ * @brief Close the innermost object or array.
+ * @details Returns 1 on success, 0 if type does not match the open container.
+ * @example
+ *     close_container(parser, '{');
+ */
+static int close_container(json_stream_t *parser, char type) {
+    if (parser->depth == 0 || parser->stack[parser->depth - 1] != type) return fail(parser);
+    parser->on_event(type == '{' ? JSON_EVENT_OBJECT_END : JSON_EVENT_ARRAY_END, NULL, parser->depth, parser->user);
+    parser->depth--;
+    value_done(parser);
+    return 1;
+}
+
+/**
+ * @brief Classify and emit the current number or literal.
+ * @details Returns 1 on success, 0 if the token is neither true/false/null nor a number.
+ * @example
+ *     emit_atom(parser);
+ */
+static int emit_atom(json_stream_t *parser) {
+    parser->token[parser->token_len] = '\0';
+    json_event_t event;
+    if (strcmp(parser->token, "true") == 0) {
+        event = JSON_EVENT_TRUE;
+    } else if (strcmp(parser->token, "false") == 0) {
+        event = JSON_EVENT_FALSE;
+    } else if (strcmp(parser->token, "null") == 0) {
+        event = JSON_EVENT_NULL;
+    } else {
+        char *end = NULL;
+        const char c = parser->token[0];
+        if (!(c == '-' || (c >= '0' && c <= '9'))) return fail(parser);
+        strtod(parser->token, &end);
+        if (!end || *end != '\0') return fail(parser);
+        event = JSON_EVENT_NUMBER;
+    }
+    parser->on_event(event, parser->token, parser->depth, parser->user);
+    value_done(parser);
+    return 1;
+}
+
+/**
+ * @brief Emit the current string as key or value.
+ * @details Keys move on to the colon, values complete the current value.
+ * @example
+ *     emit_string(parser);
+ */
+static void emit_string(json_stream_t *parser) {
+    flush_surrogate(parser);
+    parser->token[parser->token_len] = '\0';
+    if (parser->is_key) {
+        parser->on_event(JSON_EVENT_KEY, parser->token, parser->depth, parser->user);
+        parser->state = JS_COLON;
+    } else {
+        parser->on_event(JSON_EVENT_STRING, parser->token, parser->depth, parser->user);
+        value_done(parser);
+    }
+}
+
+/**
+ * @brief Handle one byte where a value is expected.
+ * @details Also accepts ']' directly after '['.
+ * @example
+ *     // Not intended for direct use.
+ */
+static int lex_value(json_stream_t *parser, char c) {
+    if (is_space(c)) return 1;
+    if (c == '{' || c == '[') return open_container(parser, c);
+    if (c == ']' && parser->first) return close_container(parser, '[');
+    if (c == '"') {
+        parser->is_key = 0;
+        begin_token(parser, JS_STRING);
+        return 1;
+    }
+    if (is_atom_char(c)) {
+        begin_token(parser, JS_ATOM);
+        token_append(parser, c);
+        return 1;
+    }
+    return fail(parser);
+}
+
+/**
+ * @brief Handle one byte of a string escape sequence.
+ * @details Supports all JSON escapes including \uXXXX.
+ * @example
+ *     // Not intended for direct use.
+ */
+static int lex_escape(json_stream_t *parser, char c) {
+    char out;
+    switch (c) {
+        case '"': out = '"'; break;
+        case '\\': out = '\\'; break;
+        case '/': out = '/'; break;
+        case 'b': out = '\b'; break;
+        case 'f': out = '\f'; break;
+        case 'n': out = '\n'; break;
+        case 'r': out = '\r'; break;
+        case 't': out = '\t'; break;
+        case 'u':
+            parser->codepoint = 0;
+            parser->hex_digits = 0;
+            parser->state = JS_UNICODE;
+            return 1;
+        default:
+            return fail(parser);
+    }
+    flush_surrogate(parser);
+    token_append(parser, out);
+    parser->state = JS_STRING;
+    return 1;
+}
+
+/**
+ * @brief Handle one hex digit of a \uXXXX escape.
+ * @details Returns to the string state after the fourth digit.
+ * @example
+ *     // Not intended for direct use.
+ */
+static int lex_unicode(json_stream_t *parser, char c) {
+    unsigned int digit;
+    if (c >= '0' && c <= '9') digit = (unsigned int)(c - '0');
+    else if (c >= 'a' && c <= 'f') digit = (unsigned int)(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F') digit = (unsigned int)(c - 'A' + 10);
+    else return fail(parser);
+    parser->codepoint = (parser->codepoint << 4) | digit;
+    if (++parser->hex_digits == 4) {
+        add_codepoint(parser, parser->codepoint);
+        parser->state = JS_STRING;
+    }
+    return 1;
+}
+
+/**
+ * @brief Initialize a parser.
+ * @details See header.
+ * @example
+ *     json_stream_init(&parser, on_token, &ctx);
+ */
+void json_stream_init(json_stream_t *parser, json_event_fn on_event, void *user) {
+    memset(parser, 0, sizeof(*parser));
+    parser->on_event = on_event;
+    parser->user = user;
+    parser->state = JS_VALUE;
+}
+
+/**
+ * @brief Feed the next chunk of JSON text.
+ * @details Processes the chunk byte by byte; a number or literal ends at the first byte that cannot belong to it, which is then processed again in the new state.
+ * @example
+ *     json_stream_feed(&parser, chunk, len);
+ */
+int json_stream_feed(json_stream_t *parser, const char *data, size_t len) {
+    if (!parser || parser->error) return 0;
+    size_t i = 0;
+    while (i < len) {
+        const char c = data[i];
+        int ok = 1;
+        switch (parser->state) {
+            case JS_VALUE:
+                ok = lex_value(parser, c);
+                break;
+            case JS_KEY:
+                if (c == '"') {
+                    parser->is_key = 1;
+                    begin_token(parser, JS_STRING);
+                } else if (c == '}' && parser->first) {
+                    ok = close_container(parser, '{');
+                } else if (!is_space(c)) {
+                    ok = fail(parser);
+                }
+                break;
+            case JS_COLON:
+                if (c == ':') parser->state = JS_VALUE;
+                else if (!is_space(c)) ok = fail(parser);
+                break;
+            case JS_AFTER:
+                if (c == ',') {
+                    parser->first = 0;
+                    parser->state = parser->stack[parser->depth - 1] == '{' ? JS_KEY : JS_VALUE;
+                } else if (c == '}' || c == ']') {
+                    ok = close_container(parser, c == '}' ? '{' : '[');
+                } else if (!is_space(c)) {
+                    ok = fail(parser);
+                }
+                break;
+            case JS_STRING:
+                if (c == '"') {
+                    emit_string(parser);
+                } else if (c == '\\') {
+                    parser->state = JS_ESCAPE;
+                } else if ((unsigned char)c < 0x20) {
+                    ok = fail(parser);
+                } else {
+                    flush_surrogate(parser);
+                    token_append(parser, c);
+                }
+                break;
+            case JS_ESCAPE:
+                ok = lex_escape(parser, c);
+                break;
+            case JS_UNICODE:
+                ok = lex_unicode(parser, c);
+                break;
+            case JS_ATOM:
+                if (is_atom_char(c)) {
+                    token_append(parser, c);
+                } else {
+                    if (!emit_atom(parser)) return 0;
+                    continue; // Process c in the new state
+                }
+                break;
+            case JS_DONE:
+                if (!is_space(c)) ok = fail(parser);
+                break;
+        }
+        if (!ok) return 0;
+        i++;
+    }
+    return 1;
+}
+
+/**
+ * @brief Signal the end of input.
+ * @details See header.
+ * @example
+ *     json_stream_finish(&parser);
+ */
+int json_stream_finish(json_stream_t *parser) {
+    if (!parser || parser->error) return 0;
+    if (parser->state == JS_ATOM && parser->depth == 0 && !emit_atom(parser)) return 0;
+    return parser->state == JS_DONE;
+}
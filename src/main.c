@@ -14,17 +14,38 @@
  */
 
 // Function prototypes
-#define _POSIX_C_SOURCE 200112L
-#define _XOPEN_SOURCE 600
+#define _POSIX_C_SOURCE 200809L
+#define _XOPEN_SOURCE 700
+
+// Time budget of the shutdown image (ms); with the upload worker's stop grace it stays below TimeoutStopSec=3
+#define SHUTDOWN_IMAGE_BUDGET_MS 2000
+
+// Nanoseconds per second
+#define NSEC_PER_SEC 1000000000LL
+
+// Read buffer of the configuration file watch (inotify events)
+#define CONFIG_WATCH_BUFFER_SIZE 4096
+
+// Offset and size of a Config field, for the restart-only settings table
+#define CONFIG_FIELD(field) offsetof(Config, field), sizeof(((Config *)0)->field)
 
 // Include project headers
 #include "../include/config.h"
+#include "../include/control.h"
+#include "../include/coolant_monitor.h"
 #include "../include/coolercontrol.h"
 #include "../include/cpu_monitor.h"
 #include "../include/gpu_monitor.h"
+#include "../include/histogram.h"
+#include "../include/http_engine.h"
+#include "../include/sensors.h"
 #include "../include/display.h"
+#include "../include/event_loop.h"
+#include "../include/sampler.h"
+#include "../include/uploader.h"
 
 // Include necessary headers
+#include <stddef.h>
 #include <unistd.h>
 #include <signal.h>
 #include <string.h>
@@ -32,124 +53,881 @@
 #include <stdlib.h>
 #include <time.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
 #include <sys/types.h>
+#include <sys/inotify.h>
+#include <sys/signalfd.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <sys/wait.h>
 
 /**
  * @brief Global variables for daemon management.
- * @details Used for controlling the main daemon loop and shutdown image logic.
+ * @details Used for controlling the main daemon loop.
  * @example
  *     // Not intended for direct use; managed by main and signal handler.
  */
 static volatile sig_atomic_t running = 1; // flag whether daemon is running
-static volatile sig_atomic_t shutdown_sent = 0; // flag whether shutdown image was already sent
 
 /**
- * @brief Global pointer to config for signal handler access.
- * @details Allows the signal handler to access configuration data for cleanup and shutdown image.
+ * @brief Global pointer to config for cleanup access.
+ * @details Allows cleanup_and_exit() to access configuration data (PID file).
  * @example
  *     // Not intended for direct use; set in main().
  */
 static const Config *g_config_ptr = NULL;
 
 /**
- * @brief Signal handler for clean daemon termination with shutdown image.
- * @details Sends a shutdown image to the LCD (if not already sent), removes the PID file, and sets the running flag to 0 for clean termination.
+ * @brief Descriptor of the locked PID file.
+ * @details Open for the lifetime of the process; holds the single-instance lock (-1 if not acquired).
+ * @example
+ *     // Not intended for direct use; set by acquire_pid_file().
+ */
+static int pid_fd = -1;
+
+/**
+ * @brief Tick statistics of the main loop.
+ * @details Written by on_render_tick() only; printed at shutdown and on SIGUSR1. Lateness is the wake-up time minus the tick deadline; work is the time draw_combined_image() took.
+ * @example
+ *     // Not intended for direct use; filled by on_render_tick().
+ */
+static struct {
+    unsigned long long ticks;   // Frames started
+    unsigned long long skipped; // Deadlines dropped after an overrun
+    histogram_t lateness_us;    // Wake-up lateness per tick (microseconds)
+    histogram_t work_us;        // Frame work per tick (microseconds)
+} schedule_stats;
+
+/**
+ * @brief Signal handler for clean daemon termination.
+ * @details Fallback if signalfd() is unavailable (see open_signal_fd()). Only sets the running flag to 0; the main loop then stops the worker threads and sends the shutdown image from normal context. Async-signal-safe.
  * @example
- *     signal(SIGTERM, cleanup_and_exit);
+ *     sa.sa_handler = handle_termination_signal;
  */
-static void cleanup_and_exit(int sig) {
+static void handle_termination_signal(int sig) {
     (void)sig; // parameter is not used
-    // Send shutdown image only once
-    if (!shutdown_sent && is_session_initialized() && g_config_ptr) {
-        const char* shutdown_image = g_config_ptr->shutdown_image;
-        const char* device_uid = get_cached_device_uid();
-        printf("CoolerDash: Sending shutdown image to LCD...\n");
-        fflush(stdout);
-        if (device_uid[0]) {
-            send_image_to_lcd(g_config_ptr, shutdown_image, device_uid);
-            send_image_to_lcd(g_config_ptr, shutdown_image, device_uid);
-            printf("CoolerDash: Shutdown image sent successfully\n");
-            shutdown_sent = 1; // set flag so it's only sent once
+    running = 0; // set flag to terminate daemon
+}
+
+/**
+ * @brief Final cleanup before exit.
+ * @details Terminates the nvidia-smi stream child (if any) and removes the PID file while still holding its lock, so a starting instance never locks a file that is about to disappear unnoticed.
+ * @example
+ *     cleanup_and_exit();
+ */
+static void cleanup_and_exit(void) {
+    stop_gpu_stream(); // terminate nvidia-smi stream child, if any
+    if (pid_fd >= 0) {
+        if (g_config_ptr) unlink(g_config_ptr->pid_file); // remove PID file
+        close(pid_fd); // releases the single-instance lock
+        pid_fd = -1;
+    }
+    running = 0;
+}
+
+/**
+ * @brief Completion callback of one shutdown image delivery.
+ * @details Stores the result in the int pointed to by user.
+ * @example
+ *     // Not intended for direct use.
+ */
+static void shutdown_image_done(int success, void *user) {
+    *(int *)user = success;
+}
+
+/**
+ * @brief Send the shutdown image to all driven LCDs.
+ * @details Called once from main() after the render loop and the upload worker have stopped, so it never races with a frame upload. Uses each output's own configuration; a daemon that stayed idle (no output, see setup_outputs()) sends nothing. All devices are served concurrently within SHUTDOWN_IMAGE_BUDGET_MS, so a hung daemon cannot delay the exit past the service stop timeout.
+ * @example
+ *     send_shutdown_image();
+ */
+static void send_shutdown_image(void) {
+    if (!is_session_initialized() || display_output_count() == 0) return;
+    const Config *configs[CONFIG_MAX_DEVICES];
+    const char *uids[CONFIG_MAX_DEVICES];
+    int results[CONFIG_MAX_DEVICES];
+    int count = 0;
+    for (int i = 0; i < display_output_count() && count < CONFIG_MAX_DEVICES; ++i, ++count) {
+        configs[count] = display_output_config(i);
+        uids[count] = display_output_uid(i);
+    }
+    printf("CoolerDash: Sending shutdown image to LCD...\n");
+    fflush(stdout);
+    for (int i = 0; i < count; ++i) {
+        results[i] = 0;
+        submit_image_to_lcd(configs[i], configs[i]->shutdown_image, uids[i], SHUTDOWN_IMAGE_BUDGET_MS, shutdown_image_done, &results[i]);
+    }
+    wait_lcd_deliveries(SHUTDOWN_IMAGE_BUDGET_MS);
+    for (int i = 0; i < count; ++i) {
+        if (results[i]) {
+            printf("CoolerDash: Shutdown image sent successfully to %.20s\n", uids[i]);
         } else {
-            printf("CoolerDash: Warning - Could not send shutdown image (device UID not detected)\n");
+            printf("CoolerDash: Warning - Shutdown image was not acknowledged by %.20s\n", uids[i]);
         }
-        fflush(stdout);
     }
-    unlink(g_config_ptr->pid_file); // remove PID file
-    running = 0; // set flag to terminate daemon
+    fflush(stdout);
 }
 
 /**
- * @brief Check if another instance of CoolerDash is running (systemd or process).
- * @details Uses systemctl and pgrep to detect running service or process. Returns -1 if another instance is active, 0 otherwise.
+ * @brief Look up a device in the CoolerControl device index.
+ * @details Copies the entry into device, so the result stays valid when the upload worker replaces the index. Returns 1 if the UID is known, 0 otherwise.
  * @example
- *     check_existing_instance_and_handle(config.pid_file, is_service_start);
+ *     cc_device_t dev;
+ *     if (find_indexed_device(uid, &dev)) { ... }
  */
-static int check_existing_instance_and_handle(const char *pid_file, int is_service_start) {
-    (void)pid_file;
-    // Skip service check if started by systemd
-    if (!is_service_start) {
-        int status = system("systemctl is-active --quiet coolerdash.service");
-        if (status == 0) {
-            printf("CoolerDash: Error - systemd service is already running\n");
-            printf("Stop the service first: sudo systemctl stop coolerdash.service\n");
-            return -1;
+static int find_indexed_device(const char *device_uid, cc_device_t *device) {
+    for (size_t i = 0; copy_device_info(i, device); ++i) {
+        if (strcmp(device->uid, device_uid) == 0) return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Register the LCD outputs driven by this daemon.
+ * @details With [device.*] sections every enabled section whose UID is known to CoolerControl becomes an output with its own effective configuration; if none matches, the daemon stays idle rather than driving an LCD the configuration does not name. Without sections every Liquidctl device with an LCD is driven with the global configuration, or the cached device if there is none. Returns the number of outputs; 0 means nothing is rendered or uploaded.
+ * @example
+ *     setup_outputs(&config);
+ */
+static int setup_outputs(const Config *config) {
+    if (config->device_count > 0) {
+        static Config device_config; // Large; display_add_output() keeps its own copy
+        for (int i = 0; i < config->device_count; ++i) {
+            const DeviceConfig *device = &config->devices[i];
+            if (!device->enabled) continue;
+            cc_device_t dev;
+            if (!find_indexed_device(device->uid, &dev)) {
+                printf("⚠ [device.%s]: UID %.20s not found in CoolerControl\n", device->label, device->uid);
+                continue;
+            }
+            if (config_for_device(config, device, &device_config) != 0 || !display_add_output(&device_config, device->uid)) {
+                printf("⚠ [device.%s]: Could not set up LCD output\n", device->label);
+                continue;
+            }
+            printf("✓ LCD output [device.%s]: %s\n", device->label, dev.name);
+        }
+        if (display_output_count() == 0) {
+            printf("⚠ No [device.*] section matches an LCD known to CoolerControl; staying idle\n");
+        }
+    } else {
+        cc_device_t dev;
+        for (size_t i = 0; copy_device_info(i, &dev); ++i) {
+            if (strcmp(dev.type, "Liquidctl") != 0 || !dev.has_lcd) continue;
+            if (display_add_output(config, dev.uid)) {
+                printf("✓ LCD output: %s\n", dev.name);
+            }
+        }
+        if (display_output_count() == 0 && display_add_output(config, get_cached_device_uid())) {
+            printf("✓ LCD output: %.20s\n", get_cached_device_uid());
         }
     }
-    // Check for running process using pgrep
-    FILE *fp = popen("pgrep -x coolerdash", "r");
-    int found_pid = 0;
-    if (fp) {
-        int pid;
-        while (fscanf(fp, "%d", &pid) == 1) {
-            if (!is_service_start || pid != getpid()) {
-                found_pid = pid;
-                break;
+    fflush(stdout);
+    return display_output_count();
+}
+
+/**
+ * @brief Read the PID stored in a PID file.
+ * @details Returns 0 if the file holds no PID.
+ * @example
+ *     int pid = read_pid(fd);
+ */
+static int read_pid(int fd) {
+    char buffer[16];
+    ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if (n <= 0) return 0;
+    buffer[n] = '\0';
+    return atoi(buffer);
+}
+
+/**
+ * @brief Enforce a single instance with a lock on the PID file and write the current PID into it.
+ * @details Takes a non-blocking exclusive flock() on the PID file and keeps the descriptor open until exit; the kernel drops the lock when the process dies, so a stale file from a crash never blocks a start and no subprocess (systemctl, pgrep) is needed. The service and manual starts share the lock through the same pid_file. A file removed or replaced by the previous owner between open and lock is detected by comparing inodes and locked again. If the file cannot be opened for writing (e.g. a manual start as another user while the service owns it), a shared lock probe on a read-only descriptor still detects the running instance. Returns -1 if another instance holds the lock, 0 otherwise.
+ * @example
+ *     if (acquire_pid_file(config.pid_file) < 0) return 1;
+ */
+static int acquire_pid_file(const char *pid_file) {
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        int fd = open(pid_file, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        int writable = fd >= 0;
+        if (!writable) fd = open(pid_file, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            printf("⚠ Could not open PID file %s (%s); single-instance check skipped\n", pid_file, strerror(errno));
+            return 0;
+        }
+        if (flock(fd, (writable ? LOCK_EX : LOCK_SH) | LOCK_NB) != 0) {
+            int locked = errno == EWOULDBLOCK;
+            int pid = locked ? read_pid(fd) : 0;
+            close(fd);
+            if (!locked) {
+                printf("⚠ Could not lock PID file %s; single-instance check skipped\n", pid_file);
+                return 0;
             }
+            printf("CoolerDash: Error - another coolerdash instance is already running (PID %d)\n", pid);
+            printf("Stop it first: sudo systemctl stop coolerdash.service (or kill %d)\n", pid);
+            return -1;
         }
-        pclose(fp);
+        if (!writable) {
+            close(fd); // No instance holds the lock, but the file cannot be taken over
+            printf("⚠ PID file %s is not writable; single-instance check skipped\n", pid_file);
+            return 0;
+        }
+        struct stat locked, current;
+        if (fstat(fd, &locked) != 0 || stat(pid_file, &current) != 0 ||
+            locked.st_dev != current.st_dev || locked.st_ino != current.st_ino) {
+            close(fd); // Unlinked by the previous owner after we opened it
+            continue;
+        }
+        char line[24];
+        int length = snprintf(line, sizeof(line), "%d\n", (int)getpid());
+        if (ftruncate(fd, 0) != 0 || write(fd, line, (size_t)length) != length) {
+            printf("⚠ Could not write PID file %s\n", pid_file);
+        }
+        pid_fd = fd;
+        return 0;
     }
-    if (found_pid > 0) {
-        printf("CoolerDash: Error - another coolerdash process is already running (PID %d)\n", found_pid);
-        printf("Stop it first: kill %d\n", found_pid);
+    printf("⚠ PID file %s keeps being replaced; single-instance check skipped\n", pid_file);
+    return 0;
+}
+
+/**
+ * @brief Print main loop tick statistics.
+ * @details Summarizes ticks, skipped deadlines, wake-up lateness (jitter) and frame work time. Printed once on shutdown.
+ * @example
+ *     print_schedule_stats();
+ */
+static void print_schedule_stats(void) {
+    if (schedule_stats.ticks == 0) return;
+    const histogram_t *late = &schedule_stats.lateness_us;
+    const histogram_t *work = &schedule_stats.work_us;
+    printf("Schedule: %llu ticks, %llu skipped after overruns\n", schedule_stats.ticks, schedule_stats.skipped);
+    printf("Schedule: lateness p50 %.3f / p99 %.3f / max %.3f ms, frame work p50 %.3f / p99 %.3f / max %.3f ms\n",
+           histogram_percentile(late, 50.0) / 1e3, histogram_percentile(late, 99.0) / 1e3, late->max / 1e3,
+           histogram_percentile(work, 50.0) / 1e3, histogram_percentile(work, 99.0) / 1e3, work->max / 1e3);
+    fflush(stdout);
+}
+
+/**
+ * @brief Print sampler latency and snapshot staleness statistics.
+ * @details Summarizes how long sensor sampling passes took and how old the snapshots were when the renderer consumed them. Printed once on shutdown.
+ * @example
+ *     print_sampler_stats();
+ */
+static void print_sampler_stats(void) {
+    sampler_stats_t stats;
+    sampler_get_stats(&stats);
+    if (stats.samples == 0) return;
+    printf("Sampler: %llu samples, latency avg %.3f ms / max %.3f ms\n",
+           stats.samples, stats.total_latency_ns / 1e6 / stats.samples, stats.max_latency_ns / 1e6);
+    if (stats.reads > 0) {
+        printf("Sampler: %llu reads, staleness avg %.3f ms / max %.3f ms, %llu seqlock retries\n",
+               stats.reads, stats.total_staleness_ns / 1e6 / stats.reads, stats.max_staleness_ns / 1e6, stats.read_retries);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Print upload worker statistics.
+ * @details Summarizes how many frames were superseded in the mailbox and how long frames waited for the worker. Printed once on shutdown.
+ * @example
+ *     print_uploader_stats();
+ */
+static void print_uploader_stats(void) {
+    uploader_stats_t stats;
+    uploader_get_stats(&stats);
+    if (stats.submitted == 0) return;
+    printf("Uploader: %llu frames submitted, %llu superseded, %llu taken: %llu uploaded, %llu failed, %llu not sent\n",
+           stats.submitted, stats.superseded, stats.taken, stats.uploaded, stats.failed, stats.not_sent);
+    if (stats.taken > 0) {
+        printf("Uploader: queue wait avg %.3f ms / max %.3f ms\n",
+               stats.total_wait_ns / 1e6 / stats.taken, stats.max_wait_ns / 1e6);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Print LCD image delivery statistics.
+ * @details Summarizes acknowledged, retried and failed uploads and how many HTTP requests needed a new connection. Printed once on shutdown.
+ * @example
+ *     print_delivery_stats();
+ */
+static void print_delivery_stats(void) {
+    lcd_delivery_stats_t stats;
+    get_lcd_delivery_stats(&stats);
+    if (stats.delivered == 0 && stats.failures == 0) return;
+    printf("Delivery: %llu images delivered, %llu retries, %llu failures, %llu missed deadlines (last HTTP %ld)\n",
+           stats.delivered, stats.retries, stats.failures, stats.missed, stats.last_response_code);
+    if (stats.reauths) {
+        printf("Session: %llu re-logins, %llu failed\n", stats.reauths, stats.reauth_failures);
+    }
+    http_engine_stats_t transport;
+    http_engine_get_stats(&transport);
+    printf("Transport: %llu requests, %llu new connections, %llu reused\n",
+           transport.requests, transport.new_connections, transport.reused);
+    cc_link_stats_t link;
+    get_lcd_link_stats(&link);
+    if (link.outages) {
+        printf("Link: %llu outages, %llu recoveries (last outage %.1f s), %llu health probes (%llu failed), %llu frames skipped\n",
+               link.outages, link.recoveries, link.last_outage_ms / 1000.0, link.probes, link.probe_failures, link.frames_skipped);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Print the HTTP timing telemetry of all CoolerControl endpoints.
+ * @details One summary line per endpoint followed by p50/p90/p99/max per request phase in milliseconds. Called once at shutdown; endpoints without requests are skipped.
+ * @example
+ *     print_http_timings();
+ */
+static void print_http_timings(void) {
+    static cc_endpoint_timing_t timing; // Large; avoid the stack
+    for (int e = 0; e < CC_ENDPOINT_COUNT; ++e) {
+        if (!get_endpoint_timing((cc_endpoint_t)e, &timing)) continue;
+        unsigned long long requests = 0;
+        for (int c = 0; c < 6; ++c) requests += timing.status[c];
+        if (requests == 0) continue;
+        printf("HTTP %s: %llu requests (2xx %llu, 4xx %llu, 5xx %llu, errors %llu), avg %.0f bytes sent\n",
+               get_endpoint_name((cc_endpoint_t)e), requests, timing.status[2], timing.status[4], timing.status[5],
+               timing.status[0], histogram_mean(&timing.bytes_sent));
+        for (int p = 0; p < CC_PHASE_COUNT; ++p) {
+            const histogram_t *h = &timing.phases[p];
+            if (h->count == 0) continue;
+            printf("  %-12s p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms\n", get_phase_name((cc_phase_t)p),
+                   histogram_percentile(h, 50.0) / 1e3, histogram_percentile(h, 90.0) / 1e3,
+                   histogram_percentile(h, 99.0) / 1e3, h->max / 1e3);
+        }
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Read CLOCK_MONOTONIC in nanoseconds.
+ * @details Used for the tick deadlines of the render timer.
+ * @example
+ *     long long now = monotonic_ns();
+ */
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief Startup milestones, in the order they are reached.
+ * @details Each milestone ends one startup phase; see startup_mark().
+ * @example
+ *     startup_mark(STARTUP_SESSION);
+ */
+typedef enum {
+    STARTUP_CONFIG,      // config.ini parsed
+    STARTUP_INSTANCE,    // PID file locked
+    STARTUP_SENSORS,     // hwmon scanned
+    STARTUP_GPU,         // GPU backend probed
+    STARTUP_SESSION,     // Logged in, device index loaded, outputs set up
+    STARTUP_WORKERS,     // Upload worker and sampler started
+    STARTUP_FIRST_FRAME, // First frame rendered and handed to the upload
+    STARTUP_MARK_COUNT
+} startup_mark_t;
+
+/**
+ * @brief Startup timing (CLOCK_MONOTONIC).
+ * @details begin_ns is taken on entry to main(); a milestone is 0 until reached.
+ * @example
+ *     // Not intended for direct use; see startup_mark() and print_startup_stats().
+ */
+static struct {
+    long long begin_ns;                    // Entry to main()
+    long long mark_ns[STARTUP_MARK_COUNT]; // Time each milestone was reached
+} startup;
+
+/**
+ * @brief Record that a startup milestone was reached.
+ * @details Only the first call per milestone counts.
+ * @example
+ *     startup_mark(STARTUP_GPU);
+ */
+static void startup_mark(startup_mark_t mark) {
+    if (!startup.mark_ns[mark]) startup.mark_ns[mark] = monotonic_ns();
+}
+
+/**
+ * @brief Print the time to first frame and its phases.
+ * @details Printed once when the first frame is rendered and again with the runtime statistics, then including the time until the LCD acknowledged the first image.
+ * @example
+ *     print_startup_stats();
+ */
+static void print_startup_stats(void) {
+    static const char *const names[STARTUP_MARK_COUNT] = {
+        "config", "instance lock", "hwmon", "GPU", "session", "workers", "first frame"
+    };
+    if (!startup.mark_ns[STARTUP_FIRST_FRAME]) return;
+    char phases[256];
+    size_t len = 0;
+    long long previous = startup.begin_ns;
+    for (int i = 0; i < STARTUP_MARK_COUNT && len < sizeof(phases); ++i) {
+        len += snprintf(phases + len, sizeof(phases) - len, "%s%s %.1f", i ? ", " : "", names[i], (startup.mark_ns[i] - previous) / 1e6);
+        previous = startup.mark_ns[i];
+    }
+    printf("Startup: first frame after %.1f ms (%s ms)\n", (startup.mark_ns[STARTUP_FIRST_FRAME] - startup.begin_ns) / 1e6, phases);
+    lcd_delivery_stats_t delivery;
+    get_lcd_delivery_stats(&delivery);
+    if (delivery.first_delivered_ms) {
+        printf("Startup: first image acknowledged by the LCD after %.1f ms\n", (delivery.first_delivered_ms * 1000000LL - startup.begin_ns) / 1e6);
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Print all runtime statistics.
+ * @details Used at shutdown and on SIGUSR1, so the numbers can be checked while the daemon keeps running.
+ * @example
+ *     print_runtime_stats();
+ */
+static void print_runtime_stats(void) {
+    print_startup_stats();
+    print_schedule_stats();
+    print_sampler_stats();
+    print_uploader_stats();
+    print_delivery_stats();
+    print_http_timings();
+}
+
+/**
+ * @brief Render timer state of the main loop.
+ * @details deadline_ns is the absolute time of the next expected timer expiration.
+ * @example
+ *     // Not intended for direct use; set up by run_daemon().
+ */
+typedef struct {
+    const Config *config;  // Configuration of the render loop
+    int fd;                // timerfd (CLOCK_MONOTONIC)
+    long long period_ns;   // Refresh interval
+    long long deadline_ns; // Next expected expiration (CLOCK_MONOTONIC)
+} render_timer_t;
+
+/**
+ * @brief State of the configuration reload.
+ * @details config is the live configuration all modules point to; a reload copies the new values into it rather than replacing the pointer. Set up by main() and run_daemon().
+ * @example
+ *     // Not intended for direct use; used by handle_reload().
+ */
+static struct {
+    const char *path;      // Configuration file
+    const char *file_name; // Base name of path, matched against inotify events
+    Config *config;        // Live configuration
+    render_timer_t *timer; // Render timer (NULL outside run_daemon())
+} reload = { NULL, NULL, NULL, NULL };
+
+/**
+ * @brief Settings that only take effect on restart.
+ * @details The CoolerControl session stays logged in across a reload, and the files and sockets of the running instance keep their paths.
+ * @example
+ *     // Not intended for direct use; see keep_restart_settings().
+ */
+static const struct {
+    const char *name; // Key as written in config.ini
+    size_t offset;    // Field offset in Config
+    size_t size;      // Field size
+} restart_settings[] = {
+    { "[daemon] address", CONFIG_FIELD(daemon_address) },
+    { "[daemon] password", CONFIG_FIELD(daemon_password) },
+    { "[daemon] socket", CONFIG_FIELD(daemon_socket) },
+    { "[paths] pid_file", CONFIG_FIELD(pid_file) },
+    { "[paths] control_socket", CONFIG_FIELD(control_socket) },
+};
+
+/**
+ * @brief (Re)arm the render timer from the refresh interval of its configuration.
+ * @details The first expiration is immediate, so a reloaded configuration is shown right away. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!arm_render_timer(&timer)) { ... }
+ */
+static int arm_render_timer(render_timer_t *timer) {
+    const Config *config = timer->config;
+    timer->period_ns = (long long)config->display_refresh_interval_sec * NSEC_PER_SEC + config->display_refresh_interval_nsec;
+    if (timer->period_ns <= 0) timer->period_ns = NSEC_PER_SEC; // Guard against a zero interval busy loop
+    timer->deadline_ns = monotonic_ns();
+    struct itimerspec spec = {
+        .it_interval = { (time_t)(timer->period_ns / NSEC_PER_SEC), (long)(timer->period_ns % NSEC_PER_SEC) },
+        .it_value = { (time_t)(timer->deadline_ns / NSEC_PER_SEC), (long)(timer->deadline_ns % NSEC_PER_SEC) }
+    };
+    return timerfd_settime(timer->fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0;
+}
+
+/**
+ * @brief Keep the running values of settings that need a restart.
+ * @details Copies the restart-only settings from live into fresh, and the [device.*] sections too if sections were added, removed or point at another device. Overrides inside unchanged sections are applied. Appends one note per kept setting to notes.
+ * @example
+ *     keep_restart_settings(&config, &fresh, notes, sizeof(notes));
+ */
+static void keep_restart_settings(const Config *live, Config *fresh, char *notes, size_t notes_size) {
+    size_t len = 0;
+    notes[0] = '\0';
+    for (size_t i = 0; i < sizeof(restart_settings) / sizeof(restart_settings[0]); ++i) {
+        const char *old_value = (const char *)live + restart_settings[i].offset;
+        char *new_value = (char *)fresh + restart_settings[i].offset;
+        if (memcmp(old_value, new_value, restart_settings[i].size) == 0) continue;
+        memcpy(new_value, old_value, restart_settings[i].size);
+        if (len < notes_size) len += snprintf(notes + len, notes_size - len, "note: %s changed; restart to apply\n", restart_settings[i].name);
+    }
+    int same_devices = live->device_count == fresh->device_count;
+    for (int i = 0; same_devices && i < live->device_count; ++i) {
+        same_devices = strcmp(live->devices[i].label, fresh->devices[i].label) == 0 &&
+                       strcmp(live->devices[i].uid, fresh->devices[i].uid) == 0 &&
+                       live->devices[i].enabled == fresh->devices[i].enabled;
+    }
+    if (!same_devices) {
+        fresh->device_count = live->device_count;
+        memcpy(fresh->devices, live->devices, sizeof(fresh->devices));
+        if (len < notes_size) snprintf(notes + len, notes_size - len, "note: [device.*] sections added, removed or re-targeted; restart to apply\n");
+    }
+}
+
+/**
+ * @brief Give every LCD output the effective configuration derived from config.
+ * @details Outputs with a [device.*] section get its overrides, all others the global configuration, as in setup_outputs().
+ * @example
+ *     refresh_output_configs(&config);
+ */
+static void refresh_output_configs(const Config *config) {
+    static Config device_config; // Large; display_set_output_config() keeps its own copy
+    for (int i = 0; i < display_output_count(); ++i) {
+        const char *uid = display_output_uid(i);
+        const DeviceConfig *device = NULL;
+        for (int d = 0; d < config->device_count && !device; ++d) {
+            if (strcmp(config->devices[d].uid, uid) == 0) device = &config->devices[d];
+        }
+        if (config_for_device(config, device, &device_config) == 0) display_set_output_config(i, &device_config);
+    }
+}
+
+/**
+ * @brief Swap a validated configuration into the running daemon.
+ * @details The sampler is stopped and the upload worker held while the live and per-output configurations are overwritten, so no thread ever reads a half-written Config. The CoolerControl session, its connections and the device index are kept. Only what the change invalidates is rebuilt: the hwmon scan and the CPU and coolant sensor lookups on a new hwmon path, the request timeouts of the session on a new refresh interval, the nvidia-smi stream on a new GPU interval and, on the next frame, the render caches whose inputs changed (glyph atlas on a font change, background on a layout or color change, multipart template on a brightness or orientation change).
+ * @example
+ *     apply_config(&fresh);
+ */
+static void apply_config(const Config *fresh) {
+    Config *live = reload.config;
+    int sensors_changed = strcmp(live->hwmon_path, fresh->hwmon_path) != 0;
+    int gpu_changed = live->gpu_cache_interval != fresh->gpu_cache_interval;
+    int image_dir_changed = strcmp(live->image_dir, fresh->image_dir) != 0;
+    int interval_changed = live->display_refresh_interval_sec != fresh->display_refresh_interval_sec ||
+                           live->display_refresh_interval_nsec != fresh->display_refresh_interval_nsec;
+    int sampler_was_running = sampler_is_running();
+    sampler_stop(); // Reads the live configuration on its own thread
+    uploader_pause(); // Reads the output and session configurations on its own thread
+    *live = *fresh;
+    refresh_output_configs(live);
+    if (interval_changed) update_coolercontrol_timeouts(live); // Request deadlines follow the refresh interval
+    uploader_resume();
+    if (sensors_changed) {
+        sensors_cleanup();
+        init_cpu_sensor_path(live);
+        init_coolant_sensor_path(live); // The old index points into the freed registry
+        printf("CoolerDash: hwmon rescanned (%d sensors)\n", sensors_count());
+    }
+    if (gpu_changed) stop_gpu_stream(); // Restarted with the new interval on the next read
+    if (image_dir_changed) mkdir(live->image_dir, 0755);
+    if (sampler_was_running && !sampler_start(live)) {
+        printf("⚠ Sensor sampler thread not available, sampling inline\n");
+    }
+    display_redraw(); // Show the new settings even if the temperatures did not change
+    if (reload.timer && !arm_render_timer(reload.timer)) {
+        fprintf(stderr, "CoolerDash: Error - could not re-arm the render timer\n");
+    }
+}
+
+/**
+ * @brief Handle a configuration reload request (SIGHUP, file change or control socket).
+ * @details Parses the configuration file into a fresh Config and validates it; on any error the running configuration stays untouched. Settings that need a restart keep their running values. Writes the outcome to reply if given (may be NULL).
+ * @example
+ *     handle_reload(NULL, 0);
+ */
+static void handle_reload(char *reply, size_t reply_size) {
+    static Config fresh; // Large; avoid the stack
+    char message[640];
+    char notes[512];
+    char error[160];
+    if (!reload.config) {
+        snprintf(message, sizeof(message), "error: configuration reload is not available yet\n");
+    } else if (load_config_ini(&fresh, reload.path) != 0) {
+        snprintf(message, sizeof(message), "error: could not read %.256s; keeping the running configuration\n", reload.path);
+    } else if (config_validate(&fresh, error, sizeof(error)) != 0) {
+        snprintf(message, sizeof(message), "error: %s; keeping the running configuration\n", error);
+    } else {
+        keep_restart_settings(reload.config, &fresh, notes, sizeof(notes));
+        if (memcmp(reload.config, &fresh, sizeof(fresh)) == 0) {
+            snprintf(message, sizeof(message), "ok: configuration unchanged\n%s", notes);
+        } else {
+            apply_config(&fresh);
+            snprintf(message, sizeof(message), "ok: configuration reloaded\n%s", notes);
+        }
+    }
+    printf("CoolerDash: Reload %s", message);
+    fflush(stdout);
+    if (reply) snprintf(reply, reply_size, "%s", message);
+}
+
+/**
+ * @brief Watch the directory of the configuration file for changes.
+ * @details Editors often save by renaming a new file over the old one, so the directory is watched for completed writes (IN_CLOSE_WRITE) and renames into it (IN_MOVED_TO); on_config_changed() filters by file name. Returns a non-blocking inotify descriptor, or -1 on failure.
+ * @example
+ *     int watch_fd = open_config_watch(config_path);
+ */
+static int open_config_watch(const char *path) {
+    char directory[256];
+    const char *slash = strrchr(path, '/');
+    if (!slash) {
+        snprintf(directory, sizeof(directory), ".");
+        reload.file_name = path;
+    } else {
+        int length = slash == path ? 1 : (int)(slash - path);
+        if (length >= (int)sizeof(directory)) return -1;
+        snprintf(directory, sizeof(directory), "%.*s", length, path);
+        reload.file_name = slash + 1;
+    }
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return -1;
+    if (inotify_add_watch(fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(fd);
         return -1;
     }
-    return 0;
+    return fd;
+}
+
+/**
+ * @brief Event loop handler of the configuration file watch.
+ * @details Drains all pending inotify events and reloads once if any of them concerns the configuration file, so the several events of one save cause a single reload.
+ * @example
+ *     // Not intended for direct use; registered by run_daemon().
+ */
+static void on_config_changed(int fd, uint32_t events, void *user) {
+    (void)events;
+    (void)user;
+    char buffer[CONFIG_WATCH_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int changed = 0;
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + n; p += sizeof(struct inotify_event) + ((struct inotify_event *)p)->len) {
+            const struct inotify_event *event = (const struct inotify_event *)p;
+            if (event->len > 0 && strcmp(event->name, reload.file_name) == 0) changed = 1;
+        }
+    }
+    if (changed) handle_reload(NULL, 0);
+}
+
+/**
+ * @brief Event loop handler of the render timerfd.
+ * @details Renders one frame per expiration. Expirations that accumulated while the loop was busy, and those that pass during the frame itself, are skipped rather than rendered back to back. Records wake-up lateness and frame work per tick.
+ * @example
+ *     // Not intended for direct use; registered by run_daemon().
+ */
+static void on_render_tick(int fd, uint32_t events, void *user) {
+    (void)events;
+    render_timer_t *timer = user;
+    uint64_t expirations = 0;
+    if (read(fd, &expirations, sizeof(expirations)) != (ssize_t)sizeof(expirations) || expirations == 0) return;
+    if (expirations > 1) { // Late wakeup: only the newest tick is rendered
+        schedule_stats.skipped += expirations - 1;
+        timer->deadline_ns += (long long)(expirations - 1) * timer->period_ns;
+    }
+    long long start_ns = monotonic_ns();
+    histogram_record(&schedule_stats.lateness_us, (uint64_t)(start_ns - timer->deadline_ns) / 1000);
+    schedule_stats.ticks++;
+    draw_combined_image(timer->config); // Draw combined image
+    long long end_ns = monotonic_ns();
+    if (!startup.mark_ns[STARTUP_FIRST_FRAME] && display_output_count() > 0) {
+        startup_mark(STARTUP_FIRST_FRAME);
+        print_startup_stats();
+    }
+    histogram_record(&schedule_stats.work_us, (uint64_t)(end_ns - start_ns) / 1000);
+    timer->deadline_ns += timer->period_ns;
+    // Overrun: drop the ticks that already passed during this frame
+    if (read(fd, &expirations, sizeof(expirations)) == (ssize_t)sizeof(expirations)) {
+        schedule_stats.skipped += expirations;
+        timer->deadline_ns += (long long)expirations * timer->period_ns;
+    }
+}
+
+/**
+ * @brief Event loop handler of the signalfd.
+ * @details SIGTERM/SIGINT stop the loop, SIGHUP requests a configuration reload and SIGUSR1 prints the runtime statistics. Runs in normal context, so any function may be used.
+ * @example
+ *     // Not intended for direct use; registered by run_daemon().
+ */
+static void on_signal(int fd, uint32_t events, void *user) {
+    (void)events;
+    (void)user;
+    struct signalfd_siginfo info;
+    while (read(fd, &info, sizeof(info)) == (ssize_t)sizeof(info)) {
+        switch (info.ssi_signo) {
+            case SIGTERM:
+            case SIGINT:
+                running = 0;
+                break;
+            case SIGHUP:
+                handle_reload(NULL, 0);
+                break;
+            case SIGUSR1:
+                print_runtime_stats();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Event loop handler of the HTTP engine.
+ * @details Only registered without upload worker: the main thread then owns the engine and drives its transfers and timers (e.g. health probes) from the loop.
+ * @example
+ *     // Not intended for direct use; registered by run_daemon().
+ */
+static void on_engine_ready(int fd, uint32_t events, void *user) {
+    (void)fd;
+    (void)events;
+    (void)user;
+    http_engine_run(0);
+}
+
+/**
+ * @brief Return a name for a circuit breaker state.
+ * @details Used by the control socket status reply.
+ * @example
+ *     printf("%s\n", link_state_name(stats.state));
+ */
+static const char *link_state_name(cc_link_state_t state) {
+    switch (state) {
+        case CC_LINK_UP: return "up";
+        case CC_LINK_DOWN: return "down";
+        case CC_LINK_RECOVERING: return "recovering";
+        default: return "unknown";
+    }
+}
+
+/**
+ * @brief Handle one control socket command.
+ * @details Commands: status, stats, reload, help.
+ * @example
+ *     // Not intended for direct use; passed to control_open().
+ */
+static void on_control_command(const char *command, char *reply, size_t reply_size) {
+    cc_link_stats_t link;
+    get_lcd_link_stats(&link);
+    if (strcmp(command, "status") == 0) {
+        snprintf(reply, reply_size, "running\nlink %s\noutputs %d\nticks %llu\nskipped %llu\n",
+                 link_state_name(link.state), display_output_count(), schedule_stats.ticks, schedule_stats.skipped);
+    } else if (strcmp(command, "stats") == 0) {
+        const histogram_t *late = &schedule_stats.lateness_us;
+        const histogram_t *work = &schedule_stats.work_us;
+        lcd_delivery_stats_t delivery;
+        get_lcd_delivery_stats(&delivery);
+        uploader_stats_t uploads;
+        uploader_get_stats(&uploads);
+        snprintf(reply, reply_size,
+                 "ticks %llu\nskipped %llu\nlateness_ms p50 %.3f p99 %.3f max %.3f\nwork_ms p50 %.3f p99 %.3f max %.3f\n"
+                 "uploads submitted %llu superseded %llu taken %llu uploaded %llu failed %llu not_sent %llu\n"
+                 "delivery delivered %llu retries %llu failures %llu missed %llu reauths %llu\n"
+                 "link %s outages %llu recoveries %llu probes %llu frames_skipped %llu\n"
+                 "startup_ms first_frame %.1f first_ack %.1f\n",
+                 schedule_stats.ticks, schedule_stats.skipped,
+                 histogram_percentile(late, 50.0) / 1e3, histogram_percentile(late, 99.0) / 1e3, late->max / 1e3,
+                 histogram_percentile(work, 50.0) / 1e3, histogram_percentile(work, 99.0) / 1e3, work->max / 1e3,
+                 uploads.submitted, uploads.superseded, uploads.taken, uploads.uploaded, uploads.failed, uploads.not_sent,
+                 delivery.delivered, delivery.retries, delivery.failures, delivery.missed, delivery.reauths,
+                 link_state_name(link.state), link.outages, link.recoveries, link.probes, link.frames_skipped,
+                 startup.mark_ns[STARTUP_FIRST_FRAME] ? (startup.mark_ns[STARTUP_FIRST_FRAME] - startup.begin_ns) / 1e6 : 0.0,
+                 delivery.first_delivered_ms ? (delivery.first_delivered_ms * 1000000LL - startup.begin_ns) / 1e6 : 0.0);
+    } else if (strcmp(command, "reload") == 0) {
+        handle_reload(reply, reply_size);
+    } else if (strcmp(command, "help") == 0) {
+        snprintf(reply, reply_size, "commands: status, stats, reload, help\n");
+    } else {
+        snprintf(reply, reply_size, "error: unknown command '%.64s' (try help)\n", command);
+    }
 }
 
 /**
- * @brief Write current PID to PID file.
- * @details Writes the current process ID to the specified PID file for single-instance enforcement.
+ * @brief Block the daemon signals and return a signalfd for them.
+ * @details Must run before any thread or child is started, so the signals are only ever consumed through the descriptor. If signalfd() is unavailable, SIGTERM/SIGINT fall back to a flag-only handler and -1 is returned.
  * @example
- *     write_pid_file("/var/run/coolerdash.pid");
+ *     int signal_fd = open_signal_fd();
  */
-static void write_pid_file(const char *pid_file) {
-    FILE *f = fopen(pid_file, "w");
-    if (f) {
-        fprintf(f, "%d\n", getpid());
-        fclose(f);
+static int open_signal_fd(void) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGHUP);
+    sigaddset(&set, SIGUSR1);
+    if (sigprocmask(SIG_BLOCK, &set, NULL) == 0) {
+        int fd = signalfd(-1, &set, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (fd >= 0) return fd;
+        sigprocmask(SIG_UNBLOCK, &set, NULL);
     }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_termination_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0; // No SA_RESTART: epoll_wait() returns EINTR
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    return -1;
 }
 
 /**
  * @brief Main daemon loop.
- * @details Runs the main loop of the daemon, periodically updating the display with sensor data until termination is requested. Uses draw_combined_image(), nanosleep(). Checks the running flag for termination. Returns 0 on normal exit.
+ * @details Runs the main loop of the daemon, periodically updating the display with sensor data until termination is requested. Everything the main thread reacts to is an event loop source: the render timerfd (absolute CLOCK_MONOTONIC deadlines, so the period does not stretch by the render and upload time), the signalfd, the configuration file watch (inotify), the HTTP engine when no upload worker owns it, and the optional control socket. The thread sleeps in epoll_wait() until one of them has work. Returns 0 on normal exit, 1 if the loop could not be set up.
  * @example
- *     int result = run_daemon(&config);
+ *     int result = run_daemon(&config, signal_fd);
  */
-static int run_daemon(const Config *config) {
+static int run_daemon(const Config *config, int signal_fd) {
     printf("CoolerDash daemon started\n");
     printf("Sensor data updated every %d.%d seconds\n", 
            config->display_refresh_interval_sec, config->display_refresh_interval_nsec / 100000000);
     printf("Daemon now running silently in background...\n\n");
     fflush(stdout);
+    render_timer_t timer = { .config = config };
+    timer.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer.fd < 0 || !event_loop_init() || !arm_render_timer(&timer) || // First frame right away
+        !event_loop_add(timer.fd, on_render_tick, &timer)) {
+        fprintf(stderr, "CoolerDash: Error - could not set up the main event loop\n");
+        if (timer.fd >= 0) close(timer.fd);
+        event_loop_cleanup();
+        return 1;
+    }
+    reload.timer = &timer;
+    if (signal_fd >= 0) event_loop_add(signal_fd, on_signal, NULL);
+    int watch_fd = reload.path ? open_config_watch(reload.path) : -1;
+    if (watch_fd >= 0 && !event_loop_add(watch_fd, on_config_changed, NULL)) {
+        close(watch_fd);
+        watch_fd = -1;
+    }
+    if (watch_fd < 0) {
+        printf("⚠ Configuration file is not watched; use SIGHUP to reload\n");
+        fflush(stdout);
+    }
+    int engine_registered = !uploader_is_running() && event_loop_add(http_engine_fd(), on_engine_ready, NULL);
+    if (config->control_socket[0]) {
+        if (control_open(config->control_socket, on_control_command)) {
+            printf("CoolerDash: Control socket listening on %s\n", config->control_socket);
+        } else {
+            printf("⚠ Control socket %s not available\n", config->control_socket);
+        }
+        fflush(stdout);
+    }
     while (running) { // Main daemon loop
-        draw_combined_image(config); // Draw combined image
-        struct timespec ts = {config->display_refresh_interval_sec, config->display_refresh_interval_nsec}; // Wait time for update
-        nanosleep(&ts, NULL); // Wait for specified time
+        if (event_loop_run(-1) < 0) break;
+    }
+    control_close();
+    if (engine_registered) event_loop_remove(http_engine_fd());
+    if (watch_fd >= 0) {
+        event_loop_remove(watch_fd);
+        close(watch_fd);
     }
+    event_loop_cleanup();
+    close(timer.fd);
+    reload.timer = NULL;
     // Silent termination without output
     return 0;
 }
@@ -171,17 +949,6 @@ static void show_help(const char *program_name, const Config *config) {
     printf("To start manually: %s [config_path]\n", program_name);
 }
 
-/**
- * @brief Detect if we were started by systemd.
- * @details Checks if the parent process is PID 1 (systemd/init). Returns 1 if started by systemd, 0 otherwise.
- * @example
- *     int is_service = is_started_by_systemd();
- */
-static int is_started_by_systemd(void) {
-    // Simple and reliable method: Check if our parent process is PID 1 (init/systemd)
-    return (getppid() == 1);
-}
-
 /**
  * @brief Main entry point for CoolerDash.
  * @details Loads configuration, initializes modules, and starts the main daemon loop.
@@ -190,6 +957,7 @@ static int is_started_by_systemd(void) {
  */
 int main(int argc, char **argv)
 {
+    startup.begin_ns = monotonic_ns();
     // Check for help argument
     if (argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
         show_help(argv[0], NULL);
@@ -205,24 +973,17 @@ int main(int argc, char **argv)
         return 1;
     }
     
-    // Check if we were started by systemd
-    int is_service_start = is_started_by_systemd();
-    // Single-Instance Enforcement: Check and handle existing instances
-    if (check_existing_instance_and_handle(config.pid_file, is_service_start) < 0) {
-        // Error: Service already running and we are manual start
+    startup_mark(STARTUP_CONFIG);
+    // Single-Instance Enforcement: lock the PID file (held until exit)
+    if (acquire_pid_file(config.pid_file) < 0) {
         return 1;
     }
-    // Write new PID file
-    write_pid_file(config.pid_file);
-    g_config_ptr = &config; // Set global pointer for signal handler
-    // Register signal handlers
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = cleanup_and_exit;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_flags = 0;
-    sigaction(SIGTERM, &sa, NULL);
-    sigaction(SIGINT, &sa, NULL);
+    startup_mark(STARTUP_INSTANCE);
+    g_config_ptr = &config; // Set global pointer for cleanup
+    reload.path = config_path;
+    reload.config = &config;
+    // Route signals to the main loop (before any thread or child inherits the mask)
+    int signal_fd = open_signal_fd();
     // Create image directory
     mkdir(config.image_dir, 0755); // Create directory for images if not present
     // Initialize modules
@@ -230,8 +991,10 @@ int main(int argc, char **argv)
     fflush(stdout);
     // Initialize CPU sensors
     init_cpu_sensor_path(&config); // Set path to CPU sensors
-    printf("✓ CPU monitor initialized\n");
+    init_coolant_sensor_path(&config); // Same registry scan
+    printf("✓ CPU monitor initialized (%d hwmon sensors)\n", sensors_count());
     fflush(stdout);
+    startup_mark(STARTUP_SENSORS);
     // Initialize GPU monitor (if GPU available)
     if (init_gpu_monitor(&config)) { // Check return value
         printf("✓ GPU monitor initialized\n");
@@ -239,6 +1002,7 @@ int main(int argc, char **argv)
         printf("⚠ GPU monitor not available (no NVIDIA GPU?)\n");
     }
     fflush(stdout);
+    startup_mark(STARTUP_GPU);
     // Initialize CoolerControl session
     if (init_coolercontrol_session(&config)) { // Check return value
         printf("✓ CoolerControl session initialized\n");
@@ -271,26 +1035,34 @@ int main(int argc, char **argv)
         fprintf(stderr, "CoolerDash: Failed to detect LCD device UID\n");
         return 1;
     }
+    // Register one output per LCD device (stays idle if no [device.*] section matches)
+    setup_outputs(&config);
+    startup_mark(STARTUP_SESSION);
+    // Start upload worker (falls back to inline uploads on failure)
+    if (uploader_start()) {
+        printf("✓ Upload worker thread started\n");
+    } else {
+        printf("⚠ Upload worker thread not available, uploading inline\n");
+    }
+    // Start background sensor sampler (falls back to inline sampling on failure)
+    if (sampler_start(&config)) {
+        printf("✓ Sensor sampler thread started\n");
+    } else {
+        printf("⚠ Sensor sampler thread not available, sampling inline\n");
+    }
     printf("All modules successfully initialized!\n\n");
     fflush(stdout);
+    startup_mark(STARTUP_WORKERS);
     // Start daemon
-    int result = run_daemon(&config);
-    // Cleanup - send shutdown image if not sent yet (only on normal termination)
-    if (!shutdown_sent && is_session_initialized()) {
-        const char* shutdown_image = g_config_ptr->shutdown_image;
-        const char* device_uid = get_cached_device_uid();
-        printf("CoolerDash: Sending final shutdown image...\n");
-        fflush(stdout);
-        if (device_uid[0]) {
-            send_image_to_lcd(&config, shutdown_image, device_uid);
-            send_image_to_lcd(&config, shutdown_image, device_uid);
-            printf("CoolerDash: Final shutdown image sent successfully\n");
-        } else {
-            printf("CoolerDash: Warning - Could not send final shutdown image (device UID not detected)\n");
-        }
-        fflush(stdout);
-    }
+    int result = run_daemon(&config, signal_fd);
+    sampler_stop(); // Stop sampling before tearing down sensors
+    uploader_stop(); // Let an in-flight frame finish; drop any pending one
+    send_shutdown_image();
+    print_runtime_stats();
     cleanup_coolercontrol_session(); // Terminate CoolerControl session
-    cleanup_and_exit(0); // Remove PID file and terminate daemon
+    sensors_cleanup(); // Close hwmon descriptors
+    cleanup_display(); // Free render target
+    cleanup_gpu_monitor(); // Unload GPU backend
+    cleanup_and_exit(); // Remove PID file and terminate daemon
     return result;
 }
\ No newline at end of file
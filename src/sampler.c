@@ -0,0 +1,268 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Background sensor sampling implementation for CoolerDash.
+ * @details Implements the sampler thread and the seqlock used to publish sensor snapshots to the render loop.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable pthread, clock_gettime() and pthread_condattr_setclock()
+#define _POSIX_C_SOURCE 200809L
+
+// Include project headers
+#include "../include/sampler.h"
+#include "../include/config.h"
+#include "../include/cpu_monitor.h"
+#include "../include/gpu_monitor.h"
+#include "../include/sensors.h"
+
+// Include necessary headers
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+/**
+ * @brief Seqlock-protected published snapshot.
+ * @details The writer makes seq odd, stores the fields and makes seq even again. Readers retry while seq is odd or changed during the copy. Fields are accessed with relaxed atomics so the copy is race-free; ordering comes from the fences around seq.
+ * @example
+ *     // Not intended for direct use; see sampler_read().
+ */
+static struct {
+    unsigned int seq;
+    float cpu_temp;
+    float gpu_temp;
+    long long timestamp_ns; // CLOCK_MONOTONIC time the values were sampled, 0 = none yet
+} published = {0, 0.0f, 0.0f, 0};
+
+/**
+ * @brief Sampler thread control state.
+ * @details The mutex/condvar pair is only used to sleep between passes and to wake the thread on stop; it is never touched by readers.
+ * @example
+ *     // Not intended for direct use; managed by sampler_start()/sampler_stop().
+ */
+static struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    int running;
+    int stop_requested;
+    const Config *config;
+} ctl = { .lock = PTHREAD_MUTEX_INITIALIZER, .running = 0, .stop_requested = 0, .config = NULL };
+
+static sampler_stats_t stats = {0};
+
+/**
+ * @brief Get current CLOCK_MONOTONIC time in nanoseconds.
+ * @details Used for snapshot timestamps, latency and staleness measurements.
+ * @example
+ *     long long now = monotonic_ns();
+ */
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Collect one set of sensor values synchronously.
+ * @details One batched pass over the watched hwmon sensors plus the GPU backend read.
+ * @example
+ *     sampler_sample_once(&config, &data);
+ */
+void sampler_sample_once(const Config *config, sensor_data_t *data) {
+    static sensors_snapshot_t snapshot; // static: too large for a per-tick stack frame
+    sensors_sample_all(&snapshot);
+    data->cpu_temp = cpu_temp_from_snapshot(&snapshot);
+    data->gpu_temp = read_gpu_temp(config);
+}
+
+/**
+ * @brief Publish a snapshot through the seqlock (writer side).
+ * @details Single writer only (the sampler thread).
+ * @example
+ *     publish(&data, timestamp_ns);
+ */
+static void publish(const sensor_data_t *data, long long timestamp_ns) {
+    unsigned int seq = __atomic_load_n(&published.seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&published.seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store(&published.cpu_temp, &data->cpu_temp, __ATOMIC_RELAXED);
+    __atomic_store(&published.gpu_temp, &data->gpu_temp, __ATOMIC_RELAXED);
+    __atomic_store_n(&published.timestamp_ns, timestamp_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&published.seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Run one sampling pass, publish it and update latency counters.
+ * @details Returns the CLOCK_MONOTONIC start time of the pass.
+ * @example
+ *     long long start_ns = sample_and_publish(config);
+ */
+static long long sample_and_publish(const Config *config) {
+    sensor_data_t data = {0};
+    long long start_ns = monotonic_ns();
+    sampler_sample_once(config, &data);
+    long long end_ns = monotonic_ns();
+    publish(&data, start_ns);
+
+    long long latency = end_ns - start_ns;
+    __atomic_store_n(&stats.last_latency_ns, latency, __ATOMIC_RELAXED);
+    if (latency > __atomic_load_n(&stats.max_latency_ns, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&stats.max_latency_ns, latency, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&stats.total_latency_ns, latency, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats.samples, 1, __ATOMIC_RELAXED);
+    return start_ns;
+}
+
+/**
+ * @brief Sampler thread main loop.
+ * @details Sleeps until the next pass (measured from the start of the previous one) or until a stop is requested, then samples and publishes.
+ * @example
+ *     // Not intended for direct use; started by sampler_start().
+ */
+static void *sampler_thread(void *arg) {
+    long long last_start_ns = *(const long long *)arg;
+    const Config *config = ctl.config;
+    long long interval_ns = (long long)config->display_refresh_interval_sec * 1000000000LL + config->display_refresh_interval_nsec;
+    if (interval_ns <= 0) interval_ns = 1000000000LL;
+
+    pthread_mutex_lock(&ctl.lock);
+    while (!ctl.stop_requested) {
+        long long wake_ns = last_start_ns + interval_ns;
+        struct timespec deadline = { (time_t)(wake_ns / 1000000000LL), (long)(wake_ns % 1000000000LL) };
+        if (pthread_cond_timedwait(&ctl.wake, &ctl.lock, &deadline) == 0) {
+            continue; // Stop request or spurious wakeup: re-check the flag
+        }
+        if (ctl.stop_requested) break;
+        pthread_mutex_unlock(&ctl.lock);
+        last_start_ns = sample_and_publish(config);
+        pthread_mutex_lock(&ctl.lock);
+    }
+    pthread_mutex_unlock(&ctl.lock);
+    return NULL;
+}
+
+/**
+ * @brief Start the background sampler thread.
+ * @details Takes the first sample on the calling thread, then hands over to the sampler thread. The condition variable uses CLOCK_MONOTONIC so wall-clock jumps do not disturb the schedule. All signals are blocked while the thread is created so it inherits a full mask.
+ * @example
+ *     sampler_start(&config);
+ */
+int sampler_start(const Config *config) {
+    if (!config || ctl.running) return ctl.running;
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int rc = pthread_cond_init(&ctl.wake, &attr);
+    pthread_condattr_destroy(&attr);
+    if (rc != 0) return 0;
+
+    ctl.config = config;
+    ctl.stop_requested = 0;
+    // Publish a first snapshot synchronously so readers never find the slot empty
+    static long long first_start_ns;
+    first_start_ns = sample_and_publish(config);
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    rc = pthread_create(&ctl.thread, NULL, sampler_thread, &first_start_ns);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (rc != 0) {
+        pthread_cond_destroy(&ctl.wake);
+        return 0;
+    }
+    ctl.running = 1;
+    return 1;
+}
+
+/**
+ * @brief Stop and join the background sampler thread.
+ * @details Signals the condition variable so the thread exits without finishing its sleep.
+ * @example
+ *     sampler_stop();
+ */
+void sampler_stop(void) {
+    if (!ctl.running) return;
+    pthread_mutex_lock(&ctl.lock);
+    ctl.stop_requested = 1;
+    pthread_cond_signal(&ctl.wake);
+    pthread_mutex_unlock(&ctl.lock);
+    pthread_join(ctl.thread, NULL);
+    pthread_cond_destroy(&ctl.wake);
+    ctl.running = 0;
+}
+
+/**
+ * @brief Return whether the background sampler is running.
+ * @details Only changed by sampler_start()/sampler_stop() on the main thread.
+ * @example
+ *     if (sampler_is_running()) { ... }
+ */
+int sampler_is_running(void) {
+    return ctl.running;
+}
+
+/**
+ * @brief Read the latest published snapshot.
+ * @details Seqlock reader: retries while a publish is in progress. Updates the staleness counters.
+ * @example
+ *     sampler_read(&data);
+ */
+int sampler_read(sensor_data_t *data) {
+    if (!data) return 0;
+    unsigned int seq0, seq1;
+    long long timestamp_ns;
+    unsigned long long retries = 0;
+    for (;;) {
+        seq0 = __atomic_load_n(&published.seq, __ATOMIC_ACQUIRE);
+        if (seq0 & 1) {
+            retries++;
+            continue;
+        }
+        __atomic_load(&published.cpu_temp, &data->cpu_temp, __ATOMIC_RELAXED);
+        __atomic_load(&published.gpu_temp, &data->gpu_temp, __ATOMIC_RELAXED);
+        timestamp_ns = __atomic_load_n(&published.timestamp_ns, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        seq1 = __atomic_load_n(&published.seq, __ATOMIC_RELAXED);
+        if (seq0 == seq1) break;
+        retries++;
+    }
+    if (retries) __atomic_fetch_add(&stats.read_retries, retries, __ATOMIC_RELAXED);
+    if (timestamp_ns == 0) return 0;
+
+    long long staleness = monotonic_ns() - timestamp_ns;
+    __atomic_store_n(&stats.last_staleness_ns, staleness, __ATOMIC_RELAXED);
+    if (staleness > __atomic_load_n(&stats.max_staleness_ns, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&stats.max_staleness_ns, staleness, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&stats.total_staleness_ns, staleness, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats.reads, 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+/**
+ * @brief Copy the sampler instrumentation counters.
+ * @details Each field is loaded atomically; fields may come from different passes.
+ * @example
+ *     sampler_get_stats(&stats);
+ */
+void sampler_get_stats(sampler_stats_t *out) {
+    if (!out) return;
+    out->samples = __atomic_load_n(&stats.samples, __ATOMIC_RELAXED);
+    out->last_latency_ns = __atomic_load_n(&stats.last_latency_ns, __ATOMIC_RELAXED);
+    out->max_latency_ns = __atomic_load_n(&stats.max_latency_ns, __ATOMIC_RELAXED);
+    out->total_latency_ns = __atomic_load_n(&stats.total_latency_ns, __ATOMIC_RELAXED);
+    out->reads = __atomic_load_n(&stats.reads, __ATOMIC_RELAXED);
+    out->last_staleness_ns = __atomic_load_n(&stats.last_staleness_ns, __ATOMIC_RELAXED);
+    out->max_staleness_ns = __atomic_load_n(&stats.max_staleness_ns, __ATOMIC_RELAXED);
+    out->total_staleness_ns = __atomic_load_n(&stats.total_staleness_ns, __ATOMIC_RELAXED);
+    out->read_retries = __atomic_load_n(&stats.read_retries, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,83 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Persistent-descriptor sysfs reader implementation for CoolerDash.
+ * @details Implements pread-per-sample access to hwmon value files and the integer parser shared by all sensor lookups.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable pread()
+#define _POSIX_C_SOURCE 200809L
+
+// Include project headers
+#include "../include/sensor_reader.h"
+
+// Include necessary headers
+#include <errno.h>
+#include <unistd.h>
+
+/**
+ * @brief Parse a decimal integer from a sysfs buffer.
+ * @details Skips leading whitespace, accepts an optional minus sign and stops at the first non-digit. Does not require null termination.
+ * @example
+ *     long v;
+ *     sensor_parse_long("45000\n", 6, &v);
+ */
+int sensor_parse_long(const char *buf, size_t len, long *value) {
+    size_t i = 0;
+    while (i < len && (buf[i] == ' ' || buf[i] == '\t')) i++;
+    int negative = 0;
+    if (i < len && buf[i] == '-') {
+        negative = 1;
+        i++;
+    }
+    long v = 0;
+    size_t digits = 0;
+    while (i < len && buf[i] >= '0' && buf[i] <= '9') {
+        v = v * 10 + (buf[i] - '0');
+        i++;
+        digits++;
+    }
+    if (digits == 0) return 0;
+    *value = negative ? -v : v;
+    return 1;
+}
+
+/**
+ * @brief Read the current integer value from an open sysfs descriptor.
+ * @details Steady state is exactly one pread() syscall and no heap traffic. An empty or unparsable value sets errno to EIO, so a stale errno from an earlier call is never mistaken for a vanished device.
+ * @example
+ *     long millideg;
+ *     sensor_pread_long(fd, &millideg);
+ */
+int sensor_pread_long(int fd, long *value) {
+    if (fd < 0 || !value) {
+        errno = EBADF;
+        return 0;
+    }
+    char buf[32];
+    ssize_t n = pread(fd, buf, sizeof(buf), 0);
+    if (n < 0) return 0; // errno set by pread()
+    if (n == 0 || !sensor_parse_long(buf, (size_t)n, value)) {
+        errno = EIO;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Check whether a failed read means the descriptor must be reopened.
+ * @details A hwmon device that was unbound/rebound (e.g. driver reload, USB AIO reconnect) reports ENODEV or ESTALE on the old descriptor.
+ * @example
+ *     if (sensor_read_needs_reopen()) { ... }
+ */
+int sensor_read_needs_reopen(void) {
+    return errno == ENODEV || errno == ESTALE;
+}
@@ -0,0 +1,316 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Unified hwmon sensor registry implementation for CoolerDash.
+ * @details Implements one-pass hwmon discovery with openat()/dirfd and batched sampling of all inputs through persistent descriptors.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable openat(), fdopendir(), clock_gettime()
+#define _POSIX_C_SOURCE 200809L
+
+// Include project headers
+#include "../include/sensors.h"
+#include "../include/sensor_reader.h"
+#include "../include/config.h"
+
+// Include necessary headers
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Sensor registry stored as struct-of-arrays.
+ * @details The hot sampling loop only touches watched[] and fd[]; kind/chip/name/label are used at lookup and reopen time. Chip directory descriptors stay open so inputs can be reopened with openat() without rebuilding paths.
+ * @example
+ *     // Not intended for direct use; managed by module functions.
+ */
+static struct {
+    int initialized;
+    int count;
+    int fd[SENSORS_MAX];
+    unsigned char kind[SENSORS_MAX];
+    unsigned char chip[SENSORS_MAX];
+    char name[SENSORS_MAX][SENSOR_NAME_SIZE];   // e.g. "temp1_input"
+    char label[SENSORS_MAX][SENSOR_LABEL_SIZE]; // e.g. "Package id 0"
+    int watched_count;
+    int watched[SENSORS_MAX];                   // Indices read by sensors_sample_all()
+    int chip_count;
+    int chip_dirfd[SENSORS_MAX_CHIPS];
+    char chip_name[SENSORS_MAX_CHIPS][SENSOR_LABEL_SIZE]; // hwmon "name" attribute
+} registry = {0};
+
+/**
+ * @brief Filename prefixes per sensor kind.
+ * @details Indexed by sensor_kind_t.
+ * @example
+ *     // Not intended for direct use.
+ */
+static const char *const kind_prefix[SENSOR_KIND_COUNT] = { "temp", "fan", "pwm", "power", "in" };
+
+/**
+ * @brief Read a short attribute file relative to a directory descriptor.
+ * @details Reads at most size-1 bytes and strips the trailing newline. Returns 1 on success, 0 on failure.
+ * @example
+ *     read_attr(chipfd, "temp1_label", label, sizeof(label));
+ */
+static int read_attr(int dirfd, const char *name, char *buf, size_t size) {
+    int fd = openat(dirfd, name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    ssize_t n = read(fd, buf, size - 1);
+    close(fd);
+    if (n <= 0) return 0;
+    buf[n] = '\0';
+    char *nl = strchr(buf, '\n');
+    if (nl) *nl = '\0';
+    return 1;
+}
+
+/**
+ * @brief Classify a hwmon attribute filename as a sensor input.
+ * @details Accepts tempN_input, fanN_input, inN_input, powerN_input, powerN_average and bare pwmN. Writes the kind and the "<prefix>N" stem (used to locate the _label file). Returns 1 if the file is a sensor input, 0 otherwise.
+ * @example
+ *     sensor_kind_t kind; char stem[16];
+ *     classify_input("temp1_input", &kind, stem, sizeof(stem));
+ */
+static int classify_input(const char *fname, sensor_kind_t *kind, char *stem, size_t stem_size) {
+    for (int k = 0; k < SENSOR_KIND_COUNT; ++k) {
+        size_t plen = strlen(kind_prefix[k]);
+        if (strncmp(fname, kind_prefix[k], plen) != 0) continue;
+        const char *p = fname + plen;
+        if (!isdigit((unsigned char)*p)) continue;
+        while (isdigit((unsigned char)*p)) p++;
+        const char *suffix = p;
+        int ok;
+        if (k == SENSOR_KIND_PWM) ok = (*suffix == '\0');
+        else if (k == SENSOR_KIND_POWER) ok = (strcmp(suffix, "_input") == 0 || strcmp(suffix, "_average") == 0);
+        else ok = (strcmp(suffix, "_input") == 0);
+        if (!ok) continue;
+        size_t stem_len = (size_t)(suffix - fname);
+        if (stem_len >= stem_size) return 0;
+        memcpy(stem, fname, stem_len);
+        stem[stem_len] = '\0';
+        *kind = (sensor_kind_t)k;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Register all inputs of one hwmon chip.
+ * @details Lists the chip directory through a duplicated descriptor so chipfd itself stays usable for openat(). Stops silently when the registry is full.
+ * @example
+ *     register_chip_inputs(chip_index);
+ */
+static void register_chip_inputs(int chip_index) {
+    int chipfd = registry.chip_dirfd[chip_index];
+    int listfd = dup(chipfd);
+    if (listfd < 0) return;
+    DIR *dir = fdopendir(listfd);
+    if (!dir) {
+        close(listfd);
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && registry.count < SENSORS_MAX) {
+        sensor_kind_t kind;
+        char stem[16];
+        if (strlen(entry->d_name) >= SENSOR_NAME_SIZE) continue;
+        if (!classify_input(entry->d_name, &kind, stem, sizeof(stem))) continue;
+        int fd = openat(chipfd, entry->d_name, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) continue; // e.g. write-only or permission denied
+        int i = registry.count++;
+        registry.fd[i] = fd;
+        registry.kind[i] = (unsigned char)kind;
+        registry.chip[i] = (unsigned char)chip_index;
+        strcpy(registry.name[i], entry->d_name); // length checked above
+        char label_name[32];
+        snprintf(label_name, sizeof(label_name), "%s_label", stem);
+        if (!read_attr(chipfd, label_name, registry.label[i], sizeof(registry.label[i]))) {
+            registry.label[i][0] = '\0';
+        }
+    }
+    closedir(dir);
+}
+
+/**
+ * @brief Enumerate all hwmon chips and open their inputs (once).
+ * @details Opens config->hwmon_path once, then every hwmonN entry relative to it. Each chip keeps its directory descriptor for later reopen.
+ * @example
+ *     int n = sensors_init(&config);
+ */
+int sensors_init(const Config *config) {
+    if (registry.initialized) return registry.count;
+    if (!config) return 0;
+    registry.initialized = 1;
+
+    int rootfd = open(config->hwmon_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (rootfd < 0) return 0;
+    int listfd = dup(rootfd);
+    DIR *dir = listfd >= 0 ? fdopendir(listfd) : NULL;
+    if (!dir) {
+        if (listfd >= 0) close(listfd);
+        close(rootfd);
+        return 0;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && registry.chip_count < SENSORS_MAX_CHIPS) {
+        if (entry->d_name[0] == '.') continue; // Skip hidden files/directories
+        int chipfd = openat(rootfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (chipfd < 0) continue;
+        int c = registry.chip_count++;
+        registry.chip_dirfd[c] = chipfd;
+        if (!read_attr(chipfd, "name", registry.chip_name[c], sizeof(registry.chip_name[c]))) {
+            registry.chip_name[c][0] = '\0';
+        }
+        register_chip_inputs(c);
+    }
+    closedir(dir);
+    close(rootfd);
+    return registry.count;
+}
+
+/**
+ * @brief Case-insensitive substring search.
+ * @details Returns 1 if needle occurs in haystack ignoring ASCII case, 0 otherwise.
+ * @example
+ *     contains_nocase("Coolant temp", "coolant");
+ */
+static int contains_nocase(const char *haystack, const char *needle) {
+    size_t nlen = strlen(needle);
+    for (; *haystack; ++haystack) {
+        size_t i = 0;
+        while (i < nlen && haystack[i] &&
+               tolower((unsigned char)haystack[i]) == tolower((unsigned char)needle[i])) i++;
+        if (i == nlen) return 1;
+    }
+    return nlen == 0;
+}
+
+/**
+ * @brief Find a registered sensor by kind and label.
+ * @details Linear scan over the registry; intended for init-time lookups only.
+ * @example
+ *     int idx = sensors_find(SENSOR_KIND_TEMP, "Package id 0");
+ */
+int sensors_find(sensor_kind_t kind, const char *label) {
+    if (!label) return -1;
+    for (int i = 0; i < registry.count; ++i) {
+        if (registry.kind[i] != kind) continue;
+        const char *text = registry.label[i][0] ? registry.label[i] : registry.chip_name[registry.chip[i]];
+        if (contains_nocase(text, label)) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Mark a registered sensor as consumed, so sensors_sample_all() reads it.
+ * @details Appends to the watch list unless the index is already on it.
+ * @example
+ *     sensors_watch(idx);
+ */
+int sensors_watch(int index) {
+    if (index < 0 || index >= registry.count) return 0;
+    for (int i = 0; i < registry.watched_count; ++i) {
+        if (registry.watched[i] == index) return 1;
+    }
+    registry.watched[registry.watched_count++] = index;
+    return 1;
+}
+
+/**
+ * @brief Read a single registered sensor.
+ * @details One pread() in steady state. Only a failed pread() with ENODEV/ESTALE reopens the input via its chip directory descriptor and reads once more; an empty or unparsable value (EIO) is a plain read error.
+ * @example
+ *     long raw;
+ *     sensors_read(idx, &raw);
+ */
+int sensors_read(int index, long *value) {
+    if (index < 0 || index >= registry.count || !value) return 0;
+    if (sensor_pread_long(registry.fd[index], value)) return 1;
+    if (registry.fd[index] >= 0 && !sensor_read_needs_reopen()) return 0;
+    // Device vanished or was never opened: reopen relative to its chip and retry once
+    if (registry.fd[index] >= 0) close(registry.fd[index]);
+    registry.fd[index] = openat(registry.chip_dirfd[registry.chip[index]], registry.name[index], O_RDONLY | O_CLOEXEC);
+    return sensor_pread_long(registry.fd[index], value);
+}
+
+/**
+ * @brief Sample every watched sensor into a snapshot.
+ * @details One pread() per watched sensor and none for the rest. The snapshot timestamp is taken before the reads so staleness is never underestimated.
+ * @example
+ *     sensors_sample_all(&snap);
+ */
+int sensors_sample_all(sensors_snapshot_t *snapshot) {
+    if (!snapshot) return 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    snapshot->timestamp_ns = (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    snapshot->count = registry.count;
+    memset(snapshot->valid, 0, (size_t)registry.count);
+    int ok = 0;
+    for (int w = 0; w < registry.watched_count; ++w) {
+        int i = registry.watched[w];
+        snapshot->valid[i] = (unsigned char)sensors_read(i, &snapshot->value[i]);
+        ok += snapshot->valid[i];
+    }
+    return ok;
+}
+
+/**
+ * @brief Return the number of registered sensors.
+ * @details Zero before sensors_init().
+ * @example
+ *     int n = sensors_count();
+ */
+int sensors_count(void) {
+    return registry.count;
+}
+
+/**
+ * @brief Return the label of a registered sensor.
+ * @details Returns an empty string for unknown indices.
+ * @example
+ *     const char *label = sensors_label(idx);
+ */
+const char *sensors_label(int index) {
+    if (index < 0 || index >= registry.count) return "";
+    return registry.label[index];
+}
+
+/**
+ * @brief Convert a raw temperature value to degrees Celsius.
+ * @details Values above 200 are treated as millidegrees.
+ * @example
+ *     float c = sensors_temp_celsius(45000);
+ */
+float sensors_temp_celsius(long raw) {
+    return raw > 200 ? raw / 1000.0f : (float)raw;
+}
+
+/**
+ * @brief Close all descriptors held by the registry.
+ * @details Resets the registry so that sensors_init() may rescan.
+ * @example
+ *     sensors_cleanup();
+ */
+void sensors_cleanup(void) {
+    for (int i = 0; i < registry.count; ++i) {
+        if (registry.fd[i] >= 0) close(registry.fd[i]);
+    }
+    for (int c = 0; c < registry.chip_count; ++c) {
+        close(registry.chip_dirfd[c]);
+    }
+    memset(&registry, 0, sizeof(registry));
+}
@@ -0,0 +1,397 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Asynchronous LCD upload implementation for CoolerDash.
+ * @details Implements the upload worker thread and the latest-frame-wins mailbox (one slot per LCD device) between renderer and worker.
+ * @example
+ *     See function documentation for usage examples.
+ */
+
+// Enable pthread and clock_gettime()
+#define _POSIX_C_SOURCE 200809L
+
+// Maximum epoll events handled per worker wakeup
+#define UPLOADER_MAX_EVENTS 4
+
+// Time deliveries in flight may still finish after a stop request (ms)
+#define UPLOADER_STOP_GRACE_MS 500
+
+// Include project headers
+#include "../include/uploader.h"
+#include "../include/config.h"
+#include "../include/coolercontrol.h"
+#include "../include/http_engine.h"
+
+// Include necessary headers
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/**
+ * @brief Growable frame buffer.
+ * @details Capacity only grows, so after the first frames the mailbox does not allocate.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} frame_buffer_t;
+
+/**
+ * @brief Mailbox slot of one LCD device.
+ * @details pending is written by the renderer under lock; the worker swaps it with inflight under lock and uploads inflight without holding the lock. uploading and inflight are only touched by the worker.
+ * @example
+ *     // Not intended for direct use; created by uploader_submit().
+ */
+typedef struct {
+    char device_uid[CC_UID_SIZE]; // Target device
+    const Config *config;         // Per-device configuration (owned by the caller)
+    int uploading;                // 1 while the inflight frame is being delivered (worker only)
+    int has_pending;              // 1 if pending holds a frame not yet taken by the worker
+    long long pending_since_ns;   // Submit time of the pending frame
+    frame_buffer_t pending;       // Latest frame from the renderer
+    frame_buffer_t inflight;      // Frame currently being uploaded (worker only)
+} upload_slot_t;
+
+/**
+ * @brief Per-device mailboxes and worker control state.
+ * @details All fields except the slots' inflight/uploading and epfd are protected by lock. pause_lock is taken before lock; holding it keeps the worker away from submitted configurations and the HTTP engine (see uploader_pause()). wake_fd is an eventfd the renderer writes to when a frame is pending or a stop is requested. Each device has its own slot, so a slow device never delays frames of another one.
+ * @example
+ *     // Not intended for direct use; managed by uploader_start()/uploader_stop().
+ */
+static struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_mutex_t pause_lock; // Held by the worker whenever it is not waiting in epoll_wait()
+    int wake_fd;                // eventfd: renderer -> worker wakeups
+    int epfd;                   // Worker epoll: wake_fd + HTTP engine descriptor
+    int running;
+    int stop_requested;
+    long long stop_deadline_ns; // Deliveries still running at this time are abandoned
+    int slot_count;             // Slots in use
+    upload_slot_t slots[CONFIG_MAX_DEVICES];
+} mailbox = { .lock = PTHREAD_MUTEX_INITIALIZER, .pause_lock = PTHREAD_MUTEX_INITIALIZER, .wake_fd = -1, .epfd = -1 };
+
+static uploader_stats_t stats = {0};
+
+/**
+ * @brief Get current CLOCK_MONOTONIC time in nanoseconds.
+ * @details Used for queue wait measurements.
+ * @example
+ *     long long now = monotonic_ns();
+ */
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Wake the worker thread.
+ * @details Adds one to the eventfd counter; the worker drains it.
+ * @example
+ *     wake_worker();
+ */
+static void wake_worker(void) {
+    uint64_t one = 1;
+    if (write(mailbox.wake_fd, &one, sizeof(one)) < 0) {
+        // Counter already non-zero (EAGAIN): the worker is woken anyway
+    }
+}
+
+/**
+ * @brief Delivery completion callback (runs on the worker inside http_engine_run()).
+ * @details Counts the frame as uploaded or failed and frees the device slot so its next pending frame can be sent. Called without the lock held.
+ * @example
+ *     // Not intended for direct use.
+ */
+static void upload_done(int success, void *user) {
+    upload_slot_t *slot = user;
+    pthread_mutex_lock(&mailbox.lock);
+    if (success) stats.uploaded++;
+    else stats.failed++;
+    pthread_mutex_unlock(&mailbox.lock);
+    slot->uploading = 0;
+}
+
+/**
+ * @brief Take the pending frame of a device and start its delivery.
+ * @details Called with the lock held; drops the lock around the submit. A frame whose delivery cannot be started (session not ready, link down, request setup failed) is dropped and counted as not sent; all others are counted by upload_done().
+ * @example
+ *     start_next_upload(slot);
+ */
+static void start_next_upload(upload_slot_t *slot) {
+    frame_buffer_t taken = slot->pending;
+    slot->pending = slot->inflight;
+    slot->inflight = taken;
+    slot->has_pending = 0;
+    long long wait = monotonic_ns() - slot->pending_since_ns;
+    stats.last_wait_ns = wait;
+    if (wait > stats.max_wait_ns) stats.max_wait_ns = wait;
+    stats.total_wait_ns += wait;
+    stats.taken++;
+    pthread_mutex_unlock(&mailbox.lock);
+
+    int started = 0;
+    if (is_session_initialized()) {
+        started = submit_image_data_to_lcd(slot->config, slot->inflight.data, slot->inflight.size,
+                                           slot->device_uid, upload_done, slot);
+    }
+
+    pthread_mutex_lock(&mailbox.lock);
+    if (started) slot->uploading = 1;
+    else stats.not_sent++;
+}
+
+/**
+ * @brief Start the pending frames of all idle devices.
+ * @details Called with the lock held. Returns 1 if any delivery is still in flight afterwards.
+ * @example
+ *     int busy = start_pending_uploads();
+ */
+static int start_pending_uploads(void) {
+    int busy = 0;
+    for (int i = 0; i < mailbox.slot_count; ++i) {
+        upload_slot_t *slot = &mailbox.slots[i];
+        if (!mailbox.stop_requested && slot->has_pending && !slot->uploading) start_next_upload(slot);
+        busy |= slot->uploading;
+    }
+    return busy;
+}
+
+/**
+ * @brief Upload worker main loop.
+ * @details Waits on epoll for a mailbox wakeup or HTTP engine activity. A device's pending frame is started as soon as no delivery to that device is in flight, so per device at most one frame is on the wire and at most one waits, while different devices upload concurrently. On stop, deliveries in flight get UPLOADER_STOP_GRACE_MS to finish and are abandoned afterwards, so stopping never waits for a hung daemon.
+ * @example
+ *     // Not intended for direct use; started by uploader_start().
+ */
+static void *uploader_thread(void *arg) {
+    (void)arg;
+    struct epoll_event events[UPLOADER_MAX_EVENTS];
+    pthread_mutex_lock(&mailbox.pause_lock);
+    pthread_mutex_lock(&mailbox.lock);
+    while (start_pending_uploads() || !mailbox.stop_requested) {
+        int timeout_ms = -1;
+        if (mailbox.stop_requested) {
+            long long remaining_ns = mailbox.stop_deadline_ns - monotonic_ns();
+            if (remaining_ns <= 0) {
+                pthread_mutex_unlock(&mailbox.lock);
+                abort_lcd_deliveries(); // Clears every slot's uploading flag through upload_done()
+                pthread_mutex_lock(&mailbox.lock);
+                continue;
+            }
+            timeout_ms = (int)((remaining_ns + 999999) / 1000000);
+        }
+        pthread_mutex_unlock(&mailbox.lock);
+        pthread_mutex_unlock(&mailbox.pause_lock);
+        int n = epoll_wait(mailbox.epfd, events, UPLOADER_MAX_EVENTS, timeout_ms);
+        pthread_mutex_lock(&mailbox.pause_lock);
+        for (int i = 0; i < n; ++i) {
+            if (events[i].data.fd == mailbox.wake_fd) {
+                uint64_t count;
+                if (read(mailbox.wake_fd, &count, sizeof(count)) < 0) {
+                    // Already drained
+                }
+            } else {
+                http_engine_run(0);
+            }
+        }
+        pthread_mutex_lock(&mailbox.lock);
+    }
+    pthread_mutex_unlock(&mailbox.lock);
+    pthread_mutex_unlock(&mailbox.pause_lock);
+    return NULL;
+}
+
+/**
+ * @brief Register a descriptor for EPOLLIN in the worker epoll set.
+ * @details Returns 1 on success, 0 on failure.
+ * @example
+ *     watch_fd(mailbox.wake_fd);
+ */
+static int watch_fd(int fd) {
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(mailbox.epfd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+/**
+ * @brief Close the worker descriptors.
+ * @details Safe to call with descriptors not yet created.
+ * @example
+ *     close_worker_fds();
+ */
+static void close_worker_fds(void) {
+    if (mailbox.epfd >= 0) close(mailbox.epfd);
+    if (mailbox.wake_fd >= 0) close(mailbox.wake_fd);
+    mailbox.epfd = -1;
+    mailbox.wake_fd = -1;
+}
+
+/**
+ * @brief Start the upload worker thread.
+ * @details The worker takes over the HTTP engine until uploader_stop(). All signals are blocked while the thread is created so it inherits a full mask.
+ * @example
+ *     uploader_start();
+ */
+int uploader_start(void) {
+    if (mailbox.running) return 1;
+    if (http_engine_fd() < 0) return 0;
+    mailbox.stop_requested = 0;
+    mailbox.slot_count = 0;
+    mailbox.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mailbox.epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (mailbox.wake_fd < 0 || mailbox.epfd < 0 || !watch_fd(mailbox.wake_fd) || !watch_fd(http_engine_fd())) {
+        close_worker_fds();
+        return 0;
+    }
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    int rc = pthread_create(&mailbox.thread, NULL, uploader_thread, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (rc != 0) {
+        close_worker_fds();
+        return 0;
+    }
+    mailbox.running = 1;
+    return 1;
+}
+
+/**
+ * @brief Stop and join the upload worker thread.
+ * @details Deliveries in flight get UPLOADER_STOP_GRACE_MS to finish. Hands the HTTP engine back to the calling thread and frees the mailbox buffers of all devices after the worker has exited.
+ * @example
+ *     uploader_stop();
+ */
+void uploader_stop(void) {
+    if (!mailbox.running) return;
+    pthread_mutex_lock(&mailbox.lock);
+    mailbox.stop_requested = 1;
+    mailbox.stop_deadline_ns = monotonic_ns() + UPLOADER_STOP_GRACE_MS * 1000000LL;
+    pthread_mutex_unlock(&mailbox.lock);
+    wake_worker();
+    pthread_join(mailbox.thread, NULL);
+    close_worker_fds();
+    mailbox.running = 0;
+    for (int i = 0; i < mailbox.slot_count; ++i) {
+        free(mailbox.slots[i].pending.data);
+        free(mailbox.slots[i].inflight.data);
+    }
+    memset(mailbox.slots, 0, sizeof(mailbox.slots));
+    mailbox.slot_count = 0;
+}
+
+/**
+ * @brief Return whether the upload worker is running.
+ * @details Only changed by uploader_start()/uploader_stop() on the main thread.
+ * @example
+ *     if (uploader_is_running()) { ... }
+ */
+int uploader_is_running(void) {
+    return mailbox.running;
+}
+
+/**
+ * @brief Hold the upload worker between two event rounds.
+ * @details Waits until the worker is idle in epoll_wait() (it never blocks elsewhere, so this takes microseconds) and keeps it from running until uploader_resume(). Transfers in flight stay open on their sockets meanwhile. While held, the caller may modify the configurations passed to uploader_submit() and the session configuration. No-op if the worker is not running.
+ * @example
+ *     uploader_pause();
+ *     config = fresh;
+ *     uploader_resume();
+ */
+void uploader_pause(void) {
+    if (mailbox.running) pthread_mutex_lock(&mailbox.pause_lock);
+}
+
+/**
+ * @brief Let the upload worker continue after uploader_pause().
+ * @details Must be paired with uploader_pause() on the same thread, with no uploader_start()/uploader_stop() in between.
+ * @example
+ *     uploader_resume();
+ */
+void uploader_resume(void) {
+    if (mailbox.running) pthread_mutex_unlock(&mailbox.pause_lock);
+}
+
+/**
+ * @brief Find or create the mailbox slot of a device.
+ * @details Called with the lock held. Returns NULL if CONFIG_MAX_DEVICES devices already have a slot.
+ * @example
+ *     upload_slot_t *slot = slot_for(uid);
+ */
+static upload_slot_t *slot_for(const char *device_uid) {
+    for (int i = 0; i < mailbox.slot_count; ++i) {
+        if (strcmp(mailbox.slots[i].device_uid, device_uid) == 0) return &mailbox.slots[i];
+    }
+    if (mailbox.slot_count >= CONFIG_MAX_DEVICES) return NULL;
+    upload_slot_t *slot = &mailbox.slots[mailbox.slot_count++];
+    memset(slot, 0, sizeof(*slot));
+    snprintf(slot->device_uid, sizeof(slot->device_uid), "%s", device_uid);
+    return slot;
+}
+
+/**
+ * @brief Hand an encoded frame to the upload worker.
+ * @details The lock is only held for the copy; the worker never holds it during network I/O. The worker is woken through its eventfd.
+ * @example
+ *     uploader_submit(&config, uid, png, png_size);
+ */
+int uploader_submit(const Config *config, const char *device_uid, const unsigned char *data, size_t size) {
+    if (!mailbox.running || !config || !device_uid || !device_uid[0] || !data || size == 0) return 0;
+    pthread_mutex_lock(&mailbox.lock);
+    upload_slot_t *slot = slot_for(device_uid);
+    if (!slot) {
+        pthread_mutex_unlock(&mailbox.lock);
+        return 0;
+    }
+    if (size > slot->pending.capacity) {
+        unsigned char *grown = realloc(slot->pending.data, size);
+        if (!grown) {
+            pthread_mutex_unlock(&mailbox.lock);
+            return 0;
+        }
+        slot->pending.data = grown;
+        slot->pending.capacity = size;
+    }
+    memcpy(slot->pending.data, data, size);
+    slot->pending.size = size;
+    slot->config = config;
+    if (slot->has_pending) stats.superseded++;
+    slot->has_pending = 1;
+    slot->pending_since_ns = monotonic_ns();
+    stats.submitted++;
+    pthread_mutex_unlock(&mailbox.lock);
+    wake_worker();
+    return 1;
+}
+
+/**
+ * @brief Copy the upload worker counters.
+ * @details Taken under the mailbox lock, so the copy is consistent.
+ * @example
+ *     uploader_get_stats(&stats);
+ */
+void uploader_get_stats(uploader_stats_t *out) {
+    if (!out) return;
+    pthread_mutex_lock(&mailbox.lock);
+    *out = stats;
+    pthread_mutex_unlock(&mailbox.lock);
+}
@@ -0,0 +1,119 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Benchmark of /devices discovery on large responses.
+ * @details Measures the streaming JSON parser alone (fed in cURL-sized chunks) and refresh_device_index() end to end against the mock CoolerControl server serving the same generated response with -D. Responses are shaped like coolercontrold's, with a status_history per device.
+ * @example
+ *     make bench
+ */
+
+// Enable mkstemp(), nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/json_stream.h"
+#include "devices_payload.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <string.h>
+
+// status_history entries per generated device
+#define BENCH_HISTORY 60
+
+// Chunk size fed to the parser (cURL's default receive buffer)
+#define BENCH_CHUNK 16384
+
+// Mock port of this benchmark
+#define PORT 18171
+
+// Tokens seen by count_token() (keeps the callback from being optimized away)
+static unsigned long long tokens = 0;
+
+/**
+ * @brief Token callback that only counts.
+ * @details Isolates the lexer cost from the device index.
+ * @example
+ *     json_stream_init(&parser, count_token, NULL);
+ */
+static void count_token(json_event_t event, const char *text, int depth, void *user) {
+    (void)event;
+    (void)text;
+    (void)depth;
+    (void)user;
+    ++tokens;
+}
+
+/**
+ * @brief Benchmark one response size.
+ * @details Writes the response to a temporary file for the mock and keeps a copy in memory for the parser loop.
+ * @example
+ *     bench_devices(1000, 20);
+ */
+static void bench_devices(int devices, int iterations) {
+    char path[] = "/tmp/coolerdash-bench-devices-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    FILE *fp = fdopen(fd, "w+");
+    REQUIRE(fp != NULL);
+    devices_payload_write(fp, devices, BENCH_HISTORY);
+    long size = ftell(fp);
+    char *payload = malloc((size_t)size);
+    REQUIRE(payload != NULL);
+    rewind(fp);
+    REQUIRE(fread(payload, 1, (size_t)size, fp) == (size_t)size);
+    fclose(fp);
+    printf("bench json_stream: %d devices, %.1f MB response\n", devices, size / 1e6);
+
+    int ok = 1;
+    long long start = test_now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        json_stream_t parser;
+        json_stream_init(&parser, count_token, NULL);
+        for (long offset = 0; offset < size; offset += BENCH_CHUNK) {
+            long len = size - offset < BENCH_CHUNK ? size - offset : BENCH_CHUNK;
+            ok &= json_stream_feed(&parser, payload + offset, (size_t)len);
+        }
+        ok &= json_stream_finish(&parser);
+    }
+    long long elapsed = test_now_ns() - start;
+    bench_report("parse (tokens only)", iterations, elapsed);
+    printf("  %-40s %10.1f MB/s\n", "", (double)size * iterations / (elapsed / 1e9) / 1e6);
+
+    pid_t mock = mock_start(PORT, (const char *[]){ "-D", path, NULL });
+    REQUIRE(mock > 0);
+    static Config config;
+    snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 5; // Large responses must fit the request budget
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    start = test_now_ns();
+    for (int i = 0; i < iterations; ++i) ok &= refresh_device_index(&config);
+    bench_report("refresh_device_index (HTTP + index)", iterations, test_now_ns() - start);
+    CHECK(get_device_count() == (size_t)devices);
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+    CHECK(ok);
+    free(payload);
+    unlink(path);
+}
+
+/**
+ * @brief Benchmark entry point.
+ * @details Exit status is 0 if every parse and refresh succeeded.
+ * @example
+ *     ./build/tests/bench_json_stream
+ */
+int main(void) {
+    bench_devices(10, 200);
+    bench_devices(1000, 10);
+    return test_finish("bench_json_stream");
+}
@@ -0,0 +1,85 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Benchmark of one rendered and encoded frame, with heap allocations per frame.
+ * @details Renders changing temperatures with the shipped config.ini (no upload: neither the worker nor a session is running) and reports time, allocations and allocated bytes per frame, measured with the malloc_count.so shim. Every case runs twice, side by side: with the cached background and bar layers, and as a full redraw that invalidates the background key on every frame. Cases are render_display() (draw + PNG encode) and draw_display_frame() (draw only). Needs cairo, so make bench only builds it when pkg-config finds cairo.
+ * @example
+ *     make bench
+ */
+
+// Enable RTLD_DEFAULT and setenv()
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/config.h"
+#include "../include/display.h"
+#include "test.h"
+#include "malloc_count.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Frames rendered before measuring (caches, PNG buffer growth)
+#define BENCH_WARMUP_FRAMES 20
+
+// Frames measured
+#define BENCH_FRAMES 500L
+
+/**
+ * @brief Render BENCH_FRAMES frames and report the cost per frame.
+ * @details Temperatures alternate by more than the change tolerance, so every frame is drawn. With full_redraw the low bit of the bar background color (part of the background key) flips on every frame, so the background and bar layers are rebuilt each time; the color change is invisible. Returns the elapsed time in nanoseconds.
+ * @example
+ *     bench_frames(&config, "render_display", render_display, 0);
+ */
+static long long bench_frames(Config *config, const char *name, int (*render)(const Config *, const sensor_data_t *), int full_redraw) {
+    sensor_data_t data = { 40.0f, 50.0f };
+    int ok = 1;
+    for (int i = 0; i < BENCH_WARMUP_FRAMES; ++i) {
+        data.cpu_temp = (i & 1) ? 45.0f : 65.0f;
+        if (full_redraw) config->color_bg_bar.r ^= 1;
+        ok &= render(config, &data);
+    }
+    unsigned long long bytes_before, bytes_after;
+    unsigned long long before = malloc_count_read(&bytes_before);
+    long long start = test_now_ns();
+    for (long i = 0; i < BENCH_FRAMES; ++i) {
+        data.cpu_temp = (i & 1) ? 45.0f : 65.0f;
+        data.gpu_temp = (i & 2) ? 35.0f : 75.0f;
+        if (full_redraw) config->color_bg_bar.r ^= 1;
+        ok &= render(config, &data);
+    }
+    long long elapsed = test_now_ns() - start;
+    unsigned long long after = malloc_count_read(&bytes_after);
+    bench_report(name, BENCH_FRAMES, elapsed);
+    printf("  %-40s %10.1f allocs/frame %10.0f bytes/frame\n", "", (double)(after - before) / BENCH_FRAMES, (double)(bytes_after - bytes_before) / BENCH_FRAMES);
+    CHECK(ok);
+    return elapsed;
+}
+
+/**
+ * @brief Benchmark entry point.
+ * @details The configuration file can be given as argument (default etc/coolerdash/config.ini).
+ * @example
+ *     ./build/tests/bench_render etc/coolerdash/config.ini
+ */
+int main(int argc, char **argv) {
+    malloc_count_preload(argv);
+    static Config config;
+    REQUIRE(load_config_ini(&config, argc > 1 ? argv[1] : "etc/coolerdash/config.ini") == 0);
+    config.write_image = 0;
+    printf("bench render: %dx%d\n", config.display_width, config.display_height);
+    long long cached = bench_frames(&config, "render + PNG encode, cached background", render_display, 0);
+    long long full = bench_frames(&config, "render + PNG encode, full redraw", render_display, 1);
+    printf("  %-40s %10.1fx\n", "full redraw / cached", (double)full / (double)cached);
+    cached = bench_frames(&config, "draw only, cached background", draw_display_frame, 0);
+    full = bench_frames(&config, "draw only, full redraw", draw_display_frame, 1);
+    printf("  %-40s %10.1fx\n", "full redraw / cached", (double)full / (double)cached);
+    cleanup_display();
+    return test_finish("bench_render");
+}
@@ -0,0 +1,96 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Benchmark of one temperature read: fopen()/fscanf()/fclose() against pread() on a persistent descriptor.
+ * @details Reads the first hwmon temp1_input found under /sys/class/hwmon, or a temporary file with the same content if there is none (containers, CI). Pass a path to benchmark a specific file.
+ * @example
+ *     make bench
+ *     ./build/tests/bench_sensor_reader /sys/class/hwmon/hwmon2/temp1_input
+ */
+
+// Enable pread() and mkstemp()
+#define _POSIX_C_SOURCE 200809L
+
+// Include project headers
+#include "../include/sensor_reader.h"
+#include "test.h"
+
+// Include necessary headers
+#include <fcntl.h>
+#include <glob.h>
+#include <string.h>
+#include <unistd.h>
+
+// Reads per benchmark loop
+#define BENCH_ITERATIONS 200000L
+
+/**
+ * @brief Read one value the way the baseline did.
+ * @details Opens, parses and closes the file on every call.
+ * @example
+ *     read_fscanf(path, &v);
+ */
+static int read_fscanf(const char *path, long *value) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+    int ok = fscanf(fp, "%ld", value) == 1;
+    fclose(fp);
+    return ok;
+}
+
+/**
+ * @brief Run the benchmark on one file.
+ * @details Both loops must read the same value, so the comparison is fair.
+ * @example
+ *     bench_file("/sys/class/hwmon/hwmon0/temp1_input");
+ */
+static void bench_file(const char *path) {
+    printf("bench sensor_reader: %s\n", path);
+    long a = 0, b = 0;
+    int ok = 1;
+    long long start = test_now_ns();
+    for (long i = 0; i < BENCH_ITERATIONS; ++i) ok &= read_fscanf(path, &a);
+    bench_report("fopen/fscanf/fclose", BENCH_ITERATIONS, test_now_ns() - start);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    REQUIRE(fd >= 0);
+    start = test_now_ns();
+    for (long i = 0; i < BENCH_ITERATIONS; ++i) ok &= sensor_pread_long(fd, &b);
+    bench_report("pread (persistent descriptor)", BENCH_ITERATIONS, test_now_ns() - start);
+    close(fd);
+    CHECK(ok);
+    CHECK(a == b);
+}
+
+/**
+ * @brief Benchmark entry point.
+ * @details Exit status is 0 if every read succeeded.
+ * @example
+ *     ./build/tests/bench_sensor_reader
+ */
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        bench_file(argv[1]);
+        return test_finish("bench_sensor_reader");
+    }
+    glob_t found;
+    if (glob("/sys/class/hwmon/hwmon*/temp1_input", 0, NULL, &found) == 0 && found.gl_pathc > 0) {
+        bench_file(found.gl_pathv[0]);
+        globfree(&found);
+        return test_finish("bench_sensor_reader");
+    }
+    char path[] = "/tmp/coolerdash-bench-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    REQUIRE(write(fd, "45000\n", 6) == 6);
+    close(fd);
+    bench_file(path);
+    unlink(path);
+    return test_finish("bench_sensor_reader");
+}
@@ -0,0 +1,128 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Benchmark of the per-upload latency over TCP and over a Unix domain socket.
+ * @details Uploads frames of a typical PNG size to the mock CoolerControl server, one at a time and blocking, and reports the mean, median and 99th percentile per upload. Each transport runs in a fresh copy of this program.
+ * @example
+ *     make bench
+ */
+
+// Enable nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/histogram.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Uploads per transport
+#define BENCH_ITERATIONS 2000L
+
+// Uploads before timing starts (connection setup, first allocations)
+#define BENCH_WARMUP 50L
+
+// Size of the uploaded frame (a 240x240 dashboard PNG is about this large)
+#define FRAME_SIZE (48 * 1024)
+
+// Mock port of the TCP run
+#define PORT 18141
+
+// Socket of the Unix domain socket run
+#define SOCKET_PATH "/tmp/coolerdash-bench-transport.sock"
+
+// Configuration of the session (must outlive it)
+static Config config;
+
+// Fake frame: only the PNG signature is checked by the mock
+static unsigned char frame[FRAME_SIZE] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/**
+ * @brief Time BENCH_ITERATIONS uploads over one transport.
+ * @details unix_socket selects the Unix domain socket.
+ * @example
+ *     bench(1);
+ */
+static void bench(int unix_socket) {
+    pid_t mock = unix_socket ? mock_start_unix(SOCKET_PATH, NULL) : mock_start(PORT, NULL);
+    REQUIRE(mock > 0);
+    if (unix_socket) {
+        snprintf(config.daemon_address, sizeof(config.daemon_address), "http://localhost:11987");
+        snprintf(config.daemon_socket, sizeof(config.daemon_socket), "%s", SOCKET_PATH);
+    } else {
+        snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    }
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 1;
+    config.lcd_brightness = 80;
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(refresh_device_index(&config) == 1);
+
+    int ok = 1;
+    for (long i = 0; i < BENCH_WARMUP; ++i) ok &= send_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1");
+    histogram_t latency_us;
+    memset(&latency_us, 0, sizeof(latency_us));
+    long long start = test_now_ns();
+    for (long i = 0; i < BENCH_ITERATIONS; ++i) {
+        long long begin = test_now_ns();
+        ok &= send_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1");
+        histogram_record(&latency_us, (uint64_t)((test_now_ns() - begin) / 1000));
+    }
+    long long elapsed = test_now_ns() - start;
+    CHECK(ok);
+
+    printf("bench transport: %s, %d byte frames\n", unix_socket ? "Unix domain socket" : "TCP (127.0.0.1)", FRAME_SIZE);
+    bench_report(unix_socket ? "upload over UDS" : "upload over TCP", BENCH_ITERATIONS, elapsed);
+    printf("  %-40s p50 %llu us, p99 %llu us, max %llu us\n", "",
+           (unsigned long long)histogram_percentile(&latency_us, 50.0),
+           (unsigned long long)histogram_percentile(&latency_us, 99.0),
+           (unsigned long long)latency_us.max);
+
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+}
+
+/**
+ * @brief Run one transport in a fresh process.
+ * @details Returns 1 if the run succeeded.
+ * @example
+ *     run_bench("tcp");
+ */
+static int run_bench(const char *name) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/proc/self/exe", "bench_transport", name, (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return 0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Benchmark entry point.
+ * @details Without arguments both transports are measured; with "tcp" or "unix" only that one.
+ * @example
+ *     ./build/tests/bench_transport
+ */
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "tcp") == 0) bench(0);
+        else if (strcmp(argv[1], "unix") == 0) bench(1);
+        else CHECK(!"unknown transport");
+        return test_finish(argv[1]);
+    }
+    CHECK(run_bench("tcp"));
+    CHECK(run_bench("unix"));
+    return test_finish("bench_transport");
+}
@@ -0,0 +1,97 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Generator of large /devices responses for tests and benchmarks.
+ * @details Writes a response shaped like coolercontrold's: every device has info.channels (LCD devices with lcd_info) and a status_history array, which is what makes real responses large. Device 0 is an oversized "odd" device: its history alone is far above the 4096 bytes the old parser could hold, its name needs unescaping, its uid exceeds CC_UID_SIZE and nested objects contain decoy uid/name keys. Every third device after it has an LCD.
+ * @example
+ *     FILE *fp = fopen(path, "w");
+ *     devices_payload_write(fp, 500, 20);
+ */
+
+// Function prototypes
+#ifndef DEVICES_PAYLOAD_H
+#define DEVICES_PAYLOAD_H
+
+// Include necessary headers
+#include <stdio.h>
+
+// status_history entries of the odd device 0
+#define DEVICES_PAYLOAD_ODD_HISTORY 2000
+
+// Name of device 0 as it appears in the response (JSON-escaped)
+#define DEVICES_PAYLOAD_ODD_NAME_JSON "NZXT \\\"Kraken\\\" \\u00e9\\ud83d\\ude00\\/2"
+
+// Name of device 0 after unescaping
+#define DEVICES_PAYLOAD_ODD_NAME "NZXT \"Kraken\" \xc3\xa9\xf0\x9f\x98\x80/2"
+
+/**
+ * @brief Return whether generated device i (i >= 1) has an LCD.
+ * @details Device 0 always has one.
+ * @example
+ *     if (devices_payload_has_lcd(i)) { ... }
+ */
+static inline int devices_payload_has_lcd(int i) {
+    return i == 0 || i % 3 == 0;
+}
+
+/**
+ * @brief Write status_history entries of one device.
+ * @details Each entry carries a timestamp, a temperature and the duty/rpm of a fan channel.
+ * @example
+ *     devices_payload_history(fp, 20);
+ */
+static inline void devices_payload_history(FILE *fp, int entries) {
+    fprintf(fp, "\"status_history\":[");
+    for (int h = 0; h < entries; ++h) {
+        fprintf(fp, "%s{\"timestamp\":\"2025-01-01T12:%02d:%02d.000+01:00\",\"temps\":[{\"name\":\"liquid\",\"temp\":%d.%d}],"
+                "\"channels\":[{\"name\":\"fan1\",\"rpm\":%d,\"duty\":%d.5,\"pwm_mode\":null}]}",
+                h ? "," : "", (h / 60) % 60, h % 60, 30 + h % 7, h % 10, 900 + h % 300, 30 + h % 50);
+    }
+    fprintf(fp, "]");
+}
+
+/**
+ * @brief Write a /devices response with count devices.
+ * @details history is the number of status_history entries per device (device 0 always gets DEVICES_PAYLOAD_ODD_HISTORY). Device i >= 1 is named "Device <i>" with uid "uid-<i>"; LCD devices report channel "lcd" with a (200 + i % 200) square screen.
+ * @example
+ *     devices_payload_write(fp, 500, 20);
+ */
+static inline void devices_payload_write(FILE *fp, int count, int history) {
+    fprintf(fp, "{\"devices\":[");
+    for (int i = 0; i < count; ++i) {
+        if (i) fputc(',', fp);
+        if (i == 0) {
+            fprintf(fp, "{\"type\":\"Liquidctl\",\"uid\":\"odd-");
+            for (int k = 0; k < 200; ++k) fputc('a' + k % 26, fp);
+            fprintf(fp, "\",\"type_index\":1,\"name\":\"" DEVICES_PAYLOAD_ODD_NAME_JSON "\","
+                    "\"lc_info\":{\"driver_type\":\"KrakenZ3\",\"firmware_version\":\"1.2\",\"uid\":\"decoy\",\"name\":\"decoy\"},"
+                    "\"info\":{\"channels\":{\"fan1\":{\"speed_options\":{\"min_duty\":20,\"max_duty\":100},\"lcd_info\":null},"
+                    "\"pump\":{\"speed_options\":{\"min_duty\":60,\"max_duty\":100}},"
+                    "\"lcd\":{\"lcd_info\":{\"screen_width\":320,\"screen_height\":320,\"max_image_size_bytes\":24320,\"name\":\"decoy\"},"
+                    "\"lcd_modes\":[{\"name\":\"image\",\"frontend_name\":\"Image/gif\",\"brightness\":true,\"orientation\":true}]}},"
+                    "\"temps\":{\"liquid\":{\"label\":\"Liquid\",\"number\":1}}},");
+            devices_payload_history(fp, DEVICES_PAYLOAD_ODD_HISTORY);
+            fputc('}', fp);
+            continue;
+        }
+        fprintf(fp, "{\"uid\":\"uid-%d\",\"type\":\"%s\",\"type_index\":%d,\"name\":\"Device %d\",\"info\":{\"channels\":{"
+                "\"fan1\":{\"speed_options\":{\"min_duty\":0,\"max_duty\":100,\"fixed_enabled\":true},\"lcd_info\":null}",
+                i, i % 2 ? "Hwmon" : "Liquidctl", i, i);
+        if (devices_payload_has_lcd(i)) {
+            int size = 200 + i % 200;
+            fprintf(fp, ",\"lcd\":{\"lcd_info\":{\"screen_width\":%d,\"screen_height\":%d,\"max_image_size_bytes\":%d}}", size, size, 1000 * i);
+        }
+        fprintf(fp, "},\"temps\":{}},");
+        devices_payload_history(fp, history);
+        fputc('}', fp);
+    }
+    fprintf(fp, "]}");
+}
+
+#endif // DEVICES_PAYLOAD_H
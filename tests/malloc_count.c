@@ -0,0 +1,155 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Allocation-counting LD_PRELOAD shim for the tests and benchmarks.
+ * @details Built as build/tests/malloc_count.so. Wraps the glibc allocator entry points, forwards to the __libc_* implementations (no dlsym() bootstrap problem) and counts every allocation process-wide, including those made inside cairo, libpng, zlib and libcurl. Read the counters with malloc_count_read() from malloc_count.h.
+ * @example
+ *     LD_PRELOAD=build/tests/malloc_count.so ./build/tests/bench_render
+ */
+
+// Include necessary headers
+#include <errno.h>
+#include <stddef.h>
+
+// glibc allocator implementations behind the public names
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+// Allocations (malloc, calloc, realloc, aligned variants) since process start
+static unsigned long long allocations = 0;
+
+// Bytes requested by those allocations
+static unsigned long long allocated_bytes = 0;
+
+// Calls of free() with a non-NULL pointer
+static unsigned long long frees = 0;
+
+// Largest single allocation since the last malloc_count_take_largest()
+static unsigned long long largest = 0;
+
+/**
+ * @brief Count one allocation of size bytes.
+ * @details Relaxed atomics; the counters are only read between measured sections.
+ * @example
+ *     count_allocation(size);
+ */
+static void count_allocation(size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocated_bytes, size, __ATOMIC_RELAXED);
+    unsigned long long seen = __atomic_load_n(&largest, __ATOMIC_RELAXED);
+    while (size > seen && !__atomic_compare_exchange_n(&largest, &seen, size, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief Read the counters.
+ * @details Exported for malloc_count_read(); any pointer may be NULL.
+ * @example
+ *     malloc_count_get(&count, &bytes, &frees);
+ */
+void malloc_count_get(unsigned long long *count, unsigned long long *bytes, unsigned long long *freed) {
+    if (count) *count = __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+    if (bytes) *bytes = __atomic_load_n(&allocated_bytes, __ATOMIC_RELAXED);
+    if (freed) *freed = __atomic_load_n(&frees, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Return the largest single allocation since the previous call and start over.
+ * @details Exported for malloc_count_take_largest(); tells a re-created surface apart from small per-frame allocations.
+ * @example
+ *     unsigned long long size = malloc_count_largest();
+ */
+unsigned long long malloc_count_largest(void) {
+    return __atomic_exchange_n(&largest, 0, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Counting malloc().
+ * @details Forwards to __libc_malloc().
+ * @example
+ *     void *p = malloc(64);
+ */
+void *malloc(size_t size) {
+    count_allocation(size);
+    return __libc_malloc(size);
+}
+
+/**
+ * @brief Counting calloc().
+ * @details Forwards to __libc_calloc().
+ * @example
+ *     void *p = calloc(4, 16);
+ */
+void *calloc(size_t count, size_t size) {
+    count_allocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+/**
+ * @brief Counting realloc().
+ * @details Every call that may allocate is counted, including growth in place.
+ * @example
+ *     p = realloc(p, 128);
+ */
+void *realloc(void *ptr, size_t size) {
+    if (size) count_allocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+/**
+ * @brief Counting memalign().
+ * @details Forwards to __libc_memalign().
+ * @example
+ *     void *p = memalign(64, 4096);
+ */
+void *memalign(size_t alignment, size_t size) {
+    count_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+/**
+ * @brief Counting aligned_alloc().
+ * @details Forwards to __libc_memalign().
+ * @example
+ *     void *p = aligned_alloc(64, 4096);
+ */
+void *aligned_alloc(size_t alignment, size_t size) {
+    count_allocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+/**
+ * @brief Counting posix_memalign().
+ * @details Returns EINVAL for an alignment that is not a power of two multiple of sizeof(void *), ENOMEM on failure.
+ * @example
+ *     void *p;
+ *     posix_memalign(&p, 64, 4096);
+ */
+int posix_memalign(void **memptr, size_t alignment, size_t size) {
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    count_allocation(size);
+    void *ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *memptr = ptr;
+    return 0;
+}
+
+/**
+ * @brief Counting free().
+ * @details Forwards to __libc_free().
+ * @example
+ *     free(p);
+ */
+void free(void *ptr) {
+    if (ptr) __atomic_fetch_add(&frees, 1, __ATOMIC_RELAXED);
+    __libc_free(ptr);
+}
@@ -0,0 +1,83 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Access to the allocation-counting shim from tests and benchmarks.
+ * @details malloc_count_preload() re-executes the program with build/tests/malloc_count.so preloaded if it is not loaded yet; malloc_count_read() returns the counters. Include after test.h; needs _GNU_SOURCE for RTLD_DEFAULT and -ldl.
+ * @example
+ *     malloc_count_preload(argv);
+ *     unsigned long long before = malloc_count_read(NULL);
+ */
+
+// Function prototypes
+#ifndef MALLOC_COUNT_H
+#define MALLOC_COUNT_H
+
+// Include necessary headers
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @brief Read the allocation counter of the shim.
+ * @details Returns the number of allocations since process start and stores the requested bytes in bytes (may be NULL). Returns 0 if the shim is not loaded.
+ * @example
+ *     unsigned long long bytes;
+ *     unsigned long long count = malloc_count_read(&bytes);
+ */
+static inline unsigned long long malloc_count_read(unsigned long long *bytes) {
+    void (*get)(unsigned long long *, unsigned long long *, unsigned long long *) =
+        (void (*)(unsigned long long *, unsigned long long *, unsigned long long *))dlsym(RTLD_DEFAULT, "malloc_count_get");
+    unsigned long long count = 0;
+    if (bytes) *bytes = 0;
+    if (get) get(&count, bytes, NULL);
+    return count;
+}
+
+/**
+ * @brief Return the largest single allocation since the previous call and start over.
+ * @details Returns 0 if the shim is not loaded.
+ * @example
+ *     malloc_count_take_largest();
+ *     render_display(&config, &data);
+ *     unsigned long long largest = malloc_count_take_largest();
+ */
+static inline unsigned long long malloc_count_take_largest(void) {
+    unsigned long long (*take)(void) = (unsigned long long (*)(void))dlsym(RTLD_DEFAULT, "malloc_count_largest");
+    return take ? take() : 0;
+}
+
+/**
+ * @brief Make sure the shim is loaded, re-executing the program with LD_PRELOAD if needed.
+ * @details The shim is taken from COOLERDASH_TEST_BIN (default build/tests). Returns only if the shim is loaded; exits the program if it cannot be.
+ * @example
+ *     int main(int argc, char **argv) { malloc_count_preload(argv); ... }
+ */
+static inline void malloc_count_preload(char **argv) {
+    if (dlsym(RTLD_DEFAULT, "malloc_count_get")) return;
+    if (getenv("MALLOC_COUNT_PRELOADED")) {
+        fprintf(stderr, "  malloc_count.so could not be preloaded\n");
+        exit(EXIT_FAILURE);
+    }
+    const char *bin = getenv("COOLERDASH_TEST_BIN");
+    char shim[512];
+    snprintf(shim, sizeof(shim), "%s/malloc_count.so", bin ? bin : "build/tests");
+    char *path = realpath(shim, NULL);
+    if (!path) {
+        fprintf(stderr, "  %s not found (make test builds it)\n", shim);
+        exit(EXIT_FAILURE);
+    }
+    setenv("LD_PRELOAD", path, 1);
+    setenv("MALLOC_COUNT_PRELOADED", "1", 1);
+    execv("/proc/self/exe", argv);
+    perror("execv");
+    exit(EXIT_FAILURE);
+}
+
+#endif // MALLOC_COUNT_H
@@ -0,0 +1,151 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Start and stop the mock CoolerControl server from a test.
+ * @details Header-only companion of test.h. The server binary is taken from COOLERDASH_MOCK (set by make test); it is started on a test-specific port or Unix domain socket and stopped with SIGINT.
+ * @example
+ *     pid_t mock = mock_start(18101, (const char *[]){ "-n", "2", NULL });
+ *     ...
+ *     mock_stop(mock);
+ */
+
+// Function prototypes
+#ifndef MOCK_SERVER_H
+#define MOCK_SERVER_H
+
+// Include necessary headers
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Maximum number of extra arguments passed to the mock
+#define MOCK_MAX_ARGS 16
+
+// How long mock_start() waits for the server to accept connections
+#define MOCK_START_TIMEOUT_MS 3000
+
+/**
+ * @brief Return whether something accepts TCP connections on 127.0.0.1:port.
+ * @details Returns 1 if a connect() succeeded, 0 otherwise.
+ * @example
+ *     if (mock_listening(18101)) { ... }
+ */
+static inline int mock_listening(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return 0;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int ok = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return ok;
+}
+
+/**
+ * @brief Return whether something accepts connections on a Unix domain socket.
+ * @details Returns 1 if a connect() succeeded, 0 otherwise.
+ * @example
+ *     if (mock_listening_unix("/tmp/mock.sock")) { ... }
+ */
+static inline int mock_listening_unix(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return 0;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    int ok = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    close(fd);
+    return ok;
+}
+
+/**
+ * @brief Start the mock server on a port or, if path is not NULL, on a Unix domain socket.
+ * @details args is a NULL-terminated list of extra options (may be NULL). Waits until the server accepts connections. Returns the PID of the server, or -1 if COOLERDASH_MOCK is not set or the server did not come up within MOCK_START_TIMEOUT_MS.
+ * @example
+ *     pid_t mock = mock_launch(0, "/tmp/mock.sock", NULL);
+ */
+static inline pid_t mock_launch(int port, const char *path, const char *const *args) {
+    const char *binary = getenv("COOLERDASH_MOCK");
+    if (!binary) {
+        fprintf(stderr, "  COOLERDASH_MOCK not set; run through make test\n");
+        return -1;
+    }
+    char port_text[16];
+    snprintf(port_text, sizeof(port_text), "%d", port);
+    const char *argv[MOCK_MAX_ARGS + 4] = { binary, path ? "-u" : "-p", path ? path : port_text };
+    int argc = 3;
+    for (int i = 0; args && args[i] && i < MOCK_MAX_ARGS; ++i) argv[argc++] = args[i];
+    argv[argc] = NULL;
+    fflush(NULL); // Buffered output would otherwise be written twice
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        // The request statistics printed on exit would clutter the test output
+        if (!freopen("/dev/null", "w", stdout)) _exit(127);
+        execv(binary, (char *const *)argv);
+        _exit(127);
+    }
+    for (int waited = 0; waited < MOCK_START_TIMEOUT_MS; waited += 10) {
+        if (path ? mock_listening_unix(path) : mock_listening(port)) return pid;
+        if (waitpid(pid, NULL, WNOHANG) == pid) return -1;
+        struct timespec ts = { 0, 10000000L };
+        nanosleep(&ts, NULL);
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    return -1;
+}
+
+/**
+ * @brief Start the mock server on a port.
+ * @details See mock_launch().
+ * @example
+ *     pid_t mock = mock_start(18101, NULL);
+ */
+static inline pid_t mock_start(int port, const char *const *args) {
+    return mock_launch(port, NULL, args);
+}
+
+/**
+ * @brief Start the mock server on a Unix domain socket.
+ * @details See mock_launch().
+ * @example
+ *     pid_t mock = mock_start_unix("/tmp/mock.sock", NULL);
+ */
+static inline pid_t mock_start_unix(const char *path, const char *const *args) {
+    return mock_launch(0, path, args);
+}
+
+/**
+ * @brief Stop a mock server started by mock_start().
+ * @details Sends SIGINT and reaps the process. Returns 1 if it exited normally, 0 otherwise.
+ * @example
+ *     CHECK(mock_stop(mock));
+ */
+static inline int mock_stop(pid_t pid) {
+    int status = 0;
+    if (pid <= 0) return 0;
+    kill(pid, SIGINT);
+    if (waitpid(pid, &status, 0) != pid) return 0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#endif // MOCK_SERVER_H
@@ -0,0 +1,112 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Stub NVML library for testing the NVML GPU backend without a GPU.
+ * @details Built as build/tests/libnvidia-ml.so.1 and found by dlopen() through LD_LIBRARY_PATH. Exports the entry points gpu_monitor.c resolves. STUB_NVML_COUNT sets the number of GPUs (default 1) and STUB_NVML_TEMP the temperature (default 50). The call counters can be read through dlopen(..., RTLD_NOLOAD) and dlsym().
+ * @example
+ *     LD_LIBRARY_PATH=build/tests ./build/tests/test_gpu_monitor
+ */
+
+// Include necessary headers
+#include <stdlib.h>
+
+// NVML return codes used by the stub (values match nvml.h)
+#define NVML_SUCCESS 0
+#define NVML_ERROR_UNINITIALIZED 1
+#define NVML_ERROR_INVALID_ARGUMENT 2
+
+// Device handle given out for GPU 0
+static int stub_device;
+
+// Whether nvmlInit_v2() was called without a matching nvmlShutdown()
+static int stub_initialized;
+
+// Number of calls per entry point, read by the tests
+int stub_nvml_init_calls = 0;
+int stub_nvml_shutdown_calls = 0;
+int stub_nvml_temperature_calls = 0;
+
+/**
+ * @brief Read an integer setting of the stub from the environment.
+ * @details Returns fallback if the variable is not set.
+ * @example
+ *     int count = stub_env("STUB_NVML_COUNT", 1);
+ */
+static int stub_env(const char *name, int fallback) {
+    const char *value = getenv(name);
+    return value ? atoi(value) : fallback;
+}
+
+/**
+ * @brief Stub of nvmlInit_v2().
+ * @details Always succeeds.
+ * @example
+ *     nvmlInit_v2();
+ */
+int nvmlInit_v2(void) {
+    ++stub_nvml_init_calls;
+    stub_initialized = 1;
+    return NVML_SUCCESS;
+}
+
+/**
+ * @brief Stub of nvmlShutdown().
+ * @details Fails if NVML is not initialized, like the real library.
+ * @example
+ *     nvmlShutdown();
+ */
+int nvmlShutdown(void) {
+    ++stub_nvml_shutdown_calls;
+    if (!stub_initialized) return NVML_ERROR_UNINITIALIZED;
+    stub_initialized = 0;
+    return NVML_SUCCESS;
+}
+
+/**
+ * @brief Stub of nvmlDeviceGetCount_v2().
+ * @details Reports STUB_NVML_COUNT GPUs.
+ * @example
+ *     unsigned int count;
+ *     nvmlDeviceGetCount_v2(&count);
+ */
+int nvmlDeviceGetCount_v2(unsigned int *count) {
+    if (!stub_initialized) return NVML_ERROR_UNINITIALIZED;
+    *count = (unsigned int)stub_env("STUB_NVML_COUNT", 1);
+    return NVML_SUCCESS;
+}
+
+/**
+ * @brief Stub of nvmlDeviceGetHandleByIndex_v2().
+ * @details Returns the same handle for every valid index.
+ * @example
+ *     void *device;
+ *     nvmlDeviceGetHandleByIndex_v2(0, &device);
+ */
+int nvmlDeviceGetHandleByIndex_v2(unsigned int index, void **device) {
+    if (!stub_initialized) return NVML_ERROR_UNINITIALIZED;
+    if (index >= (unsigned int)stub_env("STUB_NVML_COUNT", 1)) return NVML_ERROR_INVALID_ARGUMENT;
+    *device = &stub_device;
+    return NVML_SUCCESS;
+}
+
+/**
+ * @brief Stub of nvmlDeviceGetTemperature().
+ * @details Reports STUB_NVML_TEMP degrees Celsius.
+ * @example
+ *     unsigned int temp;
+ *     nvmlDeviceGetTemperature(device, 0, &temp);
+ */
+int nvmlDeviceGetTemperature(void *device, int sensor, unsigned int *temp) {
+    (void)sensor;
+    ++stub_nvml_temperature_calls;
+    if (!stub_initialized) return NVML_ERROR_UNINITIALIZED;
+    if (device != &stub_device) return NVML_ERROR_INVALID_ARGUMENT;
+    *temp = (unsigned int)stub_env("STUB_NVML_TEMP", 50);
+    return NVML_SUCCESS;
+}
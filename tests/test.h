@@ -0,0 +1,89 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Minimal test and benchmark helpers for CoolerDash.
+ * @details Header-only; every test program includes it once. A failed CHECK() prints the location and marks the program as failed, test_finish() returns the exit status for main().
+ * @example
+ *     CHECK(sensor_parse_long("42", 2, &v) == 1);
+ *     return test_finish("sensor_reader");
+ */
+
+// Function prototypes
+#ifndef TEST_H
+#define TEST_H
+
+// Include necessary headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Nanoseconds per second
+#define TEST_NSEC_PER_SEC 1000000000LL
+
+// Number of failed checks of this program
+static int test_failures = 0;
+
+// Number of checks of this program
+static int test_checks = 0;
+
+// Check a condition; on failure print it with its location and keep going
+#define CHECK(condition) \
+    do { \
+        ++test_checks; \
+        if (!(condition)) { \
+            ++test_failures; \
+            fprintf(stderr, "  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while (0)
+
+// Check a condition and stop the program if it does not hold (setup steps)
+#define REQUIRE(condition) \
+    do { \
+        ++test_checks; \
+        if (!(condition)) { \
+            ++test_failures; \
+            fprintf(stderr, "  FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            exit(test_finish(__FILE__)); \
+        } \
+    } while (0)
+
+/**
+ * @brief Print the result line of a test program.
+ * @details Returns EXIT_SUCCESS if no check failed, EXIT_FAILURE otherwise.
+ * @example
+ *     return test_finish("sensor_reader");
+ */
+static inline int test_finish(const char *name) {
+    printf("%s %s (%d checks, %d failed)\n", test_failures ? "FAIL" : "ok  ", name, test_checks, test_failures);
+    return test_failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * @brief Current CLOCK_MONOTONIC time in nanoseconds.
+ * @details Used to time benchmark loops.
+ * @example
+ *     long long start = test_now_ns();
+ */
+static inline long long test_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * TEST_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * @brief Print one benchmark result line.
+ * @details Reports the mean time per iteration of a timed loop.
+ * @example
+ *     bench_report("pread", iterations, test_now_ns() - start);
+ */
+static inline void bench_report(const char *name, long iterations, long long elapsed_ns) {
+    printf("  %-40s %10.1f ns/op (%ld ops)\n", name, (double)elapsed_ns / (double)iterations, iterations);
+}
+
+#endif // TEST_H
@@ -0,0 +1,293 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of LCD image delivery when the daemon is unreachable.
+ * @details A listener whose accept queue is full drops every SYN, so connection attempts to it time out. A delivery that runs into such a connect timeout must be retried within its deadline and succeed once the mock CoolerControl server is back, instead of being abandoned as missed. The circuit breaker must open after repeated failed deliveries while the mock is down, probe /health with backoff and close again once the mock is back up. Request timeouts must follow a changed refresh interval.
+ * @example
+ *     make test
+ */
+
+// Enable nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/http_engine.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <pthread.h>
+#include <string.h>
+
+// Mock port of this test
+#define PORT 18191
+
+// Connections that fill the accept queue of the blocked listener
+#define FILLERS 2
+
+// When the mock replaces the blocked listener, after the upload started
+#define RECOVER_AFTER_MS 1300
+
+// Consecutive failed deliveries that open the breaker (CC_BREAKER_THRESHOLD)
+#define BREAKER_THRESHOLD 3
+
+// How long the mock stays down once the breaker is open
+#define OUTAGE_MS 1500
+
+// Shortened refresh interval of test_timeout_update(), below the 1 s connect timeout
+#define SHORT_INTERVAL_MS 500
+
+// Configuration of the session (must outlive it)
+static Config config;
+
+// Fake frame: only the PNG signature is checked by the mock
+static const unsigned char frame[64] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/**
+ * @brief A listener on PORT that never accepts.
+ * @details listen() with a backlog of 0 plus FILLERS connections leave the accept queue full; further SYNs are dropped.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int listener;         // Listening socket
+    int fillers[FILLERS]; // Connections occupying the accept queue
+    pid_t mock;           // Mock started by recover() (-1 = none)
+} blocked_port_t;
+
+/**
+ * @brief Sleep for a number of milliseconds.
+ * @details Used to time the recovery of the daemon.
+ * @example
+ *     sleep_ms(RECOVER_AFTER_MS);
+ */
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Occupy PORT with a listener that lets connections time out.
+ * @details Returns 1 on success.
+ * @example
+ *     REQUIRE(block_port(&blocked));
+ */
+static int block_port(blocked_port_t *blocked) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int one = 1;
+    blocked->mock = -1;
+    blocked->listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (blocked->listener < 0) return 0;
+    setsockopt(blocked->listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(blocked->listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(blocked->listener, 0) != 0) return 0;
+    for (int i = 0; i < FILLERS; ++i) {
+        blocked->fillers[i] = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (blocked->fillers[i] < 0) return 0;
+        connect(blocked->fillers[i], (struct sockaddr *)&addr, sizeof(addr)); // In progress or queued
+    }
+    sleep_ms(50); // Let the handshakes settle
+    return 1;
+}
+
+/**
+ * @brief Release PORT from block_port().
+ * @details Closes the fillers and the listener.
+ * @example
+ *     unblock_port(&blocked);
+ */
+static void unblock_port(blocked_port_t *blocked) {
+    for (int i = 0; i < FILLERS; ++i) close(blocked->fillers[i]);
+    close(blocked->listener);
+}
+
+/**
+ * @brief Thread that brings the daemon back after RECOVER_AFTER_MS.
+ * @details Closes the blocked listener and starts the mock on PORT; arg is the blocked_port_t.
+ * @example
+ *     pthread_create(&thread, NULL, recover, &blocked);
+ */
+static void *recover(void *arg) {
+    blocked_port_t *blocked = arg;
+    sleep_ms(RECOVER_AFTER_MS);
+    unblock_port(blocked);
+    blocked->mock = mock_start(PORT, NULL);
+    return NULL;
+}
+
+/**
+ * @brief Delivery completion callback.
+ * @details Stores the result in the int pointed to by user.
+ * @example
+ *     submit_image_data_to_lcd(&config, frame, sizeof(frame), uid, delivery_done, &result);
+ */
+static void delivery_done(int success, void *user) {
+    *(int *)user = success;
+}
+
+/**
+ * @brief An upload that runs into a connect timeout is retried and delivered.
+ * @details The deadline (refresh interval) is 3 s and the connect timeout 1 s, so after the first attempt times out there is time for the retries that reach the recovered mock. Returns the restarted mock.
+ * @example
+ *     mock = test_connect_timeout(mock);
+ */
+static pid_t test_connect_timeout(pid_t mock) {
+    CHECK(mock_stop(mock)); // The session's connection is closed with it
+    blocked_port_t blocked;
+    REQUIRE(block_port(&blocked));
+    lcd_delivery_stats_t before, after;
+    get_lcd_delivery_stats(&before);
+
+    pthread_t thread;
+    REQUIRE(pthread_create(&thread, NULL, recover, &blocked) == 0);
+    int result = -1;
+    long long start = test_now_ns();
+    CHECK(submit_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1", delivery_done, &result) == 1);
+    CHECK(wait_lcd_deliveries(5000) == 1);
+    long long elapsed_ms = (test_now_ns() - start) / 1000000LL;
+    pthread_join(thread, NULL);
+    get_lcd_delivery_stats(&after);
+
+    CHECK(blocked.mock > 0);
+    CHECK(result == 1);
+    CHECK(after.missed == before.missed);
+    CHECK(after.retries > before.retries);
+    CHECK(elapsed_ms >= RECOVER_AFTER_MS && elapsed_ms < 3000);
+    printf("  delivered after %lld ms, %llu retries\n", elapsed_ms, after.retries - before.retries);
+    return blocked.mock;
+}
+
+/**
+ * @brief Drive the health probes until the link reaches a state.
+ * @details Calls service_lcd_link() like the render loop does without an upload worker. Returns 1 if the state was reached within timeout_ms.
+ * @example
+ *     CHECK(wait_link_state(CC_LINK_UP, 6000));
+ */
+static int wait_link_state(cc_link_state_t state, long timeout_ms) {
+    cc_link_stats_t link;
+    for (long waited = 0; waited < timeout_ms; waited += 10) {
+        get_lcd_link_stats(&link);
+        if (link.state == state) return 1;
+        service_lcd_link();
+        sleep_ms(10);
+    }
+    get_lcd_link_stats(&link);
+    return link.state == state;
+}
+
+/**
+ * @brief The circuit breaker opens while the mock is down and closes when it is back.
+ * @details BREAKER_THRESHOLD deliveries fail against the stopped mock and open the breaker; frames are then refused and skipped. Probes fail during the outage; after the mock restarts a probe succeeds, the client logs in again, rediscovers the devices and uploads resume. Returns the restarted mock.
+ * @example
+ *     mock = test_breaker(mock);
+ */
+static pid_t test_breaker(pid_t mock) {
+    cc_link_stats_t before, link;
+    http_engine_stats_t engine_before, engine_after;
+    get_lcd_link_stats(&before);
+    http_engine_get_stats(&engine_before);
+    REQUIRE(before.state == CC_LINK_UP);
+    CHECK(mock_stop(mock));
+
+    for (int i = 0; i < BREAKER_THRESHOLD; ++i) {
+        int result = -1;
+        CHECK(submit_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1", delivery_done, &result) == 1);
+        CHECK(wait_lcd_deliveries(5000) == 1);
+        CHECK(result == 0);
+    }
+    get_lcd_link_stats(&link);
+    CHECK(link.state == CC_LINK_DOWN);
+    CHECK(link.outages == before.outages + 1);
+    CHECK(lcd_link_allows_frame() == 0);
+    int refused = -1;
+    CHECK(submit_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1", delivery_done, &refused) == 0);
+
+    long long down_ns = test_now_ns();
+    CHECK(!wait_link_state(CC_LINK_UP, OUTAGE_MS));
+    get_lcd_link_stats(&link);
+    CHECK(link.probes > before.probes && link.probe_failures == link.probes - before.probes + before.probe_failures);
+
+    mock = mock_start(PORT, NULL);
+    REQUIRE(mock > 0);
+    CHECK(wait_link_state(CC_LINK_UP, 6000));
+    long long outage_ms = (test_now_ns() - down_ns) / 1000000LL;
+    get_lcd_link_stats(&link);
+    CHECK(link.recoveries == before.recoveries + 1);
+    CHECK(link.frames_skipped > before.frames_skipped);
+    CHECK(lcd_link_allows_frame() == 1);
+
+    int result = -1;
+    CHECK(submit_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1", delivery_done, &result) == 1);
+    CHECK(wait_lcd_deliveries(2000) == 1);
+    CHECK(result == 1);
+    http_engine_get_stats(&engine_after);
+    CHECK(engine_after.requests > engine_before.requests);
+    printf("  breaker closed %lld ms after opening, %llu probes (%llu failed)\n",
+           outage_ms, link.probes - before.probes, link.probe_failures - before.probe_failures);
+    return mock;
+}
+
+/**
+ * @brief Request timeouts follow a changed refresh interval.
+ * @details With a 3 s interval a connection attempt to the blocked port gives up after the 1 s connect timeout. After the interval drops to SHORT_INTERVAL_MS and update_coolercontrol_timeouts() runs, the same request must give up within that interval. Returns the restarted mock.
+ * @example
+ *     mock = test_timeout_update(mock);
+ */
+static pid_t test_timeout_update(pid_t mock) {
+    CHECK(mock_stop(mock));
+    blocked_port_t blocked;
+    REQUIRE(block_port(&blocked));
+    config.display_refresh_interval_sec = 0;
+    config.display_refresh_interval_nsec = SHORT_INTERVAL_MS * 1000000L;
+    update_coolercontrol_timeouts(&config);
+
+    long long start = test_now_ns();
+    CHECK(refresh_device_index(&config) == 0);
+    long long elapsed_ms = (test_now_ns() - start) / 1000000LL;
+    CHECK(elapsed_ms >= SHORT_INTERVAL_MS - 50 && elapsed_ms < SHORT_INTERVAL_MS + 250);
+    printf("  /devices gave up after %lld ms with a %d ms refresh interval\n", elapsed_ms, SHORT_INTERVAL_MS);
+
+    unblock_port(&blocked);
+    config.display_refresh_interval_sec = 3;
+    config.display_refresh_interval_nsec = 0;
+    update_coolercontrol_timeouts(&config);
+    mock = mock_start(PORT, NULL);
+    REQUIRE(mock > 0);
+    CHECK(refresh_device_index(&config) == 1);
+    return mock;
+}
+
+/**
+ * @brief Run the delivery tests.
+ * @details Logs in to the mock once; the tests stop and restart it.
+ * @example
+ *     ./build/tests/test_delivery
+ */
+int main(void) {
+    pid_t mock = mock_start(PORT, NULL);
+    REQUIRE(mock > 0);
+    snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 3;
+    config.lcd_brightness = 80;
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(refresh_device_index(&config) == 1);
+
+    mock = test_connect_timeout(mock);
+    mock = test_breaker(mock);
+    mock = test_timeout_update(mock);
+
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+    return test_finish("delivery");
+}
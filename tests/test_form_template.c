@@ -0,0 +1,109 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the cached multipart form of LCD uploads.
+ * @details Counts the allocations of the per-frame request preparation (submit_image_data_to_lcd() up to the hand-over to the HTTP engine) with the malloc_count.so shim while uploading to the mock CoolerControl server. A frame must not allocate; a brightness or orientation change rebuilds the form once.
+ * @example
+ *     make test
+ */
+
+// Enable RTLD_DEFAULT, nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "mock_server.h"
+#include "test.h"
+#include "malloc_count.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Frames measured per phase
+#define FRAMES 20
+
+// Mock port of this test
+#define PORT 18151
+
+// Configuration of the session (must outlive it)
+static Config config;
+
+// Fake frame: only the PNG signature is checked by the mock
+static const unsigned char frame[4096] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/**
+ * @brief Delivery completion callback.
+ * @details Counts acknowledged frames in the int pointed to by user.
+ * @example
+ *     submit_image_data_to_lcd(&config, frame, sizeof(frame), uid, count_done, &delivered);
+ */
+static void count_done(int success, void *user) {
+    *(int *)user += success;
+}
+
+/**
+ * @brief Upload frames and count the allocations of their preparation.
+ * @details Only the submit call is measured; the transfer itself runs in wait_lcd_deliveries() outside the measurement. Returns the allocations of the first frame in *first and of all other frames in *rest.
+ * @example
+ *     upload_frames(FRAMES, &first, &rest);
+ */
+static void upload_frames(int frames, unsigned long long *first, unsigned long long *rest) {
+    int delivered = 0;
+    *first = 0;
+    *rest = 0;
+    for (int i = 0; i < frames; ++i) {
+        unsigned long long before = malloc_count_read(NULL);
+        int started = submit_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1", count_done, &delivered);
+        unsigned long long allocations = malloc_count_read(NULL) - before;
+        CHECK(started == 1);
+        if (i == 0) *first = allocations;
+        else *rest += allocations;
+        CHECK(wait_lcd_deliveries(2000) == 1);
+    }
+    CHECK(delivered == frames);
+}
+
+/**
+ * @brief Run the form template tests.
+ * @details Needs the malloc_count.so shim; the program re-executes itself with it preloaded.
+ * @example
+ *     ./build/tests/test_form_template
+ */
+int main(int argc, char **argv) {
+    (void)argc;
+    malloc_count_preload(argv);
+    pid_t mock = mock_start(PORT, NULL);
+    REQUIRE(mock > 0);
+    snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 1;
+    config.lcd_brightness = 80;
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(refresh_device_index(&config) == 1);
+
+    unsigned long long first, rest;
+    upload_frames(FRAMES, &first, &rest);
+    printf("  first frame %llu allocations, next %d frames %llu\n", first, FRAMES - 1, rest);
+    CHECK(first > 0); // Builds the delivery channel and the form
+    CHECK(rest == 0);
+
+    config.lcd_brightness = 60;
+    upload_frames(FRAMES, &first, &rest);
+    printf("  after a brightness change: first frame %llu allocations, next %d frames %llu\n", first, FRAMES - 1, rest);
+    CHECK(first > 0); // Form rebuilt
+    CHECK(rest == 0);
+
+    config.lcd_orientation = 90;
+    upload_frames(2, &first, &rest);
+    CHECK(first > 0 && rest == 0);
+
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+    return test_finish("form_template");
+}
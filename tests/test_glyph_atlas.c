@@ -0,0 +1,73 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the glyph atlas build and its failure latch.
+ * @details A font size too large for an image surface, or one FreeType refuses to scale, makes rasterization fail deterministically. Runs under the malloc_count.so shim to prove that a latched failure is not rebuilt. Needs cairo, so make test only builds it when pkg-config finds cairo.
+ * @example
+ *     make test
+ */
+
+// Enable RTLD_DEFAULT and setenv()
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/glyph_atlas.h"
+#include "test.h"
+#include "malloc_count.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Font size whose glyphs exceed the largest cairo image surface (or that FreeType rejects)
+#define UNRASTERIZABLE_SIZE 100000.0f
+
+/**
+ * @brief Run all glyph atlas tests.
+ * @details Uses the generic "Sans" face, which fontconfig always resolves.
+ * @example
+ *     ./build/tests/test_glyph_atlas
+ */
+int main(int argc, char **argv) {
+    (void)argc;
+    malloc_count_preload(argv);
+    static Config config;
+    memset(&config, 0, sizeof(config));
+    snprintf(config.font_face, sizeof(config.font_face), "Sans");
+    config.font_size_temp = 40.0f;
+    glyph_atlas_t atlas;
+    memset(&atlas, 0, sizeof(atlas));
+
+    CHECK(glyph_atlas_prepare(&atlas, &config) == 1);
+    cairo_text_extents_t ext;
+    glyph_atlas_measure(&atlas, "42\xC2\xB0", &ext);
+    CHECK(ext.width > 0 && ext.x_advance > ext.width / 2);
+    unsigned long long before = malloc_count_read(NULL);
+    CHECK(glyph_atlas_prepare(&atlas, &config) == 1); // Cached
+    CHECK(malloc_count_read(NULL) == before);
+
+    config.font_size_temp = UNRASTERIZABLE_SIZE;
+    CHECK(glyph_atlas_prepare(&atlas, &config) == 0);
+    CHECK(atlas.failed && !atlas.valid);
+    before = malloc_count_read(NULL);
+    for (int frame = 0; frame < 100; ++frame) {
+        CHECK(glyph_atlas_prepare(&atlas, &config) == 0); // Latched: no rebuild per frame
+    }
+    CHECK(malloc_count_read(NULL) == before);
+
+    glyph_atlas_retry(&atlas);
+    before = malloc_count_read(NULL);
+    CHECK(glyph_atlas_prepare(&atlas, &config) == 0); // Attempted again after a reload
+    CHECK(malloc_count_read(NULL) > before);
+
+    config.font_size_temp = 42.0f; // A new size is always attempted
+    CHECK(glyph_atlas_prepare(&atlas, &config) == 1);
+    CHECK(atlas.valid && !atlas.failed);
+    glyph_atlas_release(&atlas);
+    return test_finish("glyph_atlas");
+}
@@ -0,0 +1,357 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the GPU backends (NVML and nvidia-smi fallback).
+ * @details The backend state is latched per process, so every scenario runs in a fresh copy of this program with its own LD_LIBRARY_PATH (stub NVML from build/tests) and PATH (fake nvidia-smi from tests/). fork() and popen() are interposed to count the processes started.
+ * @example
+ *     make test
+ */
+
+// Enable RTLD_NEXT, setenv() and nanosleep()
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/gpu_monitor.h"
+#include "test.h"
+
+// Include necessary headers
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Processes started through fork() by the code under test
+static int fork_calls = 0;
+
+// Calls of popen() by the code under test
+static int popen_calls = 0;
+
+// File the fake nvidia-smi appends its PID to
+static const char *smi_pid_file = "/tmp/coolerdash-test-smi.pid";
+
+/**
+ * @brief Counting wrapper of fork().
+ * @details Forwards to the C library.
+ * @example
+ *     // Called by smi_stream_start().
+ */
+pid_t fork(void) {
+    pid_t (*real_fork)(void) = (pid_t (*)(void))dlsym(RTLD_NEXT, "fork");
+    ++fork_calls;
+    return real_fork();
+}
+
+/**
+ * @brief Failing popen() that only counts calls.
+ * @details The GPU probe must not spawn a shell.
+ * @example
+ *     // Never called by the code under test.
+ */
+FILE *popen(const char *command, const char *type) {
+    (void)command;
+    (void)type;
+    ++popen_calls;
+    return NULL;
+}
+
+/**
+ * @brief Read a call counter of the stub NVML library.
+ * @details Returns -1 if the stub is not loaded.
+ * @example
+ *     int calls = stub_counter("stub_nvml_temperature_calls");
+ */
+static int stub_counter(const char *name) {
+    void *lib = dlopen("libnvidia-ml.so.1", RTLD_NOW | RTLD_NOLOAD);
+    if (!lib) return -1;
+    int *counter = (int *)dlsym(lib, name);
+    int value = counter ? *counter : -1;
+    dlclose(lib);
+    return value;
+}
+
+/**
+ * @brief Configuration used by all scenarios.
+ * @details Only gpu_cache_interval is read by the GPU monitor.
+ * @example
+ *     Config config = test_config(10.0f);
+ */
+static Config test_config(float interval) {
+    Config config;
+    memset(&config, 0, sizeof(config));
+    config.gpu_cache_interval = interval;
+    return config;
+}
+
+/**
+ * @brief NVML present with one GPU.
+ * @details Temperatures come from the stub; reads within the cache interval do not call NVML again.
+ * @example
+ *     scenario_nvml();
+ */
+static void scenario_nvml(void) {
+    Config config = test_config(10.0f);
+    CHECK(init_gpu_monitor(&config) == 1);
+    CHECK(read_gpu_temp(&config) == 47.0f);
+    CHECK(read_gpu_temp(&config) == 47.0f);
+    CHECK(stub_counter("stub_nvml_temperature_calls") == 1);
+    gpu_data_t data;
+    CHECK(get_gpu_data_full(&config, &data) && data.temperature == 47.0f);
+    CHECK(fork_calls == 0 && popen_calls == 0);
+    CHECK(stub_counter("stub_nvml_init_calls") == 1);
+    cleanup_gpu_monitor();
+    CHECK(stub_counter("stub_nvml_temperature_calls") == -1); // Unloaded
+}
+
+/**
+ * @brief NVML present but no GPU, no nvidia-smi.
+ * @details NVML is unloaded again and the GPU reported as unavailable.
+ * @example
+ *     scenario_nvml_no_gpu();
+ */
+static void scenario_nvml_no_gpu(void) {
+    Config config = test_config(1.0f);
+    CHECK(init_gpu_monitor(&config) == 0);
+    CHECK(stub_counter("stub_nvml_init_calls") == -1);
+    CHECK(read_gpu_temp(&config) == 0.0f);
+    CHECK(fork_calls == 0 && popen_calls == 0);
+}
+
+/**
+ * @brief Neither NVML nor nvidia-smi.
+ * @details The probe must not start a process.
+ * @example
+ *     scenario_none();
+ */
+static void scenario_none(void) {
+    Config config = test_config(1.0f);
+    CHECK(init_gpu_monitor(&config) == 0);
+    CHECK(read_gpu_temp(&config) == 0.0f);
+    CHECK(fork_calls == 0 && popen_calls == 0);
+}
+
+/**
+ * @brief No NVML, nvidia-smi on PATH.
+ * @details Found by searching PATH; it is not run during init.
+ * @example
+ *     scenario_probe();
+ */
+static void scenario_probe(void) {
+    Config config = test_config(1.0f);
+    CHECK(init_gpu_monitor(&config) == 1);
+    CHECK(fork_calls == 0 && popen_calls == 0);
+    cleanup_gpu_monitor();
+}
+
+/**
+ * @brief Sleep for a number of milliseconds.
+ * @details Used to pace the stream polls like the sampler does.
+ * @example
+ *     sleep_ms(50);
+ */
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Poll read_gpu_temp() until it returns the expected value.
+ * @details Returns 1 if it did within timeout_ms, 0 otherwise.
+ * @example
+ *     CHECK(wait_temp(&config, 61.0f, 3000));
+ */
+static int wait_temp(const Config *config, float expected, long timeout_ms) {
+    for (long waited = 0; waited <= timeout_ms; waited += 20) {
+        if (read_gpu_temp(config) == expected) return 1;
+        sleep_ms(20);
+    }
+    return 0;
+}
+
+/**
+ * @brief Return the PID of the most recently started fake nvidia-smi.
+ * @details Returns 0 if none was started.
+ * @example
+ *     pid_t pid = last_smi_pid();
+ */
+static pid_t last_smi_pid(void) {
+    FILE *fp = fopen(smi_pid_file, "r");
+    long pid = 0, value;
+    if (!fp) return 0;
+    while (fscanf(fp, "%ld", &value) == 1) pid = value;
+    fclose(fp);
+    return (pid_t)pid;
+}
+
+/**
+ * @brief Check that a process is gone and was reaped.
+ * @details kill(pid, 0) fails with ESRCH only once the zombie was collected.
+ * @example
+ *     CHECK(reaped(pid));
+ */
+static int reaped(pid_t pid) {
+    return pid > 0 && kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+/**
+ * @brief Thread body that reads the GPU once and exits, like a sampler thread between sampler_start() and sampler_stop().
+ * @details arg is the configuration.
+ * @example
+ *     pthread_create(&thread, NULL, read_once_thread, &config);
+ */
+static void *read_once_thread(void *arg) {
+    read_gpu_temp((const Config *)arg);
+    return NULL;
+}
+
+/**
+ * @brief nvidia-smi stream started from a thread that exits.
+ * @details The child must outlive the thread that forked it, deliver values to later reads without a restart and be killed and reaped by stop_gpu_stream().
+ * @example
+ *     scenario_stream();
+ */
+static void scenario_stream(void) {
+    Config config = test_config(0.1f);
+    CHECK(init_gpu_monitor(&config) == 1);
+    CHECK(fork_calls == 0);
+    pthread_t thread;
+    REQUIRE(pthread_create(&thread, NULL, read_once_thread, &config) == 0);
+    pthread_join(thread, NULL);
+    CHECK(fork_calls == 1);
+    CHECK(wait_temp(&config, 61.0f, 3000));
+    sleep_ms(300);
+    CHECK(read_gpu_temp(&config) == 61.0f);
+    CHECK(fork_calls == 1); // Not killed along with the thread
+    pid_t pid = last_smi_pid();
+    CHECK(pid > 0 && kill(pid, 0) == 0);
+    stop_gpu_stream();
+    CHECK(reaped(pid));
+    CHECK(popen_calls == 0);
+}
+
+/**
+ * @brief nvidia-smi exits after one line.
+ * @details Its value is dropped as soon as the exit is seen, and the stream is restarted after the backoff.
+ * @example
+ *     scenario_exit();
+ */
+static void scenario_exit(void) {
+    Config config = test_config(0.1f);
+    CHECK(init_gpu_monitor(&config) == 1);
+    CHECK(wait_temp(&config, 61.0f, 3000));
+    CHECK(wait_temp(&config, 0.0f, 500));
+    CHECK(reaped(last_smi_pid()));
+    CHECK(wait_temp(&config, 61.0f, 3000)); // Restarted after SMI_BACKOFF_INITIAL_MS
+    CHECK(fork_calls == 2);
+    cleanup_gpu_monitor();
+}
+
+/**
+ * @brief nvidia-smi stops writing but keeps running.
+ * @details Its value is dropped once it misses its deadline, and the hung child is killed and reaped.
+ * @example
+ *     scenario_hang();
+ */
+static void scenario_hang(void) {
+    Config config = test_config(0.1f);
+    CHECK(init_gpu_monitor(&config) == 1);
+    CHECK(wait_temp(&config, 61.0f, 3000));
+    pid_t pid = last_smi_pid();
+    CHECK(wait_temp(&config, 0.0f, 1000));
+    CHECK(reaped(pid));
+    cleanup_gpu_monitor();
+}
+
+/**
+ * @brief nvidia-smi ignores SIGTERM.
+ * @details stop_gpu_stream() must not block on it: the child is killed with SIGKILL after the short grace period and reaped.
+ * @example
+ *     scenario_stubborn();
+ */
+static void scenario_stubborn(void) {
+    Config config = test_config(0.1f);
+    CHECK(init_gpu_monitor(&config) == 1);
+    CHECK(wait_temp(&config, 61.0f, 3000));
+    pid_t pid = last_smi_pid();
+    long long start = test_now_ns();
+    stop_gpu_stream();
+    long long elapsed_ms = (test_now_ns() - start) / 1000000;
+    printf("  stop of a child ignoring SIGTERM took %lld ms\n", elapsed_ms);
+    CHECK(elapsed_ms < 1000);
+    CHECK(reaped(pid));
+    cleanup_gpu_monitor();
+}
+
+/**
+ * @brief Run one scenario in a fresh process.
+ * @details Re-executes this program with the scenario name and the given library and executable search paths; extra is an optional NAME=value setting. Returns 1 if the scenario passed.
+ * @example
+ *     run_scenario("none", "/nonexistent", "/nonexistent", NULL);
+ */
+static int run_scenario(const char *name, const char *library_path, const char *path, const char *extra) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        setenv("LD_LIBRARY_PATH", library_path, 1);
+        setenv("PATH", path, 1);
+        if (extra) putenv((char *)extra);
+        execl("/proc/self/exe", "test_gpu_monitor", name, (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return 0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Run all GPU monitor scenarios.
+ * @details Without arguments every scenario is run in its own process; with a scenario name only that one runs in this process.
+ * @example
+ *     ./build/tests/test_gpu_monitor
+ */
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "nvml") == 0) scenario_nvml();
+        else if (strcmp(argv[1], "nvml-no-gpu") == 0) scenario_nvml_no_gpu();
+        else if (strcmp(argv[1], "none") == 0) scenario_none();
+        else if (strcmp(argv[1], "probe") == 0) scenario_probe();
+        else if (strcmp(argv[1], "stream") == 0) scenario_stream();
+        else if (strcmp(argv[1], "exit") == 0) scenario_exit();
+        else if (strcmp(argv[1], "hang") == 0) scenario_hang();
+        else if (strcmp(argv[1], "stubborn") == 0) scenario_stubborn();
+        else CHECK(!"unknown scenario");
+        return test_finish(argv[1]);
+    }
+    const char *bin = getenv("COOLERDASH_TEST_BIN");
+    const char *src = getenv("COOLERDASH_TEST_SRC");
+    char stub_dir[256], smi_dir[256], smi_path[600];
+    REQUIRE(realpath(bin ? bin : "build/tests", stub_dir) != NULL);
+    REQUIRE(realpath(src ? src : "tests", smi_dir) != NULL);
+    snprintf(smi_path, sizeof(smi_path), "%s:/usr/bin:/bin", smi_dir); // The fake needs sleep
+    char pid_setting[128];
+    snprintf(pid_setting, sizeof(pid_setting), "FAKE_SMI_PIDFILE=%s", smi_pid_file);
+    unlink(smi_pid_file);
+
+    CHECK(run_scenario("nvml", stub_dir, "/nonexistent", "STUB_NVML_TEMP=47"));
+    CHECK(run_scenario("nvml-no-gpu", stub_dir, "/nonexistent", "STUB_NVML_COUNT=0"));
+    CHECK(run_scenario("none", "/nonexistent", "/nonexistent", NULL));
+    CHECK(run_scenario("probe", "/nonexistent", smi_path, NULL));
+    CHECK(run_scenario("stream", "/nonexistent", smi_path, pid_setting));
+    setenv("FAKE_SMI_MODE", "exit", 1);
+    CHECK(run_scenario("exit", "/nonexistent", smi_path, pid_setting));
+    setenv("FAKE_SMI_MODE", "hang", 1);
+    CHECK(run_scenario("hang", "/nonexistent", smi_path, pid_setting));
+    setenv("FAKE_SMI_MODE", "stubborn", 1);
+    CHECK(run_scenario("stubborn", "/nonexistent", smi_path, pid_setting));
+
+    unlink(smi_pid_file);
+    return test_finish("gpu_monitor");
+}
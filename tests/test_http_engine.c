@@ -0,0 +1,202 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the non-blocking HTTP engine against the mock CoolerControl server.
+ * @details Checks that several requests are in flight at once on one thread: plain engine requests, delayed starts and cancellation, and a device re-discovery that completes while a slow image upload is still on the wire.
+ * @example
+ *     make test
+ */
+
+// Enable nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/http_engine.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Mock port of this test
+#define PORT 18121
+
+// Latency the mock adds to every image upload
+#define UPLOAD_LATENCY_MS 400
+
+// Configuration of the session (must outlive it)
+static Config config;
+
+// Fake frame: only the PNG signature is checked by the mock
+static const unsigned char frame[64] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/**
+ * @brief Completion record of one engine request.
+ * @details Filled by request_done().
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int calls;             // Times done() was called
+    CURLcode result;       // Transfer result
+    long response_code;    // HTTP status
+    long long done_ns;     // Completion time
+} completion_t;
+
+/**
+ * @brief Engine completion callback of the test requests.
+ * @details Records the result in the completion_t passed as user.
+ * @example
+ *     req.done = request_done;
+ */
+static void request_done(http_request_t *req, CURLcode result, long response_code) {
+    completion_t *c = req->user;
+    c->calls++;
+    c->result = result;
+    c->response_code = response_code;
+    c->done_ns = test_now_ns();
+}
+
+/**
+ * @brief Delivery completion callback of the test uploads.
+ * @details Stores success in the int pointed to by user.
+ * @example
+ *     submit_image_data_to_lcd(&config, frame, sizeof(frame), uid, upload_done, &result);
+ */
+static void upload_done(int success, void *user) {
+    *(int *)user = success;
+}
+
+/**
+ * @brief cURL write callback that drops the response body.
+ * @details Only the status of the test requests matters.
+ * @example
+ *     curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, discard_body);
+ */
+static size_t discard_body(char *contents, size_t size, size_t nmemb, void *user) {
+    (void)contents;
+    (void)user;
+    return size * nmemb;
+}
+
+/**
+ * @brief Prepare a GET /health request on a new engine handle.
+ * @details Returns 1 on success.
+ * @example
+ *     health_request(&req, &completion);
+ */
+static int health_request(http_request_t *req, completion_t *c) {
+    char url[64];
+    memset(req, 0, sizeof(*req));
+    memset(c, 0, sizeof(*c));
+    req->easy = http_engine_easy();
+    if (!req->easy) return 0;
+    snprintf(url, sizeof(url), "http://127.0.0.1:%d/health", PORT);
+    curl_easy_setopt(req->easy, CURLOPT_URL, url);
+    curl_easy_setopt(req->easy, CURLOPT_WRITEFUNCTION, discard_body);
+    req->done = request_done;
+    req->user = c;
+    return 1;
+}
+
+/**
+ * @brief Run the engine until no request is pending or timeout_ms passed.
+ * @details Returns 1 if the engine became idle.
+ * @example
+ *     CHECK(run_until_idle(2000));
+ */
+static int run_until_idle(long timeout_ms) {
+    long long deadline = test_now_ns() + timeout_ms * 1000000LL;
+    while (http_engine_pending() > 0) {
+        if (test_now_ns() > deadline || http_engine_run(50) < 0) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Concurrent, delayed and cancelled engine requests.
+ * @details Two requests submitted together both finish; a delayed start does not finish before its delay; a cancelled request never calls done().
+ * @example
+ *     test_engine_requests();
+ */
+static void test_engine_requests(void) {
+    http_request_t a, b, delayed, cancelled;
+    completion_t ca, cb, cd, cc;
+    REQUIRE(health_request(&a, &ca) && health_request(&b, &cb));
+    REQUIRE(health_request(&delayed, &cd) && health_request(&cancelled, &cc));
+    CHECK(http_engine_submit(&a) == 1);
+    CHECK(http_engine_submit(&b) == 1);
+    CHECK(http_engine_pending() == 2);
+    CHECK(run_until_idle(2000));
+    CHECK(ca.calls == 1 && ca.result == CURLE_OK && ca.response_code == 200);
+    CHECK(cb.calls == 1 && cb.result == CURLE_OK && cb.response_code == 200);
+
+    long long start = test_now_ns();
+    CHECK(http_engine_submit_after(&delayed, 150) == 1);
+    CHECK(http_engine_submit_after(&cancelled, 150) == 1);
+    http_engine_cancel(&cancelled);
+    CHECK(http_engine_pending() == 1);
+    CHECK(run_until_idle(2000));
+    CHECK(cd.calls == 1 && cd.response_code == 200);
+    CHECK(cd.done_ns - start >= 150 * 1000000LL);
+    CHECK(cc.calls == 0);
+
+    curl_easy_cleanup(a.easy);
+    curl_easy_cleanup(b.easy);
+    curl_easy_cleanup(delayed.easy);
+    curl_easy_cleanup(cancelled.easy);
+}
+
+/**
+ * @brief Device re-discovery during a slow upload.
+ * @details The blocking refresh_device_index() drives the engine itself, so it finishes long before the upload, which is still in flight afterwards and then succeeds.
+ * @example
+ *     test_discovery_during_upload();
+ */
+static void test_discovery_during_upload(void) {
+    int result = -1;
+    REQUIRE(get_device_count() >= 1);
+    CHECK(submit_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1", upload_done, &result) == 1);
+    long long start = test_now_ns();
+    CHECK(refresh_device_index(&config) == 1);
+    long long discovery_ns = test_now_ns() - start;
+    CHECK(discovery_ns < UPLOAD_LATENCY_MS / 2 * 1000000LL);
+    CHECK(result == -1); // Upload still on the wire
+    CHECK(wait_lcd_deliveries(2000) == 1);
+    CHECK(result == 1);
+    CHECK(http_engine_pending() == 0);
+    printf("  discovery took %.1f ms during a %d ms upload\n", discovery_ns / 1e6, UPLOAD_LATENCY_MS);
+}
+
+/**
+ * @brief Run the HTTP engine tests.
+ * @details Starts the mock with a slow image endpoint and logs in once.
+ * @example
+ *     ./build/tests/test_http_engine
+ */
+int main(void) {
+    char latency[16];
+    snprintf(latency, sizeof(latency), "%d", UPLOAD_LATENCY_MS);
+    pid_t mock = mock_start(PORT, (const char *[]){ "-l", latency, NULL });
+    REQUIRE(mock > 0);
+    snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 2;
+    config.lcd_brightness = 80;
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(refresh_device_index(&config) == 1);
+
+    test_engine_requests();
+    test_discovery_during_upload();
+
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+    return test_finish("http_engine");
+}
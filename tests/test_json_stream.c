@@ -0,0 +1,287 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the streaming JSON parser and the /devices device index.
+ * @details The parser must report the same tokens however the input is split, unescape strings and reject invalid documents. The device index is built from a large generated /devices response served by the mock CoolerControl server (-D), including a device object far larger than the 4096 bytes the old parser could hold, and copied from another thread while it is replaced.
+ * @example
+ *     make test
+ */
+
+// Enable mkstemp(), nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/json_stream.h"
+#include "devices_payload.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <pthread.h>
+#include <string.h>
+
+// Devices in the generated /devices response
+#define DEVICE_COUNT 400
+
+// status_history entries per generated device
+#define DEVICE_HISTORY 20
+
+// Mock port of this test
+#define PORT 18161
+
+// Index refreshes while test_concurrent_readers() copies devices
+#define READER_REFRESHES 5
+
+// Size of the token trace buffer
+#define TRACE_SIZE 4096
+
+/**
+ * @brief Token trace of one parse.
+ * @details Every token is appended as "<event>:<depth>:<text>;" so two parses can be compared with strcmp().
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    char text[TRACE_SIZE]; // Trace so far
+    size_t len;            // Bytes in text
+} trace_t;
+
+/**
+ * @brief Token callback that appends to a trace.
+ * @details user is the trace_t.
+ * @example
+ *     json_stream_init(&parser, trace_token, &trace);
+ */
+static void trace_token(json_event_t event, const char *text, int depth, void *user) {
+    trace_t *trace = user;
+    if (trace->len < sizeof(trace->text)) {
+        trace->len += (size_t)snprintf(trace->text + trace->len, sizeof(trace->text) - trace->len, "%d:%d:%s;", (int)event, depth, text ? text : "");
+    }
+}
+
+/**
+ * @brief Parse a document in two chunks split at a position.
+ * @details split 0 feeds everything at once. Returns the result of json_stream_finish(), or 0 if a feed failed.
+ * @example
+ *     int ok = parse_split(doc, 5, &trace);
+ */
+static int parse_split(const char *doc, size_t split, trace_t *trace) {
+    json_stream_t parser;
+    memset(trace, 0, sizeof(*trace));
+    json_stream_init(&parser, trace_token, trace);
+    size_t len = strlen(doc);
+    if (!json_stream_feed(&parser, doc, split)) return 0;
+    if (!json_stream_feed(&parser, doc + split, len - split)) return 0;
+    return json_stream_finish(&parser);
+}
+
+/**
+ * @brief Parse a document one byte at a time.
+ * @details Returns the result of json_stream_finish(), or 0 if a feed failed.
+ * @example
+ *     int ok = parse_bytewise(doc, &trace);
+ */
+static int parse_bytewise(const char *doc, trace_t *trace) {
+    json_stream_t parser;
+    memset(trace, 0, sizeof(*trace));
+    json_stream_init(&parser, trace_token, trace);
+    for (const char *p = doc; *p; ++p) {
+        if (!json_stream_feed(&parser, p, 1)) return 0;
+    }
+    return json_stream_finish(&parser);
+}
+
+/**
+ * @brief The same tokens for every split of the input.
+ * @details Covers all token types, nesting, escapes (including a surrogate pair split anywhere) and numbers at chunk ends.
+ * @example
+ *     test_split_invariance();
+ */
+static void test_split_invariance(void) {
+    static const char doc[] =
+        "{\"a\":[1,-2.5e3,true,false,null,{}],\"b\":{\"c\":\"x\\\"y\\\\z\\/\\n\\u00e9\\ud83d\\ude00\"},\"d\":[],\"e\":12345}";
+    trace_t whole, part;
+    REQUIRE(parse_split(doc, 0, &whole) == 1);
+    CHECK(strstr(whole.text, "x\"y\\z/\n\xc3\xa9\xf0\x9f\x98\x80") != NULL);
+    CHECK(strstr(whole.text, "6:2:-2.5e3;") != NULL); // Number inside the array at depth 2
+    CHECK(strstr(whole.text, "6:1:12345;") != NULL);
+    int same = 1;
+    for (size_t split = 1; split < sizeof(doc) - 1; ++split) {
+        same &= parse_split(doc, split, &part) == 1 && strcmp(part.text, whole.text) == 0;
+    }
+    CHECK(same);
+    CHECK(parse_bytewise(doc, &part) == 1 && strcmp(part.text, whole.text) == 0);
+}
+
+/**
+ * @brief Top-level scalars, truncated strings and invalid documents.
+ * @details A trailing top-level number is only complete at json_stream_finish(); overlong strings are truncated to JSON_STREAM_MAX_TOKEN - 1 bytes.
+ * @example
+ *     test_edge_cases();
+ */
+static void test_edge_cases(void) {
+    trace_t trace;
+    CHECK(parse_split("42", 0, &trace) == 1 && strcmp(trace.text, "6:0:42;") == 0);
+    CHECK(parse_split(" true ", 0, &trace) == 1);
+
+    char long_doc[1100];
+    memset(long_doc, 'a', sizeof(long_doc));
+    long_doc[0] = '"';
+    long_doc[1000] = '"';
+    long_doc[1001] = '\0';
+    CHECK(parse_split(long_doc, 0, &trace) == 1);
+    CHECK(strlen(trace.text) == strlen("5:0:;") + JSON_STREAM_MAX_TOKEN - 1);
+
+    static const char *const invalid[] = {
+        "", "[1,]", "{\"a\":}", "{\"a\" 1}", "[1 2]", "{} x", "[1", "\"abc", "tru", "{\"a\":1,}", "\"\\x\"", "[\"\\u12G4\"]", "]"
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        int ok = parse_split(invalid[i], 0, &trace);
+        CHECK(ok == 0);
+        if (ok) fprintf(stderr, "  accepted: %s\n", invalid[i]);
+    }
+
+    char deep[2 * (JSON_STREAM_MAX_DEPTH + 1) + 1];
+    for (int i = 0; i <= JSON_STREAM_MAX_DEPTH; ++i) {
+        deep[i] = '[';
+        deep[JSON_STREAM_MAX_DEPTH + 1 + i] = ']';
+    }
+    deep[sizeof(deep) - 1] = '\0';
+    CHECK(parse_split(deep, 0, &trace) == 0);
+    deep[JSON_STREAM_MAX_DEPTH] = ' '; // Exactly JSON_STREAM_MAX_DEPTH levels
+    deep[JSON_STREAM_MAX_DEPTH + 1] = ' ';
+    CHECK(parse_split(deep, 0, &trace) == 1);
+}
+
+/**
+ * @brief State shared with the index reader thread.
+ * @details Written by index_reader(), read by the test after joining it.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int stop;                  // Set by the test to end the reader (__atomic)
+    unsigned long long copies; // Devices copied
+    unsigned long long bad;    // Copies that were not a complete device entry
+} index_reader_t;
+
+/**
+ * @brief Thread that keeps copying the device index.
+ * @details Mimics the control socket reading the index while the engine thread replaces it. arg is the index_reader_t.
+ * @example
+ *     pthread_create(&thread, NULL, index_reader, &reader);
+ */
+static void *index_reader(void *arg) {
+    index_reader_t *reader = arg;
+    cc_device_t dev;
+    while (!__atomic_load_n(&reader->stop, __ATOMIC_RELAXED)) {
+        for (size_t i = 0; copy_device_info(i, &dev); ++i) {
+            reader->copies++;
+            if (i > 0 && strncmp(dev.uid, "uid-", 4) != 0) reader->bad++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Copy devices on another thread while the index is replaced.
+ * @details Every copy must be a complete entry of either the old or the new index.
+ * @example
+ *     test_concurrent_readers(&config);
+ */
+static void test_concurrent_readers(const Config *config) {
+    index_reader_t reader = {0};
+    pthread_t thread;
+    REQUIRE(pthread_create(&thread, NULL, index_reader, &reader) == 0);
+    int ok = 1;
+    for (int i = 0; i < READER_REFRESHES; ++i) ok &= refresh_device_index(config);
+    __atomic_store_n(&reader.stop, 1, __ATOMIC_RELAXED);
+    pthread_join(thread, NULL);
+    CHECK(ok);
+    CHECK(reader.copies > 0);
+    CHECK(reader.bad == 0);
+    CHECK(get_device_count() == DEVICE_COUNT);
+}
+
+/**
+ * @brief Build the device index from a large /devices response.
+ * @details The response is written to a temporary file and served by the mock; refresh_device_index() streams it through the parser in cURL-sized chunks.
+ * @example
+ *     test_device_index();
+ */
+static void test_device_index(void) {
+    char path[] = "/tmp/coolerdash-test-devices-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    FILE *fp = fdopen(fd, "w");
+    REQUIRE(fp != NULL);
+    devices_payload_write(fp, DEVICE_COUNT, DEVICE_HISTORY);
+    long payload_size = ftell(fp);
+    fclose(fp);
+
+    pid_t mock = mock_start(PORT, (const char *[]){ "-D", path, NULL });
+    REQUIRE(mock > 0);
+    static Config config;
+    snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 1;
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    CHECK(refresh_device_index(&config) == 1);
+    CHECK(get_device_count() == DEVICE_COUNT);
+    printf("  %zu devices indexed from a %ld byte response\n", get_device_count(), payload_size);
+
+    cc_device_t odd;
+    REQUIRE(copy_device_info(0, &odd));
+    CHECK(strncmp(odd.uid, "odd-abcdefghijklmnopqrstuvwxyz", 30) == 0);
+    CHECK(strlen(odd.uid) == CC_UID_SIZE - 1);
+    CHECK(strcmp(odd.name, DEVICES_PAYLOAD_ODD_NAME) == 0);
+    CHECK(strcmp(odd.type, "Liquidctl") == 0);
+    CHECK(odd.has_lcd && strcmp(odd.lcd_channel, "lcd") == 0);
+    CHECK(odd.lcd_width == 320 && odd.lcd_height == 320 && odd.lcd_max_image_size == 24320);
+
+    int lcds_ok = 1, others_ok = 1;
+    for (int i = 1; i < DEVICE_COUNT; ++i) {
+        cc_device_t dev;
+        char uid[32], name[32];
+        snprintf(uid, sizeof(uid), "uid-%d", i);
+        snprintf(name, sizeof(name), "Device %d", i);
+        if (!copy_device_info((size_t)i, &dev) || strcmp(dev.uid, uid) != 0 || strcmp(dev.name, name) != 0) {
+            others_ok = 0;
+            continue;
+        }
+        if (devices_payload_has_lcd(i)) {
+            lcds_ok &= dev.has_lcd && dev.lcd_width == 200 + i % 200 && dev.lcd_max_image_size == 1000L * i;
+        } else {
+            others_ok &= !dev.has_lcd && dev.lcd_channel[0] == '\0';
+        }
+    }
+    CHECK(lcds_ok);
+    CHECK(others_ok);
+    cc_device_t none;
+    CHECK(!copy_device_info(DEVICE_COUNT, &none));
+    test_concurrent_readers(&config);
+
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+    unlink(path);
+}
+
+/**
+ * @brief Run the JSON parser and device index tests.
+ * @details The device index test needs the mock server (make test).
+ * @example
+ *     ./build/tests/test_json_stream
+ */
+int main(void) {
+    test_split_invariance();
+    test_edge_cases();
+    test_device_index();
+    return test_finish("json_stream");
+}
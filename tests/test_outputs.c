@@ -0,0 +1,200 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief End-to-end tests of the LCD output selection.
+ * @details Runs the coolerdash daemon (COOLERDASH_DAEMON, set by make test) against the mock CoolerControl server with three LCDs and records the frames it receives. Without [device.*] sections every LCD is driven; with sections only the matching ones; with sections that match nothing the daemon stays idle and sends neither frames nor the shutdown image. Needs the daemon, so make test only builds it when cairo and inih are found.
+ * @example
+ *     make test
+ */
+
+// Enable mkdtemp(), nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// LCDs reported by the mock
+#define LCD_COUNT 3
+
+// Mock port of the first scenario; each scenario uses its own
+#define BASE_PORT 18181
+
+// How long the daemon runs per scenario
+#define RUN_MS 1500
+
+/**
+ * @brief Sleep for a number of milliseconds.
+ * @details Lets the daemon render a few frames.
+ * @example
+ *     sleep_ms(RUN_MS);
+ */
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Copy a file.
+ * @details Returns 1 on success.
+ * @example
+ *     copy_file("etc/coolerdash/config.ini", "/tmp/x/config.ini");
+ */
+static int copy_file(const char *from, FILE *to) {
+    FILE *in = fopen(from, "r");
+    if (!in) return 0;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) fwrite(buffer, 1, n, to);
+    fclose(in);
+    return 1;
+}
+
+/**
+ * @brief Count the recorded frames of one device.
+ * @details The mock names recorded files <uid>-<sequence>.png.
+ * @example
+ *     int frames = count_frames(dir, "mock-lcd-2");
+ */
+static int count_frames(const char *dir, const char *uid) {
+    DIR *d = opendir(dir);
+    if (!d) return 0;
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "%s-", uid);
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (strncmp(entry->d_name, prefix, strlen(prefix)) == 0) ++count;
+    }
+    closedir(d);
+    return count;
+}
+
+/**
+ * @brief Return whether a file contains a string.
+ * @details Reads at most 64 KiB.
+ * @example
+ *     CHECK(file_contains(log, "staying idle"));
+ */
+static int file_contains(const char *path, const char *needle) {
+    static char buffer[65536];
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+    size_t n = fread(buffer, 1, sizeof(buffer) - 1, fp);
+    fclose(fp);
+    buffer[n] = '\0';
+    return strstr(buffer, needle) != NULL;
+}
+
+/**
+ * @brief Run the daemon with extra configuration against a fresh mock.
+ * @details The shipped config.ini is copied and extended with test paths, a fast refresh interval and sections (may be ""). Frames are recorded into <dir>/frames and the daemon output goes to <dir>/daemon.log. Returns 1 if the daemon exited cleanly after SIGTERM.
+ * @example
+ *     run_daemon(dir, BASE_PORT, "[device.top]\nuid=mock-lcd-2\n");
+ */
+static int run_daemon(const char *dir, int port, const char *sections) {
+    const char *daemon = getenv("COOLERDASH_DAEMON");
+    const char *src = getenv("COOLERDASH_TEST_SRC");
+    REQUIRE(daemon != NULL);
+    char path[512], frames[512], log[512], shutdown_png[512], shipped[512];
+    snprintf(frames, sizeof(frames), "%s/frames", dir);
+    snprintf(log, sizeof(log), "%s/daemon.log", dir);
+    snprintf(shutdown_png, sizeof(shutdown_png), "%s/shutdown.png", dir);
+    snprintf(shipped, sizeof(shipped), "%s/../etc/coolerdash/config.ini", src ? src : "tests");
+
+    FILE *png = fopen(shutdown_png, "wb");
+    REQUIRE(png != NULL);
+    fwrite("\x89PNG\r\n\x1a\n0000", 1, 12, png);
+    fclose(png);
+
+    snprintf(path, sizeof(path), "%s/config.ini", dir);
+    FILE *config = fopen(path, "w");
+    REQUIRE(config != NULL);
+    REQUIRE(copy_file(shipped, config));
+    fprintf(config, "\n[display]\nrefresh_interval_sec=0\nrefresh_interval_nsec=100000000\n"
+            "[paths]\nimage_dir=%s\nshutdown_image=%s\npid_file=%s/coolerdash.pid\ncontrol_socket=\n"
+            "[daemon]\naddress=http://127.0.0.1:%d\npassword=coolAdmin\n%s",
+            dir, shutdown_png, dir, port, sections);
+    fclose(config);
+
+    char count[8];
+    snprintf(count, sizeof(count), "%d", LCD_COUNT);
+    pid_t mock = mock_start(port, (const char *[]){ "-n", count, "-r", frames, NULL });
+    REQUIRE(mock > 0);
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid == 0) {
+        int fd = open(log, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) _exit(127);
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        execl(daemon, "coolerdash", path, (char *)NULL);
+        _exit(127);
+    }
+    REQUIRE(pid > 0);
+    sleep_ms(RUN_MS);
+    kill(pid, SIGTERM);
+    int status = 0;
+    int exited = waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    CHECK(mock_stop(mock));
+    return exited;
+}
+
+/**
+ * @brief Run one scenario in a fresh temporary directory.
+ * @details expected[i] is 1 if mock-lcd-<i+1> must receive frames, 0 if it must receive nothing. log_text, if not NULL, must appear in the daemon output. The directory is kept if the scenario fails.
+ * @example
+ *     scenario("all", 0, "", (int[]){ 1, 1, 1 }, NULL);
+ */
+static void scenario(const char *name, int index, const char *sections, const int expected[LCD_COUNT], const char *log_text) {
+    char dir[] = "/tmp/coolerdash-test-outputs-XXXXXX";
+    REQUIRE(mkdtemp(dir) != NULL);
+    CHECK(run_daemon(dir, BASE_PORT + index, sections));
+    char frames[512], log[512];
+    snprintf(frames, sizeof(frames), "%s/frames", dir);
+    snprintf(log, sizeof(log), "%s/daemon.log", dir);
+    int ok = 1;
+    for (int i = 0; i < LCD_COUNT; ++i) {
+        char uid[32];
+        snprintf(uid, sizeof(uid), "mock-lcd-%d", i + 1);
+        int received = count_frames(frames, uid);
+        ok &= expected[i] ? received >= 2 : received == 0; // Frames plus the shutdown image
+        printf("  %s: %s received %d images\n", name, uid, received);
+    }
+    CHECK(ok);
+    if (log_text) CHECK(file_contains(log, log_text));
+    if (!ok || (log_text && !file_contains(log, log_text))) {
+        fprintf(stderr, "  daemon output kept in %s\n", log);
+        return;
+    }
+    char command[600];
+    snprintf(command, sizeof(command), "rm -rf '%s'", dir);
+    CHECK(system(command) == 0);
+}
+
+/**
+ * @brief Run all output selection scenarios.
+ * @details Each scenario starts its own mock and daemon.
+ * @example
+ *     ./build/tests/test_outputs
+ */
+int main(void) {
+    scenario("no sections", 0, "", (const int[]){ 1, 1, 1 }, NULL);
+    scenario("one section", 1, "[device.top]\nuid=mock-lcd-2\nbrightness=50\n", (const int[]){ 0, 1, 0 }, "LCD output [device.top]");
+    scenario("no match", 2, "[device.top]\nuid=not-connected\n[device.side]\nuid=mock-lcd-4\n",
+             (const int[]){ 0, 0, 0 }, "staying idle");
+    scenario("disabled", 3, "[device.top]\nuid=mock-lcd-1\nenabled=0\n", (const int[]){ 0, 0, 0 }, "staying idle");
+    return test_finish("outputs");
+}
@@ -0,0 +1,101 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the persistent render target and the cached background layer.
+ * @details Renders through render_display() with the shipped config.ini under the malloc_count.so shim. A re-created surface shows up as an allocation of at least one full frame (width * height * 4 bytes); the per-frame PNG encoder allocations are far smaller. Once the caches are built, drawing a frame (draw_display_frame(), no encoder) must not allocate at all. Needs cairo, so make test only builds it when pkg-config finds cairo.
+ * @example
+ *     make test
+ */
+
+// Enable RTLD_DEFAULT and setenv()
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/config.h"
+#include "../include/display.h"
+#include "test.h"
+#include "malloc_count.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Frames drawn for the allocation-free check
+#define DRAW_FRAMES 20
+
+/**
+ * @brief Render one frame with temperatures different enough to be drawn.
+ * @details Returns the largest single allocation made while rendering it.
+ * @example
+ *     unsigned long long largest = frame(&config, 1);
+ */
+static unsigned long long frame(const Config *config, int n) {
+    sensor_data_t data = { (n & 1) ? 45.0f : 65.0f, (n & 2) ? 35.0f : 75.0f };
+    malloc_count_take_largest();
+    CHECK(render_display(config, &data) == 1);
+    return malloc_count_take_largest();
+}
+
+/**
+ * @brief Count the allocations of drawing frames without encoding them.
+ * @details Draws DRAW_FRAMES frames with the temperatures of frame() (fill widths, fill colors and text all change) through draw_display_frame(). Returns the number of allocations.
+ * @example
+ *     CHECK(draw_allocations(&config) == 0);
+ */
+static unsigned long long draw_allocations(const Config *config) {
+    unsigned long long before = malloc_count_read(NULL);
+    for (int n = 0; n < DRAW_FRAMES; ++n) {
+        sensor_data_t data = { (n & 1) ? 45.0f : 65.0f, (n & 2) ? 35.0f : 75.0f };
+        CHECK(draw_display_frame(config, &data) == 1);
+    }
+    return malloc_count_read(NULL) - before;
+}
+
+/**
+ * @brief Run all render tests.
+ * @details The configuration file can be given as argument (default etc/coolerdash/config.ini).
+ * @example
+ *     ./build/tests/test_render
+ */
+int main(int argc, char **argv) {
+    malloc_count_preload(argv);
+    static Config config;
+    REQUIRE(load_config_ini(&config, argc > 1 ? argv[1] : "etc/coolerdash/config.ini") == 0);
+    config.write_image = 0;
+    const unsigned long long surface_bytes = (unsigned long long)config.display_width * config.display_height * 4;
+
+    CHECK(frame(&config, 0) >= surface_bytes); // First frame builds the target and the background
+    for (int n = 1; n <= 20; ++n) {
+        CHECK(frame(&config, n) < surface_bytes); // Target and background reused
+    }
+
+    unsigned long long drawn = draw_allocations(&config);
+    unsigned long long before = malloc_count_read(NULL);
+    CHECK(frame(&config, 2) < surface_bytes); // Differs from frames 20 and 21, so both are drawn
+    unsigned long long encoded = malloc_count_read(NULL) - before;
+    printf("  draw: %llu allocations in %d frames; draw + PNG encode: %llu allocations per frame\n", drawn, DRAW_FRAMES, encoded);
+    CHECK(drawn == 0); // Only the PNG encoder allocates
+
+    config.color_bg_bar.r ^= 0x40; // Part of the background key
+    CHECK(frame(&config, 21) >= surface_bytes); // Background rebuilt
+    CHECK(frame(&config, 22) < surface_bytes);
+
+    config.temp_threshold_red += 1.0f; // Not part of the background key
+    CHECK(frame(&config, 23) < surface_bytes);
+
+    sensor_data_t same = { 45.0f, 75.0f };
+    CHECK(render_display(&config, &same) == 1);
+    before = malloc_count_read(NULL);
+    CHECK(render_display(&config, &same) == 1); // Unchanged values: nothing drawn
+    CHECK(malloc_count_read(NULL) == before);
+
+    config.display_width += 16; // Resolution change rebuilds the target
+    CHECK(frame(&config, 24) >= surface_bytes);
+    cleanup_display();
+    return test_finish("render");
+}
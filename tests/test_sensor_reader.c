@@ -0,0 +1,109 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the persistent-descriptor sysfs reader.
+ * @details Covers the integer parser and pread() on a descriptor whose file is rewritten between reads, as a hwmon value file is.
+ * @example
+ *     make test
+ */
+
+// Enable pread(), mkstemp() and ftruncate()
+#define _POSIX_C_SOURCE 200809L
+
+// Include project headers
+#include "../include/sensor_reader.h"
+#include "test.h"
+
+// Include necessary headers
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Replace the content of a file the way sysfs presents a new value.
+ * @details Writes at offset 0 and truncates, keeping the inode and every open descriptor.
+ * @example
+ *     rewrite(path, "45000\n");
+ */
+static void rewrite(const char *path, const char *text) {
+    int fd = open(path, O_WRONLY);
+    REQUIRE(fd >= 0);
+    REQUIRE(pwrite(fd, text, strlen(text), 0) == (ssize_t)strlen(text));
+    REQUIRE(ftruncate(fd, (off_t)strlen(text)) == 0);
+    close(fd);
+}
+
+/**
+ * @brief Check sensor_parse_long() on typical and malformed sysfs contents.
+ * @details Values are not null terminated; the length bounds the parse.
+ * @example
+ *     test_parse();
+ */
+static void test_parse(void) {
+    long v = 0;
+    CHECK(sensor_parse_long("45000\n", 6, &v) == 1 && v == 45000);
+    CHECK(sensor_parse_long(" -273\n", 6, &v) == 1 && v == -273);
+    CHECK(sensor_parse_long("12345", 3, &v) == 1 && v == 123);
+    v = 7;
+    CHECK(sensor_parse_long("\n", 1, &v) == 0 && v == 7);
+    CHECK(sensor_parse_long("-", 1, &v) == 0 && v == 7);
+    CHECK(sensor_parse_long("", 0, &v) == 0 && v == 7);
+}
+
+/**
+ * @brief Check sensor_pread_long() on a descriptor that stays open across value changes.
+ * @details Each read must see the current value from offset 0 without reopening.
+ * @example
+ *     test_pread();
+ */
+static void test_pread(void) {
+    char path[] = "/tmp/coolerdash-test-XXXXXX";
+    int writer = mkstemp(path);
+    REQUIRE(writer >= 0);
+    close(writer);
+    rewrite(path, "41000\n");
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    REQUIRE(fd >= 0);
+    long v = 0;
+    CHECK(sensor_pread_long(fd, &v) == 1 && v == 41000);
+    CHECK(sensor_pread_long(fd, &v) == 1 && v == 41000);
+    rewrite(path, "52500\n");
+    CHECK(sensor_pread_long(fd, &v) == 1 && v == 52500);
+    errno = ENODEV; // Stale errno of an earlier, unrelated call
+    rewrite(path, "");
+    CHECK(sensor_pread_long(fd, &v) == 0 && errno == EIO);
+    CHECK(!sensor_read_needs_reopen());
+    errno = ESTALE;
+    rewrite(path, "n/a\n");
+    CHECK(sensor_pread_long(fd, &v) == 0 && errno == EIO);
+    CHECK(!sensor_read_needs_reopen());
+    close(fd);
+    unlink(path);
+
+    errno = 0;
+    CHECK(sensor_pread_long(-1, &v) == 0 && errno == EBADF);
+    CHECK(!sensor_read_needs_reopen());
+    errno = ENODEV;
+    CHECK(sensor_read_needs_reopen());
+    errno = ESTALE;
+    CHECK(sensor_read_needs_reopen());
+}
+
+/**
+ * @brief Run all sensor_reader tests.
+ * @details Exit status is 0 if all checks passed.
+ * @example
+ *     ./build/tests/test_sensor_reader
+ */
+int main(void) {
+    test_parse();
+    test_pread();
+    return test_finish("sensor_reader");
+}
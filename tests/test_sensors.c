@@ -0,0 +1,155 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the hwmon sensor registry.
+ * @details Builds a fake hwmon tree under /tmp (two chips with labelled and unlabelled inputs) and points hwmon_path at it. pread() is interposed to count the reads of a sampling pass.
+ * @example
+ *     make test
+ */
+
+// Enable RTLD_NEXT, mkdtemp(), openat() and ftruncate()
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/sensors.h"
+#include "test.h"
+
+// Include necessary headers
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Root of the fake hwmon tree
+static char root[] = "/tmp/coolerdash-hwmon-XXXXXX";
+
+// pread() calls made by the code under test
+static int pread_calls = 0;
+
+/**
+ * @brief Counting wrapper of pread().
+ * @details Forwards to the C library.
+ * @example
+ *     // Called by sensor_pread_long().
+ */
+ssize_t pread(int fd, void *buf, size_t count, off_t offset) {
+    ssize_t (*real_pread)(int, void *, size_t, off_t) = (ssize_t (*)(int, void *, size_t, off_t))dlsym(RTLD_NEXT, "pread");
+    ++pread_calls;
+    return real_pread(fd, buf, count, offset);
+}
+
+/**
+ * @brief Write a file of the fake hwmon tree.
+ * @details Keeps the inode of an existing file, so open descriptors see the new value.
+ * @example
+ *     put("hwmon0/temp1_input", "45000\n");
+ */
+static void put(const char *name, const char *text) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", root, name);
+    int fd = open(path, O_WRONLY | O_CREAT, 0644);
+    REQUIRE(fd >= 0);
+    REQUIRE(pwrite(fd, text, strlen(text), 0) == (ssize_t)strlen(text));
+    REQUIRE(ftruncate(fd, (off_t)strlen(text)) == 0);
+    close(fd);
+}
+
+/**
+ * @brief Create the fake hwmon tree.
+ * @details hwmon0 is a CPU chip with a labelled package temperature and a fan; hwmon1 an AIO whose coolant input has no label file.
+ * @example
+ *     build_tree();
+ */
+static void build_tree(void) {
+    char path[256];
+    REQUIRE(mkdtemp(root) != NULL);
+    snprintf(path, sizeof(path), "%s/hwmon0", root);
+    REQUIRE(mkdir(path, 0755) == 0);
+    snprintf(path, sizeof(path), "%s/hwmon1", root);
+    REQUIRE(mkdir(path, 0755) == 0);
+    put("hwmon0/name", "coretemp\n");
+    put("hwmon0/temp1_input", "48000\n");
+    put("hwmon0/temp1_label", "Package id 0\n");
+    put("hwmon0/temp2_input", "46000\n");
+    put("hwmon0/temp2_label", "Core 0\n");
+    put("hwmon0/temp1_crit", "100000\n"); // Not an input
+    put("hwmon0/fan1_input", "1200\n");
+    put("hwmon1/name", "coolant\n");
+    put("hwmon1/temp1_input", "31500\n");
+}
+
+/**
+ * @brief Check discovery, lookup and sampling.
+ * @details Values are rewritten in place between samples, as sysfs does.
+ * @example
+ *     test_registry();
+ */
+static void test_registry(void) {
+    Config config;
+    memset(&config, 0, sizeof(config));
+    snprintf(config.hwmon_path, sizeof(config.hwmon_path), "%s", root);
+    CHECK(sensors_init(&config) == 4);
+    CHECK(sensors_count() == 4);
+
+    int package = sensors_find(SENSOR_KIND_TEMP, "package id 0");
+    int coolant = sensors_find(SENSOR_KIND_TEMP, "coolant");
+    int fan = sensors_find(SENSOR_KIND_FAN, "");
+    CHECK(package >= 0 && coolant >= 0 && fan >= 0);
+    CHECK(strcmp(sensors_label(package), "Package id 0") == 0);
+    CHECK(sensors_label(coolant)[0] == '\0'); // Matched by chip name
+    CHECK(sensors_find(SENSOR_KIND_TEMP, "missing") == -1);
+
+    long raw = 0;
+    CHECK(sensors_read(package, &raw) && raw == 48000);
+    CHECK(sensors_temp_celsius(raw) == 48.0f);
+    put("hwmon0/temp1_input", "55000\n");
+    CHECK(sensors_read(package, &raw) && raw == 55000);
+    put("hwmon1/temp1_input", "");
+    CHECK(!sensors_read(coolant, &raw));
+    put("hwmon1/temp1_input", "32000\n");
+    CHECK(sensors_read(coolant, &raw) && raw == 32000);
+
+    static sensors_snapshot_t snapshot;
+    pread_calls = 0;
+    CHECK(sensors_sample_all(&snapshot) == 0); // Nothing watched: nothing read
+    CHECK(pread_calls == 0);
+    CHECK(!sensors_watch(-1) && !sensors_watch(4));
+    CHECK(sensors_watch(package) && sensors_watch(coolant) && sensors_watch(package));
+    pread_calls = 0;
+    CHECK(sensors_sample_all(&snapshot) == 2);
+    CHECK(pread_calls == 2); // One per watched sensor, none for the fan and Core 0
+    CHECK(snapshot.count == 4 && snapshot.timestamp_ns > 0);
+    CHECK(snapshot.valid[package] && snapshot.value[package] == 55000);
+    CHECK(snapshot.valid[coolant] && snapshot.value[coolant] == 32000);
+    CHECK(!snapshot.valid[fan]);
+
+    sensors_cleanup();
+    CHECK(sensors_count() == 0);
+    CHECK(sensors_init(&config) == 4); // Rescan after cleanup
+    pread_calls = 0;
+    CHECK(sensors_sample_all(&snapshot) == 0); // Watch list cleared with the registry
+    CHECK(pread_calls == 0);
+    sensors_cleanup();
+}
+
+/**
+ * @brief Run all sensor registry tests.
+ * @details Removes the fake tree afterwards.
+ * @example
+ *     ./build/tests/test_sensors
+ */
+int main(void) {
+    build_tree();
+    test_registry();
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf %s", root);
+    if (system(command) != 0) fprintf(stderr, "  could not remove %s\n", root);
+    return test_finish("sensors");
+}
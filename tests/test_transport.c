@@ -0,0 +1,116 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the TCP and Unix domain socket transports against the mock CoolerControl server.
+ * @details Uploads a series of frames and checks with the engine counters that the connections are kept alive: the number of new connections must not grow with the number of requests. Each transport runs in a fresh copy of this program, because the session is per process.
+ * @example
+ *     make test
+ */
+
+// Enable nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/http_engine.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Frames uploaded per transport
+#define FRAMES 25
+
+// Mock port of the TCP scenario
+#define PORT 18131
+
+// Socket of the Unix domain socket scenario
+#define SOCKET_PATH "/tmp/coolerdash-test-transport.sock"
+
+// Connections the session opens at most: login, /devices and the device's upload handle
+#define MAX_CONNECTIONS 3
+
+// Configuration of the session (must outlive it)
+static Config config;
+
+// Fake frame: only the PNG signature is checked by the mock
+static const unsigned char frame[4096] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/**
+ * @brief Upload FRAMES frames over one transport.
+ * @details unix_socket selects the Unix domain socket; the URL then still names a host, as with [daemon] socket.
+ * @example
+ *     scenario(1);
+ */
+static void scenario(int unix_socket) {
+    pid_t mock = unix_socket ? mock_start_unix(SOCKET_PATH, NULL) : mock_start(PORT, NULL);
+    REQUIRE(mock > 0);
+    if (unix_socket) {
+        snprintf(config.daemon_address, sizeof(config.daemon_address), "http://localhost:11987");
+        snprintf(config.daemon_socket, sizeof(config.daemon_socket), "%s", SOCKET_PATH);
+    } else {
+        snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", PORT);
+    }
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 1;
+    config.lcd_brightness = 80;
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(refresh_device_index(&config) == 1);
+
+    int delivered = 0;
+    for (int i = 0; i < FRAMES; ++i) delivered += send_image_data_to_lcd(&config, frame, sizeof(frame), "mock-lcd-1");
+    CHECK(delivered == FRAMES);
+
+    http_engine_stats_t stats;
+    http_engine_get_stats(&stats);
+    CHECK(stats.requests >= FRAMES + 2);
+    CHECK(stats.new_connections <= MAX_CONNECTIONS);
+    CHECK(stats.reused >= stats.requests - MAX_CONNECTIONS);
+    printf("  %s: %llu requests, %llu new connections, %llu reused\n",
+           unix_socket ? "unix" : "tcp", stats.requests, stats.new_connections, stats.reused);
+
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+}
+
+/**
+ * @brief Run one transport in a fresh process.
+ * @details Returns 1 if the scenario passed.
+ * @example
+ *     run_scenario("tcp");
+ */
+static int run_scenario(const char *name) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/proc/self/exe", "test_transport", name, (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return 0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Run both transports.
+ * @details Without arguments each transport is run in its own process; with "tcp" or "unix" only that one runs in this process.
+ * @example
+ *     ./build/tests/test_transport
+ */
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "tcp") == 0) scenario(0);
+        else if (strcmp(argv[1], "unix") == 0) scenario(1);
+        else CHECK(!"unknown scenario");
+        return test_finish(argv[1]);
+    }
+    CHECK(run_scenario("tcp"));
+    CHECK(run_scenario("unix"));
+    return test_finish("transport");
+}
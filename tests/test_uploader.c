@@ -0,0 +1,185 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Tests of the upload worker counters against the mock CoolerControl server.
+ * @details Every taken frame must end up in exactly one of uploaded, failed and not sent. Each scenario runs in a fresh copy of this program, because the counters and the session are per process.
+ * @example
+ *     make test
+ */
+
+// Enable nanosleep() and the socket helpers of mock_server.h
+#define _GNU_SOURCE
+
+// Include project headers
+#include "../include/coolercontrol.h"
+#include "../include/http_engine.h"
+#include "../include/uploader.h"
+#include "mock_server.h"
+#include "test.h"
+
+// Include necessary headers
+#include <string.h>
+
+// Frames submitted per scenario
+#define FRAMES 5
+
+// Mock port of the first scenario; each scenario uses its own
+#define BASE_PORT 18111
+
+// Configuration of the session and the worker (must outlive both)
+static Config config;
+
+// Fake frame: only the PNG signature is checked by the mock
+static const unsigned char frame[64] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+/**
+ * @brief Sleep for a number of milliseconds.
+ * @details Paces the frames like the render timer does.
+ * @example
+ *     sleep_ms(50);
+ */
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Fill the configuration for a mock on port.
+ * @details One second refresh interval, so every delivery has a one second budget.
+ * @example
+ *     setup_config(BASE_PORT);
+ */
+static void setup_config(int port) {
+    memset(&config, 0, sizeof(config));
+    snprintf(config.daemon_address, sizeof(config.daemon_address), "http://127.0.0.1:%d", port);
+    snprintf(config.daemon_password, sizeof(config.daemon_password), "coolAdmin");
+    config.display_refresh_interval_sec = 1;
+    config.lcd_brightness = 80;
+}
+
+/**
+ * @brief Submit FRAMES frames and wait until all of them were handled.
+ * @details Returns the final counters. A frame is handled once it was superseded, or taken and counted as uploaded, failed or not sent.
+ * @example
+ *     uploader_stats_t stats = submit_and_wait(5000);
+ */
+static uploader_stats_t submit_and_wait(long timeout_ms) {
+    uploader_stats_t stats;
+    for (int i = 0; i < FRAMES; ++i) {
+        CHECK(uploader_submit(&config, "mock-lcd-1", frame, sizeof(frame)) == 1);
+        sleep_ms(60);
+    }
+    for (long waited = 0; waited <= timeout_ms; waited += 20) {
+        uploader_get_stats(&stats);
+        if (stats.submitted - stats.superseded == stats.taken &&
+            stats.taken == stats.uploaded + stats.failed + stats.not_sent) break;
+        sleep_ms(20);
+    }
+    uploader_get_stats(&stats);
+    CHECK(stats.submitted == FRAMES);
+    CHECK(stats.taken == stats.submitted - stats.superseded);
+    CHECK(stats.taken == stats.uploaded + stats.failed + stats.not_sent);
+    return stats;
+}
+
+/**
+ * @brief Healthy daemon.
+ * @details Every taken frame is uploaded.
+ * @example
+ *     scenario_ok();
+ */
+static void scenario_ok(void) {
+    int port = BASE_PORT;
+    pid_t mock = mock_start(port, NULL);
+    REQUIRE(mock > 0);
+    setup_config(port);
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(uploader_start() == 1);
+    uploader_stats_t stats = submit_and_wait(3000);
+    CHECK(stats.taken > 0 && stats.uploaded == stats.taken);
+    CHECK(stats.failed == 0 && stats.not_sent == 0);
+    uploader_stop();
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+}
+
+/**
+ * @brief Daemon answering every upload with HTTP 500.
+ * @details Nothing is counted as uploaded; frames fail or are not sent once the link is considered down.
+ * @example
+ *     scenario_errors();
+ */
+static void scenario_errors(void) {
+    int port = BASE_PORT + 1;
+    pid_t mock = mock_start(port, (const char *[]){ "-e", "100", NULL });
+    REQUIRE(mock > 0);
+    setup_config(port);
+    REQUIRE(init_coolercontrol_session(&config) == 1);
+    REQUIRE(uploader_start() == 1);
+    uploader_stats_t stats = submit_and_wait(8000);
+    CHECK(stats.uploaded == 0);
+    CHECK(stats.failed >= 1);
+    uploader_stop();
+    cleanup_coolercontrol_session();
+    CHECK(mock_stop(mock));
+}
+
+/**
+ * @brief No session.
+ * @details The worker runs on the HTTP engine, but no delivery can be started: every taken frame is counted as not sent.
+ * @example
+ *     scenario_no_session();
+ */
+static void scenario_no_session(void) {
+    setup_config(BASE_PORT + 2);
+    REQUIRE(http_engine_init() == 1);
+    REQUIRE(uploader_start() == 1);
+    uploader_stats_t stats = submit_and_wait(3000);
+    CHECK(stats.taken > 0 && stats.not_sent == stats.taken);
+    CHECK(stats.uploaded == 0 && stats.failed == 0);
+    uploader_stop();
+    http_engine_cleanup();
+}
+
+/**
+ * @brief Run one scenario in a fresh process.
+ * @details Returns 1 if the scenario passed.
+ * @example
+ *     run_scenario("ok");
+ */
+static int run_scenario(const char *name) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/proc/self/exe", "test_uploader", name, (char *)NULL);
+        _exit(127);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return 0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * @brief Run all upload worker scenarios.
+ * @details Without arguments every scenario is run in its own process; with a scenario name only that one runs in this process.
+ * @example
+ *     ./build/tests/test_uploader
+ */
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        if (strcmp(argv[1], "ok") == 0) scenario_ok();
+        else if (strcmp(argv[1], "errors") == 0) scenario_errors();
+        else if (strcmp(argv[1], "no-session") == 0) scenario_no_session();
+        else CHECK(!"unknown scenario");
+        return test_finish(argv[1]);
+    }
+    CHECK(run_scenario("ok"));
+    CHECK(run_scenario("errors"));
+    CHECK(run_scenario("no-session"));
+    return test_finish("uploader");
+}
@@ -0,0 +1,960 @@
+/*
+ * @author damachine (christkue79@gmail.com)
+ * @website https://github.com/damachine
+ * @copyright (c) 2025 damachine
+ * @license MIT
+ * @version 1.0
+ */
+
+/**
+ * @brief Local mock of the CoolerControl daemon API.
+ * @details Stand-in for coolercontrold so the CoolerDash client can be run, tested and benchmarked without hardware. Implements POST /login (basic authentication, session cookie), GET /devices, GET /health and PUT /devices/{uid}/settings/{channel}/lcd/images with multipart validation. Latency, 5xx errors, dropped connections and session expiry can be injected; received PNGs can be recorded to a directory, and /devices can be served from a recorded response. One thread per connection, HTTP/1.1 keep-alive, listens on 127.0.0.1 only, or on a Unix domain socket with -u. Prints request statistics on SIGINT/SIGTERM.
+ * @example
+ *     coolercontrol-mock -p 11987 -n 2 -l 20 -e 5 -r /tmp/frames
+ *     coolercontrol-mock -u /tmp/coolercontrol.sock
+ */
+
+// Enable pthread, getopt() and clock_gettime()
+#define _POSIX_C_SOURCE 200809L
+
+// Defaults matching a local coolercontrold
+#define MOCK_DEFAULT_PORT      11987
+#define MOCK_DEFAULT_PASSWORD  "coolAdmin"
+#define MOCK_DEFAULT_MAX_IMAGE 1000000L
+
+// Reported LCD geometry of every mock device
+#define MOCK_LCD_SIZE 320
+
+// Upper bound of -n
+#define MOCK_MAX_DEVICES 8
+
+// Request head buffer (request line and headers)
+#define MOCK_HEAD_SIZE 16384
+
+// Multipart overhead accepted on top of the maximum image size
+#define MOCK_BODY_OVERHEAD 65536
+
+// Idle keep-alive connections are closed after this many seconds
+#define MOCK_IDLE_TIMEOUT_SEC 60
+
+// Session cookie name and token length
+#define MOCK_COOKIE_NAME "cc_session"
+#define MOCK_TOKEN_SIZE  33
+
+// Include necessary headers
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/time.h>
+
+/**
+ * @brief Command line options.
+ * @details Filled by parse_options(); read-only once the server runs.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int port;                 // Listen port on 127.0.0.1
+    const char *socket_path;  // Unix domain socket to listen on instead (NULL = TCP)
+    const char *password;     // Expected CCAdmin password
+    int device_count;         // LCD devices reported by /devices
+    long latency_ms;          // Delay before answering an image upload
+    long jitter_ms;           // Random extra delay (0..jitter_ms)
+    int error_percent;        // Uploads answered with 500
+    int drop_percent;         // Uploads dropped without response
+    long expire_after;        // Uploads per session before it expires (0 = never)
+    long max_image_size;      // Largest accepted images[] payload
+    const char *record_dir;   // Directory for received PNGs (NULL = off)
+    const char *devices_file; // Recorded /devices response to serve (NULL = generated)
+    unsigned int seed;        // Random seed for injected faults
+} mock_options_t;
+
+/**
+ * @brief Request counters printed at shutdown.
+ * @details Updated under state_lock.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    unsigned long long connections;     // Accepted connections
+    unsigned long long logins;          // Accepted logins
+    unsigned long long login_failures;  // Logins with wrong credentials
+    unsigned long long device_lists;    // GET /devices answered
+    unsigned long long health;          // GET /health answered
+    unsigned long long images;          // Images accepted
+    unsigned long long image_bytes;     // Payload bytes of accepted images
+    unsigned long long injected_errors; // Uploads answered with 500
+    unsigned long long dropped;         // Uploads dropped without response
+    unsigned long long unauthorized;    // Requests rejected with 401
+    unsigned long long invalid;         // Requests rejected with 4xx (other than 401)
+    unsigned long long expired;         // Sessions expired by -x
+    unsigned long long recorded;        // PNGs written by -r
+} mock_stats_t;
+
+/**
+ * @brief One parsed HTTP request.
+ * @details Header values point into the connection's head buffer; body is heap-allocated.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    char *method;            // Request method
+    char *path;              // Request target
+    const char *content_type; // Content-Type header or NULL
+    const char *cookie;      // Cookie header or NULL
+    const char *authorization; // Authorization header or NULL
+    long content_length;     // Content-Length (0 if absent)
+    int expect_continue;     // Expect: 100-continue
+    int close;               // Connection: close
+    int chunked;             // Transfer-Encoding present (unsupported)
+    char *body;              // Request body (content_length bytes)
+} mock_request_t;
+
+/**
+ * @brief Per-connection state.
+ * @details buf holds bytes read past the end of the previous request (keep-alive pipelining). The head of the current request is copied to head before parsing, so the parsed header pointers survive consuming buf.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    int fd;                     // Client socket
+    char buf[MOCK_HEAD_SIZE];   // Read buffer
+    char head[MOCK_HEAD_SIZE];  // Head of the current request, parsed in place
+    size_t len;                 // Bytes in buf
+    unsigned int rng;           // Per-connection random state
+} mock_conn_t;
+
+static mock_options_t options = {
+    .port = MOCK_DEFAULT_PORT,
+    .socket_path = NULL,
+    .password = MOCK_DEFAULT_PASSWORD,
+    .device_count = 1,
+    .latency_ms = 0,
+    .jitter_ms = 0,
+    .error_percent = 0,
+    .drop_percent = 0,
+    .expire_after = 0,
+    .max_image_size = MOCK_DEFAULT_MAX_IMAGE,
+    .record_dir = NULL,
+    .devices_file = NULL,
+    .seed = 0
+};
+
+static pthread_mutex_t state_lock = PTHREAD_MUTEX_INITIALIZER;
+static mock_stats_t stats;                  // Protected by state_lock
+static char session_token[MOCK_TOKEN_SIZE]; // Current session ("" = nobody logged in), protected by state_lock
+static long session_uploads = 0;            // Uploads in the current session, protected by state_lock
+static unsigned long long record_seq = 0;   // File name counter for -r, protected by state_lock
+static unsigned int token_rng = 0;          // Token generator state, protected by state_lock
+static volatile sig_atomic_t running = 1;   // Cleared by SIGINT/SIGTERM
+static char *devices_body = NULL;           // Contents of -D (read-only once the server runs)
+static size_t devices_body_len = 0;         // Bytes in devices_body
+
+/**
+ * @brief Small linear congruential generator.
+ * @details Deterministic for a given seed; good enough for fault injection.
+ * @example
+ *     int roll = (int)(next_random(&conn->rng) % 100);
+ */
+static unsigned int next_random(unsigned int *state) {
+    *state = *state * 1103515245u + 12345u;
+    return (*state >> 8) & 0xffffff;
+}
+
+/**
+ * @brief Return 1 with the given probability in percent.
+ * @details Used for -e and -d.
+ * @example
+ *     if (roll_percent(&conn->rng, options.error_percent)) { ... }
+ */
+static int roll_percent(unsigned int *state, int percent) {
+    return percent > 0 && (int)(next_random(state) % 100) < percent;
+}
+
+/**
+ * @brief Signal handler stopping the accept loop.
+ * @details Only clears running; statistics are printed by main().
+ * @example
+ *     sigaction(SIGINT, &sa, NULL);
+ */
+static void handle_signal(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+/**
+ * @brief Write a buffer completely.
+ * @details Retries on short writes and EINTR. Returns 1 on success, 0 on failure.
+ * @example
+ *     write_all(fd, data, len);
+ */
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        data += n;
+        len -= (size_t)n;
+    }
+    return 1;
+}
+
+/**
+ * @brief Send a complete HTTP response.
+ * @details extra_headers is inserted verbatim (each line ending in \r\n) and may be NULL. Returns 1 on success, 0 on failure.
+ * @example
+ *     send_response(fd, 200, "OK", "application/json", NULL, body, strlen(body), 0);
+ */
+static int send_response(int fd, int code, const char *reason, const char *content_type, const char *extra_headers, const char *body, size_t body_len, int close_after) {
+    char head[512];
+    int n = snprintf(head, sizeof(head),
+                     "HTTP/1.1 %d %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Content-Length: %zu\r\n"
+                     "%s"
+                     "%s"
+                     "\r\n",
+                     code, reason, content_type, body_len,
+                     extra_headers ? extra_headers : "",
+                     close_after ? "Connection: close\r\n" : "");
+    if (n < 0 || (size_t)n >= sizeof(head)) return 0;
+    return write_all(fd, head, (size_t)n) && (body_len == 0 || write_all(fd, body, body_len));
+}
+
+/**
+ * @brief Send a JSON error response in the daemon's format.
+ * @details Body is {"error":"<message>"}. Counts the rejection. Returns 1 on success, 0 on failure.
+ * @example
+ *     send_error(conn->fd, 404, "Not Found", "unknown device", 0);
+ */
+static int send_error(int fd, int code, const char *reason, const char *message, int close_after) {
+    char body[256];
+    int n = snprintf(body, sizeof(body), "{\"error\":\"%s\"}", message);
+    if (n < 0 || (size_t)n >= sizeof(body)) n = (int)sizeof(body) - 1;
+    pthread_mutex_lock(&state_lock);
+    if (code == 401) stats.unauthorized++;
+    else if (code >= 400 && code < 500) stats.invalid++;
+    pthread_mutex_unlock(&state_lock);
+    return send_response(fd, code, reason, "application/json", NULL, body, (size_t)n, close_after);
+}
+
+/**
+ * @brief Decode standard base64.
+ * @details Stops at the first padding or invalid character; out is NUL-terminated. Returns the number of decoded bytes.
+ * @example
+ *     size_t n = base64_decode("Q0NBZG1pbjp4", out, sizeof(out));
+ */
+static size_t base64_decode(const char *in, char *out, size_t out_size) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    unsigned int acc = 0;
+    int bits = 0;
+    size_t len = 0;
+    for (; *in && *in != '=' && *in != '\r' && *in != ' '; ++in) {
+        const char *p = strchr(alphabet, *in);
+        if (!p) break;
+        acc = (acc << 6) | (unsigned int)(p - alphabet);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (len + 1 < out_size) out[len++] = (char)((acc >> bits) & 0xff);
+        }
+    }
+    if (out_size) out[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Return the value of a header line if it has the given name.
+ * @details Case-insensitive name match; leading blanks of the value are skipped. Returns NULL if the name does not match.
+ * @example
+ *     const char *value = header_value(line, "Content-Length");
+ */
+static const char *header_value(const char *line, const char *name) {
+    size_t name_len = strlen(name);
+    if (strncasecmp(line, name, name_len) != 0 || line[name_len] != ':') return NULL;
+    const char *value = line + name_len + 1;
+    while (*value == ' ' || *value == '\t') value++;
+    return value;
+}
+
+/**
+ * @brief Read until the connection buffer holds a complete request head.
+ * @details Returns the length of the head including the blank line, 0 on EOF/timeout/error and -1 if the head does not fit the buffer.
+ * @example
+ *     long head_len = read_head(conn);
+ */
+static long read_head(mock_conn_t *conn) {
+    for (;;) {
+        if (conn->len >= 4) {
+            for (size_t i = 0; i + 3 < conn->len; ++i) {
+                if (memcmp(conn->buf + i, "\r\n\r\n", 4) == 0) return (long)(i + 4);
+            }
+        }
+        if (conn->len >= sizeof(conn->buf) - 1) return -1;
+        ssize_t n = recv(conn->fd, conn->buf + conn->len, sizeof(conn->buf) - 1 - conn->len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        conn->len += (size_t)n;
+    }
+}
+
+/**
+ * @brief Parse the request line and headers in place.
+ * @details Terminates lines inside head; pointers in req point into it. Returns 1 on success, 0 on a malformed head.
+ * @example
+ *     if (!parse_head(conn->head, head_len, &req)) { ... }
+ */
+static int parse_head(char *head, long head_len, mock_request_t *req) {
+    memset(req, 0, sizeof(*req));
+    head[head_len - 2] = '\0'; // Cut before the final CRLF
+    char *line = head;
+    char *end = strstr(line, "\r\n");
+    if (end) *end = '\0';
+    req->method = strtok(line, " ");
+    req->path = strtok(NULL, " ");
+    const char *version = strtok(NULL, " ");
+    if (!req->method || !req->path || !version || strncmp(version, "HTTP/1.", 7) != 0) return 0;
+    if (strcmp(version, "HTTP/1.0") == 0) req->close = 1;
+    while (end) {
+        line = end + 2;
+        end = strstr(line, "\r\n");
+        if (end) *end = '\0';
+        const char *value;
+        if ((value = header_value(line, "Content-Length"))) req->content_length = atol(value);
+        else if ((value = header_value(line, "Content-Type"))) req->content_type = value;
+        else if ((value = header_value(line, "Cookie"))) req->cookie = value;
+        else if ((value = header_value(line, "Authorization"))) req->authorization = value;
+        else if ((value = header_value(line, "Expect"))) req->expect_continue = strcasecmp(value, "100-continue") == 0;
+        else if ((value = header_value(line, "Connection"))) req->close = strcasecmp(value, "close") == 0;
+        else if (header_value(line, "Transfer-Encoding")) req->chunked = 1;
+    }
+    return req->content_length >= 0;
+}
+
+/**
+ * @brief Read the request body after the head.
+ * @details Uses bytes already buffered first and leaves bytes of a pipelined next request in the buffer. Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!read_body(conn, head_len, &req)) { ... }
+ */
+static int read_body(mock_conn_t *conn, long head_len, mock_request_t *req) {
+    size_t want = (size_t)req->content_length;
+    req->body = malloc(want + 1);
+    if (!req->body) return 0;
+    size_t buffered = conn->len - (size_t)head_len;
+    size_t take = buffered < want ? buffered : want;
+    memcpy(req->body, conn->buf + head_len, take);
+    memmove(conn->buf, conn->buf + head_len + take, buffered - take);
+    conn->len = buffered - take;
+    size_t have = take;
+    while (have < want) {
+        ssize_t n = recv(conn->fd, req->body + have, want - have, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        have += (size_t)n;
+    }
+    req->body[want] = '\0';
+    return 1;
+}
+
+/**
+ * @brief Check the session cookie against the current session.
+ * @details Returns 1 if the Cookie header carries the current token.
+ * @example
+ *     if (!has_session(&req)) return send_error(fd, 401, "Unauthorized", "login required", 0);
+ */
+static int has_session(const mock_request_t *req) {
+    if (!req->cookie) return 0;
+    const char *p = strstr(req->cookie, MOCK_COOKIE_NAME "=");
+    if (!p) return 0;
+    p += strlen(MOCK_COOKIE_NAME "=");
+    size_t len = strcspn(p, "; ");
+    pthread_mutex_lock(&state_lock);
+    int ok = session_token[0] && len == strlen(session_token) && strncmp(p, session_token, len) == 0;
+    pthread_mutex_unlock(&state_lock);
+    return ok;
+}
+
+/**
+ * @brief Handle POST /login.
+ * @details Accepts basic authentication as CCAdmin with the configured password and starts a new session, invalidating the previous token. Returns 1 to keep the connection, 0 to close it.
+ * @example
+ *     return handle_login(conn, &req);
+ */
+static int handle_login(mock_conn_t *conn, const mock_request_t *req) {
+    char expected[256];
+    char decoded[256] = {0};
+    snprintf(expected, sizeof(expected), "CCAdmin:%s", options.password);
+    if (req->authorization && strncasecmp(req->authorization, "Basic ", 6) == 0) {
+        base64_decode(req->authorization + 6, decoded, sizeof(decoded));
+    }
+    if (strcmp(decoded, expected) != 0) {
+        pthread_mutex_lock(&state_lock);
+        stats.login_failures++;
+        pthread_mutex_unlock(&state_lock);
+        return send_error(conn->fd, 401, "Unauthorized", "invalid credentials", req->close) && !req->close;
+    }
+    char cookie[128];
+    pthread_mutex_lock(&state_lock);
+    for (int i = 0; i < MOCK_TOKEN_SIZE - 1; ++i) session_token[i] = "0123456789abcdef"[next_random(&token_rng) & 15];
+    session_token[MOCK_TOKEN_SIZE - 1] = '\0';
+    session_uploads = 0;
+    stats.logins++;
+    snprintf(cookie, sizeof(cookie), "Set-Cookie: " MOCK_COOKIE_NAME "=%s; Path=/; HttpOnly\r\n", session_token);
+    pthread_mutex_unlock(&state_lock);
+    return send_response(conn->fd, 200, "OK", "application/json", cookie, "", 0, req->close) && !req->close;
+}
+
+/**
+ * @brief Handle GET /devices.
+ * @details Reports a fan hub without LCD followed by device_count LCD devices (mock-lcd-1, ...) with channel "lcd", or the recorded response given with -D. Returns 1 to keep the connection, 0 to close it.
+ * @example
+ *     return handle_devices(conn, &req);
+ */
+static int handle_devices(mock_conn_t *conn, const mock_request_t *req) {
+    if (devices_body) {
+        pthread_mutex_lock(&state_lock);
+        stats.device_lists++;
+        pthread_mutex_unlock(&state_lock);
+        return send_response(conn->fd, 200, "OK", "application/json", NULL, devices_body, devices_body_len, req->close) && !req->close;
+    }
+    char body[4096];
+    size_t len = (size_t)snprintf(body, sizeof(body),
+                                  "{\"devices\":[{\"uid\":\"mock-hub\",\"type\":\"Liquidctl\",\"type_index\":1,\"name\":\"Mock Fan Hub\","
+                                  "\"info\":{\"channels\":{\"fan1\":{\"lcd_info\":null}}}}");
+    for (int i = 1; i <= options.device_count && len < sizeof(body); ++i) {
+        len += (size_t)snprintf(body + len, sizeof(body) - len,
+                                ",{\"uid\":\"mock-lcd-%d\",\"type\":\"Liquidctl\",\"type_index\":%d,\"name\":\"Mock LCD %d\","
+                                "\"info\":{\"channels\":{\"lcd\":{\"lcd_info\":{\"screen_width\":%d,\"screen_height\":%d,\"max_image_size_bytes\":%ld}}}}}",
+                                i, i + 1, i, MOCK_LCD_SIZE, MOCK_LCD_SIZE, options.max_image_size);
+    }
+    if (len < sizeof(body)) len += (size_t)snprintf(body + len, sizeof(body) - len, "]}");
+    if (len >= sizeof(body)) {
+        send_error(conn->fd, 500, "Internal Server Error", "device list too long", 1);
+        return 0;
+    }
+    pthread_mutex_lock(&state_lock);
+    stats.device_lists++;
+    pthread_mutex_unlock(&state_lock);
+    return send_response(conn->fd, 200, "OK", "application/json", NULL, body, len, req->close) && !req->close;
+}
+
+/**
+ * @brief Find a byte sequence in a buffer.
+ * @details memmem() is a GNU extension, so it is not used under C99/POSIX. Returns NULL if not found.
+ * @example
+ *     const char *p = find_bytes(body, len, "\r\n\r\n", 4);
+ */
+static const char *find_bytes(const char *haystack, size_t haystack_len, const char *needle, size_t needle_len) {
+    if (needle_len == 0 || haystack_len < needle_len) return NULL;
+    for (size_t i = 0; i + needle_len <= haystack_len; ++i) {
+        if (haystack[i] == needle[0] && memcmp(haystack + i, needle, needle_len) == 0) return haystack + i;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Parsed multipart upload form.
+ * @details Pointers reference the request body.
+ * @example
+ *     // Not intended for direct use.
+ */
+typedef struct {
+    char mode[16];            // "image"
+    int brightness;           // 0..100 (-1 = missing)
+    int orientation;          // 0, 90, 180 or 270 (-1 = missing)
+    const char *image;        // images[] payload
+    size_t image_size;        // Bytes in image
+} mock_form_t;
+
+/**
+ * @brief Parse and validate the multipart/form-data body of an image upload.
+ * @details Requires mode=image, brightness 0..100, orientation 0/90/180/270 and exactly one images[] part starting with the PNG signature. Stores a description of the first problem in *error. Returns 1 if the form is valid, 0 otherwise.
+ * @example
+ *     if (!parse_form(&req, &form, &error)) { ... }
+ */
+static int parse_form(const mock_request_t *req, mock_form_t *form, const char **error) {
+    memset(form, 0, sizeof(*form));
+    form->brightness = -1;
+    form->orientation = -1;
+    const char *boundary = req->content_type ? strstr(req->content_type, "boundary=") : NULL;
+    if (!req->content_type || strncasecmp(req->content_type, "multipart/form-data", 19) != 0 || !boundary) {
+        *error = "expected multipart/form-data";
+        return 0;
+    }
+    char delimiter[128];
+    boundary += 9;
+    size_t boundary_len = strcspn(boundary, "; \r");
+    if (*boundary == '"') boundary_len = strcspn(++boundary, "\"");
+    int delimiter_len = snprintf(delimiter, sizeof(delimiter), "\r\n--%.*s", (int)boundary_len, boundary);
+    if (boundary_len == 0 || delimiter_len < 0 || (size_t)delimiter_len >= sizeof(delimiter)) {
+        *error = "invalid multipart boundary";
+        return 0;
+    }
+    // The first delimiter has no leading CRLF
+    const char *body = req->body;
+    size_t body_len = (size_t)req->content_length;
+    if (body_len < (size_t)delimiter_len - 2 || memcmp(body, delimiter + 2, (size_t)delimiter_len - 2) != 0) {
+        *error = "missing multipart delimiter";
+        return 0;
+    }
+    const char *p = body + delimiter_len - 2;
+    int image_parts = 0;
+    for (;;) {
+        size_t remaining = body_len - (size_t)(p - body);
+        if (remaining >= 2 && memcmp(p, "--", 2) == 0) break; // Closing delimiter
+        if (remaining < 2 || memcmp(p, "\r\n", 2) != 0) {
+            *error = "malformed multipart delimiter";
+            return 0;
+        }
+        p += 2;
+        remaining -= 2;
+        const char *headers_end = find_bytes(p, remaining, "\r\n\r\n", 4);
+        if (!headers_end) {
+            *error = "unterminated part headers";
+            return 0;
+        }
+        const char *data = headers_end + 4;
+        const char *next = find_bytes(data, body_len - (size_t)(data - body), delimiter, (size_t)delimiter_len);
+        if (!next) {
+            *error = "unterminated part";
+            return 0;
+        }
+        size_t data_len = (size_t)(next - data);
+        char name[32] = {0};
+        const char *name_attr = find_bytes(p, (size_t)(headers_end - p), "name=\"", 6);
+        if (name_attr) {
+            name_attr += 6;
+            size_t name_len = strcspn(name_attr, "\"");
+            if (name_len < sizeof(name)) memcpy(name, name_attr, name_len);
+        }
+        char value[16] = {0};
+        if (data_len < sizeof(value)) memcpy(value, data, data_len);
+        if (strcmp(name, "mode") == 0) {
+            snprintf(form->mode, sizeof(form->mode), "%s", value);
+        } else if (strcmp(name, "brightness") == 0) {
+            form->brightness = data_len < sizeof(value) ? atoi(value) : -1;
+        } else if (strcmp(name, "orientation") == 0) {
+            form->orientation = data_len < sizeof(value) ? atoi(value) : -1;
+        } else if (strcmp(name, "images[]") == 0) {
+            form->image = data;
+            form->image_size = data_len;
+            image_parts++;
+        }
+        p = next + delimiter_len;
+    }
+    if (strcmp(form->mode, "image") != 0) *error = "mode must be image";
+    else if (form->brightness < 0 || form->brightness > 100) *error = "brightness must be 0-100";
+    else if (form->orientation != 0 && form->orientation != 90 && form->orientation != 180 && form->orientation != 270) *error = "orientation must be 0, 90, 180 or 270";
+    else if (image_parts != 1) *error = "expected exactly one images[] part";
+    else if (form->image_size < 8 || memcmp(form->image, "\x89PNG\r\n\x1a\n", 8) != 0) *error = "image is not a PNG";
+    else return 1;
+    return 0;
+}
+
+/**
+ * @brief Write a received PNG to the record directory.
+ * @details File names are <uid>-<sequence>.png with a global sequence, so the arrival order is kept across devices. Returns 1 on success, 0 on failure.
+ * @example
+ *     record_image(uid, form.image, form.image_size);
+ */
+static int record_image(const char *uid, const char *data, size_t size) {
+    pthread_mutex_lock(&state_lock);
+    unsigned long long seq = ++record_seq;
+    pthread_mutex_unlock(&state_lock);
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s-%06llu.png", options.record_dir, uid, seq);
+    FILE *file = fopen(path, "wb");
+    if (!file) return 0;
+    int ok = fwrite(data, 1, size, file) == size;
+    ok = fclose(file) == 0 && ok;
+    if (ok) {
+        pthread_mutex_lock(&state_lock);
+        stats.recorded++;
+        pthread_mutex_unlock(&state_lock);
+    }
+    return ok;
+}
+
+/**
+ * @brief Sleep for the configured upload latency plus jitter.
+ * @details Simulates the daemon pushing the frame to the device over USB.
+ * @example
+ *     apply_latency(&conn->rng);
+ */
+static void apply_latency(unsigned int *rng) {
+    long delay_ms = options.latency_ms;
+    if (options.jitter_ms > 0) delay_ms += (long)(next_random(rng) % (unsigned int)(options.jitter_ms + 1));
+    if (delay_ms <= 0) return;
+    struct timespec ts = { .tv_sec = delay_ms / 1000, .tv_nsec = (delay_ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+/**
+ * @brief Handle PUT /devices/{uid}/settings/{channel}/lcd/images.
+ * @details Checks the session, device, channel and form, then applies latency and the injected faults before accepting the image. Counts uploads per session for -x. Returns 1 to keep the connection, 0 to close it.
+ * @example
+ *     return handle_image(conn, &req, uid, channel);
+ */
+static int handle_image(mock_conn_t *conn, const mock_request_t *req, const char *uid, const char *channel) {
+    int device = 0;
+    if (strncmp(uid, "mock-lcd-", 9) == 0) device = atoi(uid + 9);
+    if (device < 1 || device > options.device_count) {
+        return send_error(conn->fd, 404, "Not Found", "unknown device", req->close) && !req->close;
+    }
+    if (strcmp(channel, "lcd") != 0) {
+        return send_error(conn->fd, 404, "Not Found", "unknown LCD channel", req->close) && !req->close;
+    }
+    mock_form_t form;
+    const char *error = NULL;
+    if (!parse_form(req, &form, &error)) {
+        return send_error(conn->fd, 400, "Bad Request", error, req->close) && !req->close;
+    }
+    if ((long)form.image_size > options.max_image_size) {
+        return send_error(conn->fd, 413, "Payload Too Large", "image exceeds max_image_size_bytes", req->close) && !req->close;
+    }
+    apply_latency(&conn->rng);
+    if (roll_percent(&conn->rng, options.drop_percent)) {
+        pthread_mutex_lock(&state_lock);
+        stats.dropped++;
+        pthread_mutex_unlock(&state_lock);
+        shutdown(conn->fd, SHUT_RDWR);
+        return 0;
+    }
+    if (roll_percent(&conn->rng, options.error_percent)) {
+        pthread_mutex_lock(&state_lock);
+        stats.injected_errors++;
+        pthread_mutex_unlock(&state_lock);
+        static const char body[] = "{\"error\":\"injected failure\"}";
+        return send_response(conn->fd, 500, "Internal Server Error", "application/json", NULL, body, sizeof(body) - 1, req->close) && !req->close;
+    }
+    if (options.record_dir && !record_image(uid, form.image, form.image_size)) {
+        fprintf(stderr, "coolercontrol-mock: could not record image to %s\n", options.record_dir);
+    }
+    pthread_mutex_lock(&state_lock);
+    stats.images++;
+    stats.image_bytes += form.image_size;
+    if (options.expire_after > 0 && ++session_uploads >= options.expire_after) {
+        session_token[0] = '\0'; // Next request gets 401 until the client logs in again
+        stats.expired++;
+    }
+    pthread_mutex_unlock(&state_lock);
+    return send_response(conn->fd, 200, "OK", "application/json", NULL, "", 0, req->close) && !req->close;
+}
+
+/**
+ * @brief Route one request.
+ * @details Returns 1 to keep the connection open, 0 to close it.
+ * @example
+ *     keep = handle_request(conn, &req);
+ */
+static int handle_request(mock_conn_t *conn, const mock_request_t *req) {
+    if (strcmp(req->path, "/health") == 0 && strcmp(req->method, "GET") == 0) {
+        static const char body[] = "{\"status\":\"ok\"}";
+        pthread_mutex_lock(&state_lock);
+        stats.health++;
+        pthread_mutex_unlock(&state_lock);
+        return send_response(conn->fd, 200, "OK", "application/json", NULL, body, sizeof(body) - 1, req->close) && !req->close;
+    }
+    if (strcmp(req->path, "/login") == 0 && strcmp(req->method, "POST") == 0) {
+        return handle_login(conn, req);
+    }
+    if (!has_session(req)) {
+        return send_error(conn->fd, 401, "Unauthorized", "login required", req->close) && !req->close;
+    }
+    if (strcmp(req->path, "/devices") == 0 && strcmp(req->method, "GET") == 0) {
+        return handle_devices(conn, req);
+    }
+    // /devices/{uid}/settings/{channel}/lcd/images
+    char uid[64], channel[64], tail[32];
+    if (strcmp(req->method, "PUT") == 0 &&
+        sscanf(req->path, "/devices/%63[^/]/settings/%63[^/]/%31s", uid, channel, tail) == 3 &&
+        strcmp(tail, "lcd/images") == 0) {
+        return handle_image(conn, req, uid, channel);
+    }
+    return send_error(conn->fd, 404, "Not Found", "unknown endpoint", req->close) && !req->close;
+}
+
+/**
+ * @brief Serve one client connection until it closes.
+ * @details Thread entry point; owns and frees the connection.
+ * @example
+ *     pthread_create(&thread, &attr, serve_connection, conn);
+ */
+static void *serve_connection(void *arg) {
+    mock_conn_t *conn = arg;
+    int keep = 1;
+    while (keep && running) {
+        long head_len = read_head(conn);
+        if (head_len == 0) break;
+        mock_request_t req;
+        if (head_len > 0) memcpy(conn->head, conn->buf, (size_t)head_len);
+        if (head_len < 0 || !parse_head(conn->head, head_len, &req)) {
+            send_error(conn->fd, 400, "Bad Request", "malformed request", 1);
+            break;
+        }
+        if (req.chunked) {
+            send_error(conn->fd, 411, "Length Required", "chunked bodies are not supported", 1);
+            break;
+        }
+        if (req.content_length > options.max_image_size + MOCK_BODY_OVERHEAD) {
+            send_error(conn->fd, 413, "Payload Too Large", "request body too large", 1);
+            break;
+        }
+        if (req.expect_continue) {
+            static const char cont[] = "HTTP/1.1 100 Continue\r\n\r\n";
+            if (!write_all(conn->fd, cont, sizeof(cont) - 1)) break;
+        }
+        if (!read_body(conn, head_len, &req)) {
+            free(req.body);
+            break;
+        }
+        keep = handle_request(conn, &req);
+        free(req.body);
+    }
+    close(conn->fd);
+    free(conn);
+    return NULL;
+}
+
+/**
+ * @brief Print the request statistics.
+ * @details Called once after the accept loop stopped.
+ * @example
+ *     print_stats();
+ */
+static void print_stats(void) {
+    pthread_mutex_lock(&state_lock);
+    mock_stats_t s = stats;
+    pthread_mutex_unlock(&state_lock);
+    printf("Connections: %llu\n", s.connections);
+    printf("Logins: %llu accepted, %llu rejected, %llu sessions expired\n", s.logins, s.login_failures, s.expired);
+    printf("Requests: %llu device lists, %llu health checks, %llu unauthorized, %llu invalid\n", s.device_lists, s.health, s.unauthorized, s.invalid);
+    printf("Images: %llu accepted (%llu bytes), %llu injected errors, %llu dropped, %llu recorded\n", s.images, s.image_bytes, s.injected_errors, s.dropped, s.recorded);
+    fflush(stdout);
+}
+
+/**
+ * @brief Print usage information.
+ * @details Lists all options with their defaults.
+ * @example
+ *     show_usage(argv[0]);
+ */
+static void show_usage(const char *program) {
+    printf("Usage: %s [options]\n\n", program);
+    printf("Local mock of the CoolerControl daemon API (127.0.0.1 only).\n\n");
+    printf("  -p PORT      Listen port (default %d)\n", MOCK_DEFAULT_PORT);
+    printf("  -u PATH      Listen on a Unix domain socket instead of TCP\n");
+    printf("  -w PASSWORD  CCAdmin password (default %s)\n", MOCK_DEFAULT_PASSWORD);
+    printf("  -n COUNT     LCD devices mock-lcd-1..COUNT, 1-%d (default 1)\n", MOCK_MAX_DEVICES);
+    printf("  -l MS        Latency added to every image upload (default 0)\n");
+    printf("  -j MS        Random jitter added to the latency (default 0)\n");
+    printf("  -e PERCENT   Image uploads answered with HTTP 500 (default 0)\n");
+    printf("  -d PERCENT   Image uploads dropped without response (default 0)\n");
+    printf("  -x COUNT     Expire the session after COUNT uploads (default 0 = never)\n");
+    printf("  -s BYTES     Maximum image size (default %ld)\n", MOCK_DEFAULT_MAX_IMAGE);
+    printf("  -r DIR       Record received PNGs to DIR\n");
+    printf("  -D FILE      Serve GET /devices from FILE (a recorded response)\n");
+    printf("  -S SEED      Random seed for injected faults (default: time)\n");
+    printf("  -h           Show this help\n");
+}
+
+/**
+ * @brief Read the recorded /devices response of -D into memory.
+ * @details Returns 1 on success, 0 on failure.
+ * @example
+ *     if (!load_devices_file(options.devices_file)) return 0;
+ */
+static int load_devices_file(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) size = ftell(fp);
+    if (size < 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return 0;
+    }
+    devices_body = malloc((size_t)size + 1);
+    devices_body_len = devices_body ? fread(devices_body, 1, (size_t)size, fp) : 0;
+    fclose(fp);
+    return devices_body && devices_body_len == (size_t)size;
+}
+
+/**
+ * @brief Parse and check the command line.
+ * @details Returns 1 on success, 0 on invalid options (usage is printed).
+ * @example
+ *     if (!parse_options(argc, argv)) return 2;
+ */
+static int parse_options(int argc, char **argv) {
+    int opt;
+    options.seed = (unsigned int)time(NULL);
+    while ((opt = getopt(argc, argv, "p:u:w:n:l:j:e:d:x:s:r:D:S:h")) != -1) {
+        switch (opt) {
+            case 'p': options.port = atoi(optarg); break;
+            case 'u': options.socket_path = optarg; break;
+            case 'w': options.password = optarg; break;
+            case 'n': options.device_count = atoi(optarg); break;
+            case 'l': options.latency_ms = atol(optarg); break;
+            case 'j': options.jitter_ms = atol(optarg); break;
+            case 'e': options.error_percent = atoi(optarg); break;
+            case 'd': options.drop_percent = atoi(optarg); break;
+            case 'x': options.expire_after = atol(optarg); break;
+            case 's': options.max_image_size = atol(optarg); break;
+            case 'r': options.record_dir = optarg; break;
+            case 'D': options.devices_file = optarg; break;
+            case 'S': options.seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+            case 'h': show_usage(argv[0]); exit(0);
+            default: show_usage(argv[0]); return 0;
+        }
+    }
+    if (options.port <= 0 || options.port > 65535 ||
+        options.device_count < 1 || options.device_count > MOCK_MAX_DEVICES ||
+        options.latency_ms < 0 || options.jitter_ms < 0 ||
+        options.error_percent < 0 || options.error_percent > 100 ||
+        options.drop_percent < 0 || options.drop_percent > 100 ||
+        options.expire_after < 0 || options.max_image_size <= 0 ||
+        (options.socket_path && strlen(options.socket_path) >= sizeof(((struct sockaddr_un *)0)->sun_path))) {
+        fprintf(stderr, "coolercontrol-mock: invalid option value\n");
+        return 0;
+    }
+    if (options.devices_file && !load_devices_file(options.devices_file)) {
+        fprintf(stderr, "coolercontrol-mock: cannot read %s\n", options.devices_file);
+        return 0;
+    }
+    if (options.record_dir) {
+        struct stat st;
+        if (stat(options.record_dir, &st) != 0 && mkdir(options.record_dir, 0755) != 0) {
+            fprintf(stderr, "coolercontrol-mock: cannot create %s\n", options.record_dir);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Create the listening Unix domain socket.
+ * @details A stale socket file at path is replaced. Returns the socket, or -1 on failure.
+ * @example
+ *     int listen_fd = open_unix_listener(options.socket_path);
+ */
+static int open_unix_listener(const char *path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Create the listening socket on 127.0.0.1.
+ * @details Returns the socket, or -1 on failure.
+ * @example
+ *     int listen_fd = open_listener(options.port);
+ */
+static int open_listener(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Entry point of the mock server.
+ * @details Accepts connections until SIGINT/SIGTERM, then prints statistics. Connections still open at that point are abandoned with the process.
+ * @example
+ *     coolercontrol-mock -n 2 -l 30
+ */
+int main(int argc, char **argv) {
+    if (!parse_options(argc, argv)) return 2;
+    token_rng = options.seed ^ 0x5bd1e995u;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0; // No SA_RESTART: accept() returns EINTR
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    char endpoint[128];
+    if (options.socket_path) snprintf(endpoint, sizeof(endpoint), "unix:%s", options.socket_path);
+    else snprintf(endpoint, sizeof(endpoint), "http://127.0.0.1:%d", options.port);
+    int listen_fd = options.socket_path ? open_unix_listener(options.socket_path) : open_listener(options.port);
+    if (listen_fd < 0) {
+        fprintf(stderr, "coolercontrol-mock: cannot listen on %s: %s\n", endpoint, strerror(errno));
+        return 1;
+    }
+    printf("coolercontrol-mock listening on %s (%d LCD device%s, latency %ld+%ld ms, %d%% errors, %d%% drops)\n",
+           endpoint, options.device_count, options.device_count == 1 ? "" : "s",
+           options.latency_ms, options.jitter_ms, options.error_percent, options.drop_percent);
+    fflush(stdout);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    unsigned int connection_seq = 0;
+    while (running) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            perror("coolercontrol-mock: accept");
+            break;
+        }
+        int one = 1;
+        if (!options.socket_path) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        struct timeval idle = { .tv_sec = MOCK_IDLE_TIMEOUT_SEC, .tv_usec = 0 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+        mock_conn_t *conn = calloc(1, sizeof(*conn));
+        pthread_t thread;
+        if (!conn) {
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->rng = options.seed + 7919u * ++connection_seq;
+        if (pthread_create(&thread, &attr, serve_connection, conn) != 0) {
+            close(fd);
+            free(conn);
+            continue;
+        }
+        pthread_mutex_lock(&state_lock);
+        stats.connections++;
+        pthread_mutex_unlock(&state_lock);
+    }
+    pthread_attr_destroy(&attr);
+    close(listen_fd);
+    if (options.socket_path) unlink(options.socket_path);
+    print_stats();
+    return 0;
+}